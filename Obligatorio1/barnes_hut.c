@@ -0,0 +1,407 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "barnes_hut.h"
+
+#define UMBRAL_TAREA 2048 // Subárboles con más cuerpos se construyen en una tarea de OpenMP aparte
+
+// Vectores de coordenadas de los cuerpos, uno por dimensión del árbol
+static void coordenadasCuerpos(const Cuerpos *c, const double *coordenada[DIMENSIONES_ARBOL]) {
+    coordenada[0] = c->x;
+    coordenada[1] = c->y;
+}
+
+int crearArbolBarnesHut(ArbolBarnesHut *a, const Cuerpos *c, double theta) {
+    int k, error;
+
+    memset(a, 0, sizeof(*a));
+    a->theta = theta;
+    a->num_cuerpos = c->num;
+    a->claves = malloc(c->num * sizeof(ClaveCuerpo));
+    a->masa = malloc(c->num * sizeof(double));
+    error = !(theta >= 0 && theta <= THETA_MAXIMO) || a->claves == NULL || a->masa == NULL;
+    for (k = 0; k < DIMENSIONES_ARBOL; k++) {
+        a->posicion[k] = malloc(c->num * sizeof(double));
+        error |= a->posicion[k] == NULL;
+    }
+    if (error) {
+        liberarArbolBarnesHut(a);
+        return 1;
+    }
+    for (k = 0; k < c->num; k++) {
+        a->claves[k].cuerpo = k;
+    }
+    return 0;
+}
+
+void liberarArbolBarnesHut(ArbolBarnesHut *a) {
+    int k;
+    free(a->claves);
+    free(a->masa);
+    for (k = 0; k < DIMENSIONES_ARBOL; k++) {
+        free(a->posicion[k]);
+        a->posicion[k] = NULL;
+    }
+    free(a->nodos);
+    a->claves = NULL;
+    a->masa = NULL;
+    a->nodos = NULL;
+    a->capacidad_nodos = 0;
+}
+
+// Clave de Morton: el bit b de la coordenada k va al bit b * DIMENSIONES_ARBOL + k
+static uint64_t claveMorton(const uint32_t celda[DIMENSIONES_ARBOL]) {
+    uint64_t clave = 0;
+    int b, k;
+    for (b = 0; b < BITS_POR_EJE; b++) {
+        for (k = 0; k < DIMENSIONES_ARBOL; k++) {
+            clave |= (uint64_t)((celda[k] >> b) & 1) << (b * DIMENSIONES_ARBOL + k);
+        }
+    }
+    return clave;
+}
+
+// Orden total (a igual clave, por número de cuerpo): el orden no depende de
+// cómo se haya llegado a él y un punto de control continúa igual
+static inline int vaDespues(const ClaveCuerpo *a, const ClaveCuerpo *b) {
+    return a->clave > b->clave || (a->clave == b->clave && a->cuerpo > b->cuerpo);
+}
+
+static int compararClaves(const void *x, const void *y) {
+    return vaDespues(x, y) - vaDespues(y, x);
+}
+
+// Caja de la raíz, claves de Morton y orden. Entre pasos los cuerpos apenas se
+// mueven, así que el orden anterior está casi ordenado y la ordenación por
+// inserción es prácticamente lineal; la primera vez se usa qsort.
+static void ordenarCuerpos(const Cuerpos *c, ArbolBarnesHut *a) {
+    const double *coordenada[DIMENSIONES_ARBOL];
+    double extension = 0.0;
+    int k, s, n = c->num;
+
+    coordenadasCuerpos(c, coordenada);
+    for (k = 0; k < DIMENSIONES_ARBOL; k++) {
+        double minimo = INFINITY, maximo = -INFINITY;
+        const double *v = coordenada[k];
+        #pragma omp parallel for reduction(min:minimo) reduction(max:maximo)
+        for (s = 0; s < n; s++) {
+            minimo = fmin(minimo, v[s]);
+            maximo = fmax(maximo, v[s]);
+        }
+        a->minimo[k] = minimo;
+        extension = fmax(extension, maximo - minimo);
+    }
+    // Un poco más grande, para que el cuerpo más alejado no caiga justo en el borde
+    a->lado = (extension > 0) ? extension * (1.0 + 1e-9) : 1.0;
+
+    double escala = ldexp(1.0, BITS_POR_EJE) / a->lado;
+    uint32_t celda_maxima = (1u << BITS_POR_EJE) - 1;
+    #pragma omp parallel for schedule(static)
+    for (s = 0; s < n; s++) {
+        uint32_t celda[DIMENSIONES_ARBOL];
+        int i = a->claves[s].cuerpo, d;
+        for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+            double q = (coordenada[d][i] - a->minimo[d]) * escala;
+            celda[d] = (q <= 0) ? 0 : (q >= celda_maxima) ? celda_maxima : (uint32_t)q;
+        }
+        a->claves[s].clave = claveMorton(celda);
+    }
+
+    if (!a->ordenado) {
+        qsort(a->claves, n, sizeof(ClaveCuerpo), compararClaves);
+        a->ordenado = 1;
+    } else {
+        for (s = 1; s < n; s++) {
+            ClaveCuerpo actual = a->claves[s];
+            int t = s - 1;
+            while (t >= 0 && vaDespues(&a->claves[t], &actual)) {
+                a->claves[t + 1] = a->claves[t];
+                t--;
+            }
+            a->claves[t + 1] = actual;
+        }
+    }
+
+    // Copias contiguas en el orden de Morton para las hojas
+    #pragma omp parallel for schedule(static)
+    for (s = 0; s < n; s++) {
+        int i = a->claves[s].cuerpo, d;
+        for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+            a->posicion[d][s] = coordenada[d][i];
+        }
+        a->masa[s] = c->m[i];
+    }
+}
+
+static inline int esHoja(int num, int nivel) {
+    return num <= MAXIMO_HOJA || nivel == BITS_POR_EJE;
+}
+
+// Cifra de la clave que elige el hijo en el nivel 'nivel' (la raíz es el nivel 0)
+static inline int cifraHijo(uint64_t clave, int nivel) {
+    return (int)(clave >> ((BITS_POR_EJE - 1 - nivel) * DIMENSIONES_ARBOL)) & (HIJOS_NODO - 1);
+}
+
+// inicio[h]: primer cuerpo del hijo h (los cuerpos del hijo h van de inicio[h]
+// a inicio[h + 1]). Dentro de un nodo la cifra crece con la clave, así que
+// cada frontera se encuentra por bisección.
+static void rangosHijos(const ArbolBarnesHut *a, int primero, int num, int nivel, int inicio[HIJOS_NODO + 1]) {
+    int h;
+    inicio[0] = primero;
+    inicio[HIJOS_NODO] = primero + num;
+    for (h = 1; h < HIJOS_NODO; h++) {
+        int izquierda = inicio[h - 1], derecha = primero + num;
+        while (izquierda < derecha) {
+            int medio = (izquierda + derecha) / 2;
+            if (cifraHijo(a->claves[medio].clave, nivel) < h) {
+                izquierda = medio + 1;
+            } else {
+                derecha = medio;
+            }
+        }
+        inicio[h] = izquierda;
+    }
+}
+
+static int contarNodos(const ArbolBarnesHut *a, int primero, int num, int nivel) {
+    int inicio[HIJOS_NODO + 1], h, total = 1;
+    if (esHoja(num, nivel)) {
+        return 1;
+    }
+    rangosHijos(a, primero, num, nivel, inicio);
+    for (h = 0; h < HIJOS_NODO; h++) {
+        if (inicio[h + 1] > inicio[h]) {
+            total += contarNodos(a, inicio[h], inicio[h + 1] - inicio[h], nivel + 1);
+        }
+    }
+    return total;
+}
+
+// Masa, centro de masas y radio de apertura del nodo (todo salvo siguiente)
+static void llenarNodo(ArbolBarnesHut *a, int indice, int primero, int num, int nivel,
+                       const double minimo[DIMENSIONES_ARBOL]) {
+    NodoBarnesHut *nodo = &a->nodos[indice];
+    double lado = ldexp(a->lado, -nivel), suma[DIMENSIONES_ARBOL] = {0}, masa = 0.0, delta2 = 0.0;
+    int s, d;
+
+    for (s = primero; s < primero + num; s++) {
+        masa += a->masa[s];
+        for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+            suma[d] += a->masa[s] * a->posicion[d][s];
+        }
+    }
+    for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+        double centro_caja = minimo[d] + 0.5 * lado;
+        // Sin masa (partículas de prueba) el nodo no atrae: el centro de la caja sirve
+        nodo->centro_masa[d] = (masa > 0) ? suma[d] / masa : centro_caja;
+        delta2 += (nodo->centro_masa[d] - centro_caja) * (nodo->centro_masa[d] - centro_caja);
+    }
+    nodo->masa = masa;
+    nodo->primero = primero;
+    nodo->num = num;
+    nodo->hoja = esHoja(num, nivel);
+    if (a->theta > 0) {
+        double radio = lado / a->theta + sqrt(delta2);
+        nodo->radio_apertura2 = radio * radio;
+    } else {
+        nodo->radio_apertura2 = INFINITY;
+    }
+}
+
+static void cajaHijo(const double minimo[DIMENSIONES_ARBOL], int nivel, double lado_raiz, int h,
+                     double minimo_hijo[DIMENSIONES_ARBOL]) {
+    double mitad = ldexp(lado_raiz, -nivel - 1);
+    int d;
+    for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+        minimo_hijo[d] = minimo[d] + ((h >> d) & 1) * mitad;
+    }
+}
+
+// Subárbol en preorden a partir de 'indice'. Devuelve los nodos que ocupa.
+static int construirSerie(ArbolBarnesHut *a, int indice, int primero, int num, int nivel,
+                          const double minimo[DIMENSIONES_ARBOL]) {
+    int inicio[HIJOS_NODO + 1], h, k = indice + 1;
+
+    llenarNodo(a, indice, primero, num, nivel, minimo);
+    if (!a->nodos[indice].hoja) {
+        rangosHijos(a, primero, num, nivel, inicio);
+        for (h = 0; h < HIJOS_NODO; h++) {
+            if (inicio[h + 1] > inicio[h]) {
+                double minimo_hijo[DIMENSIONES_ARBOL];
+                cajaHijo(minimo, nivel, a->lado, h, minimo_hijo);
+                k += construirSerie(a, k, inicio[h], inicio[h + 1] - inicio[h], nivel + 1, minimo_hijo);
+            }
+        }
+    }
+    a->nodos[indice].siguiente = k;
+    return k - indice;
+}
+
+// Como construirSerie, pero los hijos grandes se construyen en tareas: antes
+// se cuentan sus nodos para saber dónde empieza cada uno
+static void construirParalelo(ArbolBarnesHut *a, int indice, int primero, int num, int nivel,
+                              const double minimo[DIMENSIONES_ARBOL]) {
+    int inicio[HIJOS_NODO + 1], h, k = indice + 1;
+
+    if (num <= UMBRAL_TAREA || esHoja(num, nivel)) {
+        construirSerie(a, indice, primero, num, nivel, minimo);
+        return;
+    }
+    llenarNodo(a, indice, primero, num, nivel, minimo);
+    rangosHijos(a, primero, num, nivel, inicio);
+    for (h = 0; h < HIJOS_NODO; h++) {
+        int primero_hijo = inicio[h], num_hijo = inicio[h + 1] - inicio[h], indice_hijo = k;
+        double minimo_hijo[DIMENSIONES_ARBOL];
+        if (num_hijo == 0) {
+            continue;
+        }
+        cajaHijo(minimo, nivel, a->lado, h, minimo_hijo);
+        k += contarNodos(a, primero_hijo, num_hijo, nivel + 1);
+        #pragma omp task firstprivate(indice_hijo, primero_hijo, num_hijo, minimo_hijo)
+        construirParalelo(a, indice_hijo, primero_hijo, num_hijo, nivel + 1, minimo_hijo);
+    }
+    a->nodos[indice].siguiente = k;
+}
+
+static int construirArbol(const Cuerpos *c, ArbolBarnesHut *a) {
+    ordenarCuerpos(c, a);
+
+    int total = contarNodos(a, 0, c->num, 0);
+    if (total > a->capacidad_nodos) {
+        int capacidad = total + total / 4;
+        NodoBarnesHut *nodos = realloc(a->nodos, capacidad * sizeof(NodoBarnesHut));
+        if (nodos == NULL) {
+            return 1;
+        }
+        a->nodos = nodos;
+        a->capacidad_nodos = capacidad;
+    }
+    a->num_nodos = total;
+
+    #pragma omp parallel
+    #pragma omp single
+    construirParalelo(a, 0, 0, c->num, 0, a->minimo);
+    return 0;
+}
+
+// Recorrido del árbol para un punto: los nodos lejanos suman como una masa,
+// las hojas cercanas cuerpo a cuerpo (sin el propio, que está a distancia 0)
+static long aceleracionPunto(const ArbolBarnesHut *a, const double p[DIMENSIONES_ARBOL],
+                             double aceleracion[DIMENSIONES_ARBOL]) {
+    long interacciones = 0;
+    int k = 0, d, s;
+
+    for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+        aceleracion[d] = 0.0;
+    }
+    while (k < a->num_nodos) {
+        const NodoBarnesHut *nodo = &a->nodos[k];
+        double diferencia[DIMENSIONES_ARBOL], r2 = 0.0;
+        for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+            diferencia[d] = nodo->centro_masa[d] - p[d];
+            r2 += diferencia[d] * diferencia[d];
+        }
+
+        if (r2 >= nodo->radio_apertura2) {
+            double inversa = 1.0 / sqrt(r2);
+            double f = nodo->masa * inversa * inversa * inversa;
+            for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+                aceleracion[d] += f * diferencia[d];
+            }
+            interacciones++;
+            k = nodo->siguiente;
+        } else if (nodo->hoja) {
+            for (s = nodo->primero; s < nodo->primero + nodo->num; s++) {
+                double dj[DIMENSIONES_ARBOL], rj2 = 0.0;
+                for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+                    dj[d] = a->posicion[d][s] - p[d];
+                    rj2 += dj[d] * dj[d];
+                }
+                if (rj2 > 0) {
+                    double inversa = 1.0 / sqrt(rj2);
+                    double f = a->masa[s] * inversa * inversa * inversa;
+                    for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+                        aceleracion[d] += f * dj[d];
+                    }
+                }
+            }
+            interacciones += nodo->num;
+            k = nodo->siguiente;
+        } else {
+            k++; // Primer hijo
+        }
+    }
+    return interacciones;
+}
+
+int calcularAceleracionesBarnesHut(Cuerpos *c, ArbolBarnesHut *a) {
+    long interacciones = 0;
+    int s;
+
+    if (c->num != a->num_cuerpos || construirArbol(c, a) != 0) {
+        return 1;
+    }
+
+    // En el orden de Morton: cuerpos vecinos recorren casi los mismos nodos
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:interacciones)
+    for (s = 0; s < c->num; s++) {
+        double p[DIMENSIONES_ARBOL], aceleracion[DIMENSIONES_ARBOL];
+        int i = a->claves[s].cuerpo, d;
+        for (d = 0; d < DIMENSIONES_ARBOL; d++) {
+            p[d] = a->posicion[d][s];
+        }
+        interacciones += aceleracionPunto(a, p, aceleracion);
+        c->ax[i] = aceleracion[0];
+        c->ay[i] = aceleracion[1];
+    }
+    a->interacciones = interacciones;
+    return 0;
+}
+
+void calcularAceleracionesParticulasBarnesHut(const ArbolBarnesHut *a, Particulas *p) {
+    int i;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (i = 0; i < p->num; i++) {
+        double punto[DIMENSIONES_ARBOL] = {p->x[i], p->y[i]}, aceleracion[DIMENSIONES_ARBOL];
+        aceleracionPunto(a, punto, aceleracion);
+        p->ax[i] = aceleracion[0];
+        p->ay[i] = aceleracion[1];
+    }
+}
+
+int compararConSumaDirecta(Cuerpos *c, ArbolBarnesHut *a, double *error_medio, double *error_maximo) {
+    double *ax = malloc(c->num * sizeof(double)), *ay = malloc(c->num * sizeof(double));
+    double suma = 0.0, maximo = 0.0;
+    int i, contados = 0;
+
+    if (ax == NULL || ay == NULL) {
+        free(ax);
+        free(ay);
+        return 1;
+    }
+    calcularAceleraciones(c);
+    memcpy(ax, c->ax, c->num * sizeof(double));
+    memcpy(ay, c->ay, c->num * sizeof(double));
+    if (calcularAceleracionesBarnesHut(c, a) != 0) {
+        free(ax);
+        free(ay);
+        return 1;
+    }
+
+    for (i = 0; i < c->num; i++) {
+        double modulo = hypot(ax[i], ay[i]);
+        if (modulo > 0) {
+            double error = hypot(c->ax[i] - ax[i], c->ay[i] - ay[i]) / modulo;
+            suma += error;
+            maximo = fmax(maximo, error);
+            contados++;
+        }
+    }
+    *error_medio = (contados > 0) ? suma / contados : 0.0;
+    *error_maximo = maximo;
+    free(ax);
+    free(ay);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#ifndef BARNES_HUT_H
+#define BARNES_HUT_H
+
+#include <stdint.h>
+#include "cuerpos.h"
+
+// Gravedad de Barnes y Hut: los cuerpos se agrupan en un árbol de cajas
+// (quadtree en 2D) y un grupo lejano atrae como una sola masa en su centro de
+// masas. Cuesta O(N log N) en lugar de O(N^2). Un nodo se abre (se miran sus
+// hijos) si el cuerpo está a menos de lado / theta + delta de su centro de
+// masas, con delta la distancia entre el centro de masas y el centro de la
+// caja (criterio de Barnes de 1994, que evita los errores grandes cuando el
+// centro de masas está en una esquina). theta = 0 abre todos los nodos: es la
+// suma directa.
+//
+// El árbol se guarda en un vector plano en preorden, que con los cuerpos
+// ordenados por su clave de Morton es el orden de Morton de las cajas. Cada
+// nodo sabe dónde termina su subárbol (siguiente), así que se recorre sin
+// pila: al aceptar un nodo se salta a siguiente y al abrirlo se pasa al
+// primer hijo, que es el nodo contiguo.
+//
+// Las claves intercalan los bits de las DIMENSIONES_ARBOL coordenadas; el
+// código solo depende de DIMENSIONES_ARBOL y de coordenadasCuerpos(), así que
+// el octree es cambiar a 3 cuando los cuerpos tengan z.
+
+#define DIMENSIONES_ARBOL 2
+#define HIJOS_NODO (1 << DIMENSIONES_ARBOL)
+#define BITS_POR_EJE 21      // Niveles del árbol como máximo (3 * 21 bits caben en la clave también en 3D)
+#define MAXIMO_HOJA 8        // Cuerpos por hoja: por debajo se suman directamente
+
+// Un punto dentro de una caja está a menos de lado * sqrt(DIMENSIONES_ARBOL) / 2
+// + delta del centro de masas, así que con theta <= 1 el nodo que contiene al
+// cuerpo siempre se abre y el cuerpo nunca se atrae a sí mismo
+#define THETA_MAXIMO 1.0
+
+typedef struct {
+    double centro_masa[DIMENSIONES_ARBOL];
+    double masa;
+    double radio_apertura2;  // (lado / theta + delta)^2: más cerca que esto, se abre
+    int primero, num;        // Cuerpos del nodo (en el orden de Morton)
+    int siguiente;           // Primer nodo después del subárbol
+    int hoja;
+} NodoBarnesHut;
+
+typedef struct {
+    uint64_t clave;          // Clave de Morton de la posición
+    int cuerpo;
+} ClaveCuerpo;
+
+typedef struct {
+    double theta;
+    int num_cuerpos;
+    ClaveCuerpo *claves;     // claves[s].cuerpo: cuerpo en la posición s del orden de Morton (se conserva entre pasos)
+    double *posicion[DIMENSIONES_ARBOL], *masa; // Copias de los cuerpos en el orden de Morton
+    NodoBarnesHut *nodos;
+    int num_nodos, capacidad_nodos;
+    double minimo[DIMENSIONES_ARBOL], lado; // Caja de la raíz
+    int ordenado;            // 1 si claves viene del paso anterior (casi ordenado)
+    long interacciones;      // Nodos y cuerpos sumados en el último cálculo
+} ArbolBarnesHut;
+
+// Reserva el árbol para los c->num cuerpos. Devuelve 0 si todo va bien
+// (theta tiene que estar entre 0 y THETA_MAXIMO).
+int crearArbolBarnesHut(ArbolBarnesHut *a, const Cuerpos *c, double theta);
+void liberarArbolBarnesHut(ArbolBarnesHut *a);
+
+// Reconstruye el árbol con las posiciones actuales y deja las aceleraciones
+// en c->ax, c->ay (como calcularAceleraciones). Devuelve 0 si todo va bien.
+int calcularAceleracionesBarnesHut(Cuerpos *c, ArbolBarnesHut *a);
+
+// Aceleraciones de las partículas de prueba con el árbol que dejó el último
+// calcularAceleracionesBarnesHut (el de los cuerpos masivos en sus posiciones actuales)
+void calcularAceleracionesParticulasBarnesHut(const ArbolBarnesHut *a, Particulas *p);
+
+// Error relativo de la aceleración de Barnes-Hut frente a la suma directa,
+// |a_bh - a| / |a|, medio y máximo sobre todos los cuerpos. Deja en c->ax,
+// c->ay las aceleraciones de Barnes-Hut. Devuelve 0 si todo va bien.
+int compararConSumaDirecta(Cuerpos *c, ArbolBarnesHut *a, double *error_medio, double *error_maximo);
+
+#endif
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "catalogo.h"
+
+#define LONGITUD_LINEA 1024
+
+typedef struct {
+    const char *nombre;
+    double factor; // A kg, m o m/s
+} Unidad;
+
+static const Unidad unidades_masa[] = {{"kg", 1.0}, {"masa_solar", MASA_SOLAR}};
+static const Unidad unidades_distancia[] = {{"m", 1.0}, {"km", 1e3}, {"UA", AU}};
+static const Unidad unidades_velocidad[] = {{"m/s", 1.0}, {"km/s", 1e3}, {"UA/dia", AU / DAY}};
+
+#define NUM_UNIDADES(u) ((int)(sizeof(u) / sizeof(u[0])))
+
+// Factor de la unidad llamada nombre, o 0 si no está en la lista
+static double buscarUnidad(const Unidad *lista, int num, const char *nombre) {
+    int k;
+    for (k = 0; k < num; k++) {
+        if (strcmp(lista[k].nombre, nombre) == 0) {
+            return lista[k].factor;
+        }
+    }
+    return 0.0;
+}
+
+// Añade un cuerpo al final de *vector, que crece al doble cuando se llena
+static int anadirCuerpo(Planet **vector, int *num, int *capacidad, const Planet *cuerpo) {
+    if (*num == *capacidad) {
+        int nueva = (*capacidad > 0) ? 2 * *capacidad : 16;
+        Planet *ampliado = realloc(*vector, (size_t)nueva * sizeof(Planet));
+        if (ampliado == NULL) {
+            return 1;
+        }
+        *vector = ampliado;
+        *capacidad = nueva;
+    }
+    (*vector)[(*num)++] = *cuerpo;
+    return 0;
+}
+
+int leerCatalogo(const char *ruta, Catalogo *catalogo) {
+    FILE *archivo = fopen(ruta, "r");
+    char linea[LONGITUD_LINEA];
+    double factor_masa = 1.0, factor_distancia = 1.0, factor_velocidad = 1.0;
+    int capacidad_masivos = 0, capacidad_particulas = 0, numero_linea = 0, error = 0;
+
+    memset(catalogo, 0, sizeof(*catalogo));
+    if (archivo == NULL) {
+        fprintf(stderr, "No se puede abrir el catálogo %s\n", ruta);
+        return 1;
+    }
+
+    while (!error && fgets(linea, sizeof(linea), archivo) != NULL) {
+        char nombre[LONGITUD_LINEA], masa[LONGITUD_LINEA], distancia[LONGITUD_LINEA], velocidad[LONGITUD_LINEA];
+        char *comentario = strchr(linea, '#');
+        Planet cuerpo = {0};
+        double m, x, y, vx, vy;
+        int leidos, final = 0;
+
+        numero_linea++;
+        if (strchr(linea, '\n') == NULL && !feof(archivo)) {
+            fprintf(stderr, "%s:%d: línea demasiado larga\n", ruta, numero_linea);
+            error = 1;
+            break;
+        }
+        if (comentario != NULL) {
+            *comentario = '\0';
+        }
+        if (sscanf(linea, "%s", nombre) != 1) {
+            continue; // Línea en blanco o solo comentario
+        }
+
+        if (strcmp(nombre, "unidades") == 0) {
+            if (sscanf(linea, "%*s %s %s %s %n", masa, distancia, velocidad, &final) != 3 || linea[final] != '\0') {
+                fprintf(stderr, "%s:%d: se esperaba \"unidades <masa> <distancia> <velocidad>\"\n", ruta, numero_linea);
+                error = 1;
+                break;
+            }
+            factor_masa = buscarUnidad(unidades_masa, NUM_UNIDADES(unidades_masa), masa);
+            factor_distancia = buscarUnidad(unidades_distancia, NUM_UNIDADES(unidades_distancia), distancia);
+            factor_velocidad = buscarUnidad(unidades_velocidad, NUM_UNIDADES(unidades_velocidad), velocidad);
+            if (factor_masa == 0 || factor_distancia == 0 || factor_velocidad == 0) {
+                fprintf(stderr, "%s:%d: unidades desconocidas (masa: kg, masa_solar; distancia: m, km, UA; "
+                        "velocidad: m/s, km/s, UA/dia)\n", ruta, numero_linea);
+                error = 1;
+            }
+            continue;
+        }
+
+        leidos = sscanf(linea, "%*s %lf %lf %lf %lf %lf %n", &m, &x, &y, &vx, &vy, &final);
+        if (leidos != 5 || linea[final] != '\0') {
+            fprintf(stderr, "%s:%d: se esperaba \"nombre masa x y vx vy\"\n", ruta, numero_linea);
+            error = 1;
+            break;
+        }
+        if (strlen(nombre) >= sizeof(cuerpo.name)) {
+            fprintf(stderr, "%s:%d: el nombre %s tiene más de %d bytes\n", ruta, numero_linea, nombre,
+                    (int)sizeof(cuerpo.name) - 1);
+            error = 1;
+            break;
+        }
+        if (m < 0) {
+            fprintf(stderr, "%s:%d: masa negativa\n", ruta, numero_linea);
+            error = 1;
+            break;
+        }
+
+        // En kg, m y m/s: las mismas operaciones que hacía inicializarPlanetas
+        strcpy(cuerpo.name, nombre);
+        cuerpo.mass = m * factor_masa;
+        cuerpo.position[0] = x * factor_distancia;
+        cuerpo.position[1] = y * factor_distancia;
+        cuerpo.velocity[0] = vx * factor_velocidad;
+        cuerpo.velocity[1] = vy * factor_velocidad;
+        if (m > 0) {
+            error = anadirCuerpo(&catalogo->masivos, &catalogo->num_masivos, &capacidad_masivos, &cuerpo);
+        } else {
+            error = anadirCuerpo(&catalogo->particulas, &catalogo->num_particulas, &capacidad_particulas, &cuerpo);
+        }
+        if (error) {
+            fprintf(stderr, "Sin memoria para el catálogo\n");
+        }
+    }
+    fclose(archivo);
+
+    if (!error && catalogo->num_masivos == 0) {
+        fprintf(stderr, "%s: el catálogo no tiene ningún cuerpo con masa\n", ruta);
+        error = 1;
+    }
+    if (error) {
+        liberarCatalogo(catalogo);
+    }
+    return error;
+}
+
+void liberarCatalogo(Catalogo *catalogo) {
+    free(catalogo->masivos);
+    free(catalogo->particulas);
+    memset(catalogo, 0, sizeof(*catalogo));
+}
@@ -0,0 +1,32 @@
+#ifndef CATALOGO_H
+#define CATALOGO_H
+
+#include "cuerpos.h"
+
+// Catálogo de cuerpos en un fichero de texto, un cuerpo por línea:
+//
+//     nombre masa x y vx vy
+//
+// El nombre no lleva espacios y tiene como mucho 19 bytes. Las unidades se
+// cambian con una línea
+//
+//     unidades <masa> <distancia> <velocidad>
+//
+// que vale para los cuerpos que vienen detrás: masa en kg o masa_solar,
+// distancia en m, km o UA y velocidad en m/s, km/s o UA/dia. Hasta la primera
+// línea de unidades se usan kg, m y m/s. Lo que sigue a un # es un comentario.
+// Los cuerpos de masa 0 son partículas de prueba.
+
+typedef struct {
+    Planet *masivos;          // En kg, m y m/s, como los dejaba inicializarPlanetas
+    int num_masivos;
+    Planet *particulas;       // Masa 0; el nombre se guarda pero no se usa
+    int num_particulas;
+} Catalogo;
+
+// Lee el catálogo de ruta. Si hay un error (con la línea en que está) lo
+// escribe en stderr y devuelve 1; si todo va bien, 0.
+int leerCatalogo(const char *ruta, Catalogo *catalogo);
+void liberarCatalogo(Catalogo *catalogo);
+
+#endif
@@ -0,0 +1,260 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "cuerpos.h"
+
+// Como en ising_simd.c, las rutas vectoriales se compilan con atributos
+// target: el fichero no necesita -mavx2 ni -mavx512f y la CPU se comprueba al ejecutar
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CUERPOS_X86 1
+#include <immintrin.h>
+#else
+#define CUERPOS_X86 0
+#endif
+
+#define ALINEACION 64
+#define UMBRAL_PARALELO 256 // Con menos cuerpos no compensa repartir entre hilos
+
+int crearCuerpos(Cuerpos *c, int num) {
+    int capacidad = (num + ANCHO_CUERPOS - 1) / ANCHO_CUERPOS * ANCHO_CUERPOS;
+    size_t bytes = (size_t)capacidad * sizeof(double);
+    double **vectores[7] = {&c->x, &c->y, &c->vx, &c->vy, &c->m, &c->ax, &c->ay};
+    int k, error = num <= 0;
+
+    c->num = num;
+    c->capacidad = capacidad;
+    for (k = 0; k < 7; k++) {
+        *vectores[k] = error ? NULL : aligned_alloc(ALINEACION, bytes);
+        if (*vectores[k] == NULL) {
+            error = 1;
+        } else {
+            memset(*vectores[k], 0, bytes);
+        }
+    }
+    c->nombres = error ? NULL : calloc(num, sizeof(*c->nombres));
+    if (error || c->nombres == NULL) {
+        liberarCuerpos(c);
+        return 1;
+    }
+    return 0;
+}
+
+void liberarCuerpos(Cuerpos *c) {
+    free(c->x);
+    free(c->y);
+    free(c->vx);
+    free(c->vy);
+    free(c->m);
+    free(c->ax);
+    free(c->ay);
+    free(c->nombres);
+    c->x = c->y = c->vx = c->vy = c->m = c->ax = c->ay = NULL;
+    c->nombres = NULL;
+}
+
+void cargarCuerpos(Cuerpos *c, const Planet planets[]) {
+    int i;
+    for (i = 0; i < c->num; i++) {
+        memcpy(c->nombres[i], planets[i].name, sizeof(c->nombres[i]));
+        c->m[i] = planets[i].mass;
+        c->x[i] = planets[i].position[0];
+        c->y[i] = planets[i].position[1];
+        c->vx[i] = planets[i].velocity[0];
+        c->vy[i] = planets[i].velocity[1];
+    }
+}
+
+void extraerPlanetas(const Cuerpos *c, Planet planets[]) {
+    int i;
+    for (i = 0; i < c->num; i++) {
+        memcpy(planets[i].name, c->nombres[i], sizeof(planets[i].name));
+        planets[i].mass = c->m[i];
+        planets[i].position[0] = c->x[i];
+        planets[i].position[1] = c->y[i];
+        planets[i].velocity[0] = c->vx[i];
+        planets[i].velocity[1] = c->vy[i];
+    }
+}
+
+// Aceleración en el punto (xi, yi) debida a los cuerpos de c. Un cuerpo en
+// el mismo punto (el propio, si el punto es un cuerpo) tiene r^2 = 0 y no cuenta.
+static void aceleracionEscalar(const Cuerpos *c, double xi, double yi, double *ax, double *ay) {
+    double sx = 0.0, sy = 0.0;
+    int j;
+    for (j = 0; j < c->capacidad; j++) {
+        double dx = c->x[j] - xi, dy = c->y[j] - yi;
+        double r2 = dx * dx + dy * dy;
+        double inversa = (r2 > 0) ? 1.0 / sqrt(r2) : 0.0;
+        double f = c->m[j] * inversa * inversa * inversa;
+        sx += f * dx;
+        sy += f * dy;
+    }
+    *ax = sx;
+    *ay = sy;
+}
+
+#if CUERPOS_X86
+
+// 4 cuerpos j por iteración. La raíz inversa sale de rsqrtps (12 bits, en
+// float: vale para r^2 entre 1e-37 y 1e38) y tres pasos de Newton-Raphson,
+// y = y (3/2 - r^2 y^2 / 2), la llevan a la precisión del double
+__attribute__((target("avx2")))
+static void aceleracionAvx2(const Cuerpos *c, double px, double py, double *ax, double *ay) {
+    const __m256d xi = _mm256_set1_pd(px), yi = _mm256_set1_pd(py);
+    const __m256d tres_medios = _mm256_set1_pd(1.5), medio = _mm256_set1_pd(0.5), cero = _mm256_setzero_pd();
+    __m256d sx = cero, sy = cero;
+    int j, k;
+
+    for (j = 0; j < c->capacidad; j += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_load_pd(c->x + j), xi);
+        __m256d dy = _mm256_sub_pd(_mm256_load_pd(c->y + j), yi);
+        __m256d r2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        __m256d mitad_r2 = _mm256_mul_pd(medio, r2);
+        __m256d inversa = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(r2)));
+        for (k = 0; k < 3; k++) {
+            __m256d y2 = _mm256_mul_pd(inversa, inversa);
+            inversa = _mm256_mul_pd(inversa, _mm256_sub_pd(tres_medios, _mm256_mul_pd(mitad_r2, y2)));
+        }
+        // 1/r^3, a cero donde r^2 = 0 (rsqrt da infinito y Newton NaN)
+        __m256d inversa3 = _mm256_mul_pd(_mm256_mul_pd(inversa, inversa), inversa);
+        inversa3 = _mm256_and_pd(inversa3, _mm256_cmp_pd(r2, cero, _CMP_GT_OQ));
+        __m256d f = _mm256_mul_pd(_mm256_load_pd(c->m + j), inversa3);
+        sx = _mm256_add_pd(sx, _mm256_mul_pd(f, dx));
+        sy = _mm256_add_pd(sy, _mm256_mul_pd(f, dy));
+    }
+
+    __m128d hx = _mm_add_pd(_mm256_castpd256_pd128(sx), _mm256_extractf128_pd(sx, 1));
+    __m128d hy = _mm_add_pd(_mm256_castpd256_pd128(sy), _mm256_extractf128_pd(sy, 1));
+    *ax = _mm_cvtsd_f64(_mm_add_sd(hx, _mm_unpackhi_pd(hx, hx)));
+    *ay = _mm_cvtsd_f64(_mm_add_sd(hy, _mm_unpackhi_pd(hy, hy)));
+}
+
+// 8 cuerpos j por iteración; vrsqrt14pd da 14 bits en double y bastan dos pasos de Newton
+__attribute__((target("avx512f")))
+static void aceleracionAvx512(const Cuerpos *c, double px, double py, double *ax, double *ay) {
+    const __m512d xi = _mm512_set1_pd(px), yi = _mm512_set1_pd(py);
+    const __m512d tres_medios = _mm512_set1_pd(1.5), medio = _mm512_set1_pd(0.5), cero = _mm512_setzero_pd();
+    __m512d sx = cero, sy = cero;
+    int j;
+
+    for (j = 0; j < c->capacidad; j += 8) {
+        __m512d dx = _mm512_sub_pd(_mm512_load_pd(c->x + j), xi);
+        __m512d dy = _mm512_sub_pd(_mm512_load_pd(c->y + j), yi);
+        __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_mul_pd(dy, dy));
+        __m512d mitad_r2 = _mm512_mul_pd(medio, r2);
+        __m512d inversa = _mm512_rsqrt14_pd(r2);
+        inversa = _mm512_mul_pd(inversa, _mm512_fnmadd_pd(mitad_r2, _mm512_mul_pd(inversa, inversa), tres_medios));
+        inversa = _mm512_mul_pd(inversa, _mm512_fnmadd_pd(mitad_r2, _mm512_mul_pd(inversa, inversa), tres_medios));
+        __mmask8 lejos = _mm512_cmp_pd_mask(r2, cero, _CMP_GT_OQ);
+        __m512d inversa3 = _mm512_maskz_mov_pd(lejos, _mm512_mul_pd(_mm512_mul_pd(inversa, inversa), inversa));
+        __m512d f = _mm512_mul_pd(_mm512_load_pd(c->m + j), inversa3);
+        sx = _mm512_fmadd_pd(f, dx, sx);
+        sy = _mm512_fmadd_pd(f, dy, sy);
+    }
+    *ax = _mm512_reduce_add_pd(sx);
+    *ay = _mm512_reduce_add_pd(sy);
+}
+
+#endif
+
+// 0: escalar, 1: AVX2, 2: AVX-512 (se elige la primera vez según la CPU)
+static int ruta_fuerzas = -1;
+
+static int elegirRuta(void) {
+    if (ruta_fuerzas < 0) {
+        ruta_fuerzas = 0;
+#if CUERPOS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            ruta_fuerzas = 2;
+        } else if (__builtin_cpu_supports("avx2")) {
+            ruta_fuerzas = 1;
+        }
+#endif
+    }
+    return ruta_fuerzas;
+}
+
+const char *rutaFuerzas(void) {
+    static const char *const nombres[3] = {"escalar", "AVX2", "AVX-512"};
+    return nombres[elegirRuta()];
+}
+
+// Aceleración en (px, py) con la ruta elegida
+static void aceleracionPunto(const Cuerpos *c, int ruta, double px, double py, double *ax, double *ay) {
+#if CUERPOS_X86
+    if (ruta == 2) {
+        aceleracionAvx512(c, px, py, ax, ay);
+        return;
+    }
+    if (ruta == 1) {
+        aceleracionAvx2(c, px, py, ax, ay);
+        return;
+    }
+#endif
+    (void)ruta;
+    aceleracionEscalar(c, px, py, ax, ay);
+}
+
+// Cada cuerpo suma las atracciones de todos los demás (no se aprovecha la
+// tercera ley de Newton: así cada i escribe solo lo suyo y el bucle en j es
+// vectorial y sin dependencias entre hilos)
+void calcularAceleraciones(Cuerpos *c) {
+    int ruta = elegirRuta(), i;
+
+    #pragma omp parallel for schedule(static) if (c->num >= UMBRAL_PARALELO)
+    for (i = 0; i < c->num; i++) {
+        aceleracionPunto(c, ruta, c->x[i], c->y[i], &c->ax[i], &c->ay[i]);
+    }
+}
+
+int crearParticulas(Particulas *p, int num) {
+    double **vectores[6] = {&p->x, &p->y, &p->vx, &p->vy, &p->ax, &p->ay};
+    int k, error = num < 0;
+
+    // Sin partículas los vectores se quedan a NULL
+    p->num = num;
+    for (k = 0; k < 6; k++) {
+        *vectores[k] = (error || num == 0) ? NULL : calloc(num, sizeof(double));
+        if (num > 0 && *vectores[k] == NULL) {
+            error = 1;
+        }
+    }
+    if (error) {
+        liberarParticulas(p);
+        return 1;
+    }
+    return 0;
+}
+
+void liberarParticulas(Particulas *p) {
+    free(p->x);
+    free(p->y);
+    free(p->vx);
+    free(p->vy);
+    free(p->ax);
+    free(p->ay);
+    p->x = p->y = p->vx = p->vy = p->ax = p->ay = NULL;
+}
+
+void cargarParticulas(Particulas *p, const Planet particulas[]) {
+    int i;
+    for (i = 0; i < p->num; i++) {
+        p->x[i] = particulas[i].position[0];
+        p->y[i] = particulas[i].position[1];
+        p->vx[i] = particulas[i].velocity[0];
+        p->vy[i] = particulas[i].velocity[1];
+    }
+}
+
+// El mismo núcleo que para los cuerpos, con las partículas como puntos: el
+// bucle interno recorre solo los cuerpos masivos
+void calcularAceleracionesParticulas(const Cuerpos *masivos, Particulas *p) {
+    int ruta = elegirRuta(), i;
+
+    #pragma omp parallel for schedule(static) if (p->num >= UMBRAL_PARALELO)
+    for (i = 0; i < p->num; i++) {
+        aceleracionPunto(masivos, ruta, p->x[i], p->y[i], &p->ax[i], &p->ay[i]);
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef CUERPOS_H
+#define CUERPOS_H
+
+// Constantes físicas
+#define G 6.67430e-11 // Constante gravitacional (m^3 kg^-1 s^-2)
+#define AU 1.496e11   // Unidad astronómica (m)
+#define DAY 86400     // Un día en segundos
+#define YEAR 365.25   // Un año en días
+#define MASA_SOLAR 1.989e30 // Masa del Sol en kg
+
+// Datos de los planetas (masas en kg, distancias iniciales en m, velocidades iniciales en la dirección "y" en m/s)
+// typedef permite crear objetos de tipo struct sin tener que escribir la palabra struct cada vez
+typedef struct {
+    // Se define un tipo de dato llamado Planet que acceder a los atributos de cada planeta
+    char name[20]; // Nombre del planeta
+    double mass;       // Masa del planeta
+    double position[2]; // Posición (x, y) en m
+    double velocity[2]; // Velocidad (vx, vy) en m/s
+
+} Planet;
+
+// Cuerpos guardados como estructura de vectores: cada magnitud en su propio
+// vector alineado a 64 bytes, para que el cálculo de fuerzas recorra solo los
+// datos que usa (x, y, m) con cargas vectoriales. Los vectores se rellenan
+// hasta un múltiplo de ANCHO_CUERPOS con cuerpos de masa 0, que no atraen a
+// nadie, así que el núcleo no necesita tratar el final aparte.
+// Planet sigue siendo la vista de un cuerpo para la entrada y la salida.
+#define ANCHO_CUERPOS 8 // Doubles por registro AVX-512
+
+typedef struct {
+    int num;                   // Cuerpos reales
+    int capacidad;             // num redondeado a múltiplo de ANCHO_CUERPOS
+    double *x, *y, *vx, *vy, *m;
+    double *ax, *ay;           // Aceleraciones del último calcularAceleraciones
+    char (*nombres)[20];       // Fuera de los vectores que recorre el cálculo de fuerzas
+} Cuerpos;
+
+// Reserva num cuerpos (todos a 0). Devuelve 0 si todo va bien.
+int crearCuerpos(Cuerpos *c, int num);
+void liberarCuerpos(Cuerpos *c);
+
+// Conversión desde/hacia la vista Planet (c->num planetas)
+void cargarCuerpos(Cuerpos *c, const Planet planets[]);
+void extraerPlanetas(const Cuerpos *c, Planet planets[]);
+
+// Aceleración de cada cuerpo (G = 1, unidades reescaladas) en c->ax, c->ay:
+// a_i = sum_j m_j (r_j - r_i) / |r_j - r_i|^3, con 1/|r|^3 a partir de una
+// raíz inversa aproximada (rsqrt) refinada con Newton-Raphson
+void calcularAceleraciones(Cuerpos *c);
+
+// Partículas de prueba: no tienen masa, así que sienten la gravedad de los
+// cuerpos masivos pero no la producen ni se atraen entre ellas. Cuestan
+// O(N_masivos * N_particulas) en lugar de O(N^2): se pueden seguir 10^5-10^6
+// asteroides por lo que cuestan unos cientos de cuerpos masivos.
+typedef struct {
+    int num;
+    double *x, *y, *vx, *vy;
+    double *ax, *ay;           // Aceleraciones del último cálculo
+} Particulas;
+
+// Reserva num partículas (num puede ser 0). Devuelve 0 si todo va bien.
+int crearParticulas(Particulas *p, int num);
+void liberarParticulas(Particulas *p);
+
+// Posiciones y velocidades desde la vista Planet (p->num partículas; masa y nombre no se usan)
+void cargarParticulas(Particulas *p, const Planet particulas[]);
+
+// Aceleración de cada partícula debida a los cuerpos masivos, con el mismo
+// núcleo vectorial que calcularAceleraciones
+void calcularAceleracionesParticulas(const Cuerpos *masivos, Particulas *p);
+
+// Implementación elegida para el cálculo de fuerzas ("AVX-512", "AVX2" o "escalar")
+const char *rutaFuerzas(void);
+
+#endif
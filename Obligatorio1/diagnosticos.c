@@ -0,0 +1,43 @@
+#include <math.h>
+#include <omp.h>
+#include "diagnosticos.h"
+
+#define UMBRAL_PARALELO 256 // Como en cuerpos.c: con menos cuerpos no compensa repartir entre hilos
+
+void calcularDiagnosticos(const Cuerpos *c, Diagnosticos *d) {
+    double cinetica = 0.0, potencial = 0.0, momento = 0.0;
+    int i, j;
+
+    #pragma omp parallel for reduction(+:cinetica, momento) if (c->num >= UMBRAL_PARALELO)
+    for (i = 0; i < c->num; i++) {
+        double v2 = c->vx[i] * c->vx[i] + c->vy[i] * c->vy[i];
+        cinetica += 0.5 * c->m[i] * v2;
+        momento += c->m[i] * sqrt(c->x[i] * c->x[i] + c->y[i] * c->y[i]) * sqrt(v2);
+    }
+
+    // Cada pareja una vez; las filas son de distinta longitud, de ahí el reparto dinámico
+    #pragma omp parallel for private(j) reduction(+:potencial) schedule(dynamic, 16) if (c->num >= UMBRAL_PARALELO)
+    for (i = 0; i < c->num; i++) {
+        for (j = i + 1; j < c->num; j++) {
+            double dx = c->x[j] - c->x[i], dy = c->y[j] - c->y[i];
+            potencial -= c->m[i] * c->m[j] / sqrt(dx * dx + dy * dy);
+        }
+    }
+
+    d->cinetica = cinetica;
+    d->potencial = potencial;
+    d->momento_angular = momento;
+}
+
+void actualizarPeriodos(const Cuerpos *c, double t_anterior, double t, double y_anterior[],
+                        double periodos[], bool cruzo_eje[]) {
+    int i;
+    for (i = 0; i < c->num; i++) {
+        if (!cruzo_eje[i] && y_anterior[i] > 0 && c->y[i] <= 0) {
+            double cruce = t_anterior + (t - t_anterior) * y_anterior[i] / (y_anterior[i] - c->y[i]);
+            periodos[i] = 2 * cruce;
+            cruzo_eje[i] = true;
+        }
+        y_anterior[i] = c->y[i];
+    }
+}
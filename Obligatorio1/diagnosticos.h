@@ -0,0 +1,28 @@
+#ifndef DIAGNOSTICOS_H
+#define DIAGNOSTICOS_H
+
+#include <stdbool.h>
+#include "cuerpos.h"
+
+// Diagnósticos de los cuerpos con masa, calculados sin tocar su estado y en
+// unidades reescaladas (G = 1, masas solares, UA y tiempo reescalado). Se
+// pasan a kg, m y s solo al escribirlos. Las partículas de prueba no tienen
+// masa y no cuentan.
+typedef struct {
+    double cinetica;          // sum m v^2 / 2
+    double potencial;         // -sum_{i<j} m_i m_j / r_ij
+    double momento_angular;   // sum m r |v|, como se ha medido siempre
+} Diagnosticos;
+
+void calcularDiagnosticos(const Cuerpos *c, Diagnosticos *d);
+
+// Períodos: cada cuerpo empieza en el eje x moviéndose hacia y > 0 y su
+// período es el doble del tiempo en que pasa por primera vez de y > 0 a
+// y <= 0 (el y = 0 del principio no cuenta). Se mira en cada paso, de t_anterior
+// (con y_anterior) a t, y el cruce se interpola linealmente entre los dos; es
+// barato, así que no depende de la cadencia de los diagnósticos.
+// Actualiza y_anterior con las posiciones actuales.
+void actualizarPeriodos(const Cuerpos *c, double t_anterior, double t, double y_anterior[],
+                        double periodos[], bool cruzo_eje[]);
+
+#endif
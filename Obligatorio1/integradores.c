@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "integradores.h"
+
+#define UMBRAL_PARTICULAS 4096 // Partículas a partir de las que se reparten las patadas y derivas entre hilos
+
+static const char *const nombres_integradores[NUM_INTEGRADORES] = {
+    "verlet", "leapfrog", "yoshida4", "yoshida6", "wh"
+};
+
+// Pesos de las etapas de las composiciones de Yoshida (1990): cada etapa es
+// un leapfrog de w dt. Con 2^(1/3) el de 4º orden; los de 6º, solución A.
+#define CBRT2 1.25992104989487316477
+static const double pesos_yoshida4[3] = {
+    1.0 / (2.0 - CBRT2), -CBRT2 / (2.0 - CBRT2), 1.0 / (2.0 - CBRT2)
+};
+static const double pesos_yoshida6[7] = {
+    0.784513610477560, 0.235573213359357, -1.17767998417887,
+    1.0 - 2.0 * (0.784513610477560 + 0.235573213359357 - 1.17767998417887),
+    -1.17767998417887, 0.235573213359357, 0.784513610477560
+};
+
+int buscarIntegrador(const char *nombre) {
+    int tipo;
+    for (tipo = 0; tipo < NUM_INTEGRADORES; tipo++) {
+        if (strcmp(nombre, nombres_integradores[tipo]) == 0) {
+            return tipo;
+        }
+    }
+    return -1;
+}
+
+const char *nombreIntegrador(TipoIntegrador tipo) {
+    return nombres_integradores[tipo];
+}
+
+// Aceleraciones por suma directa o, si hay árbol, con Barnes-Hut. Las
+// partículas de prueba usan el mismo árbol, el de los cuerpos masivos. Con
+// Wisdom-Holman se quita la parte de Kepler y queda la de la interacción.
+static void calcularGravedad(Integrador *in, Cuerpos *c, Particulas *p) {
+    if (in->arbol == NULL) {
+        calcularAceleraciones(c);
+        calcularAceleracionesParticulas(c, p);
+    } else if (calcularAceleracionesBarnesHut(c, in->arbol) != 0) {
+        fprintf(stderr, "Sin memoria para el árbol de Barnes-Hut\n");
+        exit(1);
+    } else {
+        calcularAceleracionesParticulasBarnesHut(in->arbol, p);
+    }
+    if (in->tipo == INTEGRADOR_WISDOM_HOLMAN) {
+        restarKepler(&in->jerarquia, c, p);
+    }
+    in->evaluaciones++;
+}
+
+// v += a h
+static void patada(Cuerpos *c, Particulas *p, double h) {
+    int i;
+    for (i = 0; i < c->num; i++) {
+        c->vx[i] += c->ax[i] * h;
+        c->vy[i] += c->ay[i] * h;
+    }
+    #pragma omp parallel for if (p->num >= UMBRAL_PARTICULAS)
+    for (i = 0; i < p->num; i++) {
+        p->vx[i] += p->ax[i] * h;
+        p->vy[i] += p->ay[i] * h;
+    }
+}
+
+// x += v h
+static void deriva(Cuerpos *c, Particulas *p, double h) {
+    int i;
+    for (i = 0; i < c->num; i++) {
+        c->x[i] += c->vx[i] * h;
+        c->y[i] += c->vy[i] * h;
+    }
+    #pragma omp parallel for if (p->num >= UMBRAL_PARTICULAS)
+    for (i = 0; i < p->num; i++) {
+        p->x[i] += p->vx[i] * h;
+        p->y[i] += p->vy[i] * h;
+    }
+}
+
+// El Verlet que ha usado siempre el programa, con las mismas operaciones
+// para que dé exactamente lo mismo
+static void pasoVerlet(Integrador *in, Cuerpos *c, Particulas *p, double dt) {
+    int i;
+
+    //Almacena en w (vx, vy) las velocidades a mitad de paso y actualiza las posiciones al tiempo t+dt.
+    //El Sol (cuerpo 0) no arrastra su velocidad de un paso a otro: solo conserva el medio paso final.
+    for (i = 0; i < c->num; i++) {
+        c->x[i] += c->vx[i] * dt + 0.5 * c->ax[i] * dt * dt;
+        c->y[i] += c->vy[i] * dt + 0.5 * c->ay[i] * dt * dt;
+        c->vx[i] = (i == 0) ? 0.0 : c->vx[i] + 0.5 * dt * c->ax[i];
+        c->vy[i] = (i == 0) ? 0.0 : c->vy[i] + 0.5 * dt * c->ay[i];
+    }
+    // Las partículas, con el Verlet de siempre
+    #pragma omp parallel for if (p->num >= UMBRAL_PARTICULAS)
+    for (i = 0; i < p->num; i++) {
+        p->x[i] += p->vx[i] * dt + 0.5 * p->ax[i] * dt * dt;
+        p->y[i] += p->vy[i] * dt + 0.5 * p->ay[i] * dt * dt;
+        p->vx[i] += 0.5 * dt * p->ax[i];
+        p->vy[i] += 0.5 * dt * p->ay[i];
+    }
+
+    // Calcular la aceleración con las posiciones actualizadas
+    calcularGravedad(in, c, p);
+
+    //Calcular las nuevas velocidades al tiempo t+dt a partir de las aceleraciones en el tiempo t+dt
+    patada(c, p, 0.5 * dt);
+}
+
+// Leapfrog de h: patada de h/2 con las aceleraciones que hay, deriva de h,
+// fuerzas nuevas y otra patada de h/2
+static void pasoLeapfrog(Integrador *in, Cuerpos *c, Particulas *p, double h) {
+    patada(c, p, 0.5 * h);
+    deriva(c, p, h);
+    calcularGravedad(in, c, p);
+    patada(c, p, 0.5 * h);
+}
+
+// Wisdom-Holman: patada de la interacción, Kepler exacto y otra patada
+static void pasoWisdomHolman(Integrador *in, Cuerpos *c, Particulas *p, double dt) {
+    patada(c, p, 0.5 * dt);
+    derivaJacobi(&in->jerarquia, c, p, dt);
+    calcularGravedad(in, c, p);
+    patada(c, p, 0.5 * dt);
+}
+
+void pasoIntegrador(Integrador *in, Cuerpos *c, Particulas *p, double dt) {
+    int k;
+    switch (in->tipo) {
+    case INTEGRADOR_VERLET:
+        pasoVerlet(in, c, p, dt);
+        break;
+    case INTEGRADOR_LEAPFROG:
+        pasoLeapfrog(in, c, p, dt);
+        break;
+    case INTEGRADOR_YOSHIDA4:
+        for (k = 0; k < 3; k++) {
+            pasoLeapfrog(in, c, p, pesos_yoshida4[k] * dt);
+        }
+        break;
+    case INTEGRADOR_YOSHIDA6:
+        for (k = 0; k < 7; k++) {
+            pasoLeapfrog(in, c, p, pesos_yoshida6[k] * dt);
+        }
+        break;
+    case INTEGRADOR_WISDOM_HOLMAN:
+        pasoWisdomHolman(in, c, p, dt);
+        break;
+    default:
+        break;
+    }
+}
+
+int enterosEstadoIntegrador(TipoIntegrador tipo, int num_cuerpos, int num_particulas) {
+    if (tipo == INTEGRADOR_WISDOM_HOLMAN) {
+        return enterosJerarquiaJacobi(num_cuerpos, num_particulas);
+    }
+    return 0;
+}
+
+const int *estadoIntegrador(const Integrador *in) {
+    return (in->tipo == INTEGRADOR_WISDOM_HOLMAN) ? in->jerarquia.definicion : NULL;
+}
+
+int crearIntegrador(Integrador *in, TipoIntegrador tipo, Cuerpos *c, Particulas *p, ArbolBarnesHut *arbol,
+                    const int *estado_guardado) {
+    memset(in, 0, sizeof(*in));
+    in->tipo = tipo;
+    in->arbol = arbol;
+    if (tipo == INTEGRADOR_WISDOM_HOLMAN && crearJerarquiaJacobi(&in->jerarquia, c, p, estado_guardado) != 0) {
+        return 1;
+    }
+    calcularGravedad(in, c, p); // Aceleraciones en el tiempo t del primer paso
+    return 0;
+}
+
+void liberarIntegrador(Integrador *in) {
+    if (in->tipo == INTEGRADOR_WISDOM_HOLMAN) {
+        liberarJerarquiaJacobi(&in->jerarquia);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef INTEGRADORES_H
+#define INTEGRADORES_H
+
+#include "cuerpos.h"
+#include "barnes_hut.h"
+#include "wisdom_holman.h"
+
+// Integradores simplécticos de los cuerpos y las partículas de prueba, en
+// unidades reescaladas. Todos dejan al final de cada paso las aceleraciones
+// de las posiciones finales (en c->ax, c->ay y p->ax, p->ay) y empiezan el
+// siguiente con ellas: cada etapa cuesta un solo cálculo de fuerzas.
+typedef enum {
+    INTEGRADOR_VERLET,        // Verlet de velocidades como siempre: el Sol no arrastra su velocidad
+    INTEGRADOR_LEAPFROG,      // Verlet de velocidades (patada-deriva-patada), 2º orden
+    INTEGRADOR_YOSHIDA4,      // 3 leapfrogs con los pesos de Yoshida: 4º orden
+    INTEGRADOR_YOSHIDA6,      // 7 leapfrogs con los pesos de Yoshida (solución A): 6º orden
+    INTEGRADOR_WISDOM_HOLMAN, // Kepler exacto en coordenadas de Jacobi jerárquicas (wisdom_holman.h)
+    NUM_INTEGRADORES
+} TipoIntegrador;
+
+typedef struct {
+    TipoIntegrador tipo;
+    ArbolBarnesHut *arbol;       // NULL: suma directa
+    JerarquiaJacobi jerarquia;   // Solo con Wisdom-Holman
+    long evaluaciones;           // Cálculos de fuerzas hechos
+} Integrador;
+
+// Tipo del integrador llamado nombre ("verlet", "leapfrog", "yoshida4",
+// "yoshida6" o "wh"), o -1 si no hay ninguno con ese nombre
+int buscarIntegrador(const char *nombre);
+const char *nombreIntegrador(TipoIntegrador tipo);
+
+// Prepara el integrador y calcula las aceleraciones del primer paso. El
+// estado (la jerarquía de Wisdom-Holman) se guarda con el punto de control
+// para seguir igual: estado_guardado es el de un punto de control, o NULL al
+// empezar. Devuelve 0 si todo va bien.
+int crearIntegrador(Integrador *in, TipoIntegrador tipo, Cuerpos *c, Particulas *p, ArbolBarnesHut *arbol,
+                    const int *estado_guardado);
+void liberarIntegrador(Integrador *in);
+
+// Enteros del estado que hay que guardar para continuar (0 si no hay ninguno)
+int enterosEstadoIntegrador(TipoIntegrador tipo, int num_cuerpos, int num_particulas);
+const int *estadoIntegrador(const Integrador *in);
+
+// Avanza dt los cuerpos y las partículas
+void pasoIntegrador(Integrador *in, Cuerpos *c, Particulas *p, double dt);
+
+#endif
@@ -1,82 +1,48 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <time.h> 
 #include <stdbool.h>
+#include <errno.h>
+#include <unistd.h> // fsync() y truncate() para los puntos de control
 #include <omp.h> // OpenMP para paralelización
-
-// Constantes físicas
-#define G 6.67430e-11 // Constante gravitacional (m^3 kg^-1 s^-2)
-#define AU 1.496e11   // Unidad astronómica (m)
-#define DAY 86400     // Un día en segundos
-#define YEAR 365.25   // Un año en días
-#define NUM_PLANETS 15 // Número de planetas (incluyendo el Sol y lunas)
-#define MASA_SOLAR 1.989e30 // Masa del Sol en kg
-#define PI 3.14159265358979323846 // Definición de PI
-
-// Datos de los planetas (masas en kg, distancias iniciales en m, velocidades iniciales en la dirección "y" en m/s)
-// typedef permite crear objetos de tipo struct sin tener que escribir la palabra struct cada vez 
-typedef struct {
-    // Se define un tipo de dato llamado Planet que acceder a los atributos de cada planeta 
-    char name[20]; // Nombre del planeta
-    double mass;       // Masa del planeta
-    double position[2]; // Posición (x, y) en m
-    double velocity[2]; // Velocidad (vx, vy) en m/s
-
-} Planet;       
-
-// Inicializar datos reales de los planetas
-void inicializarPlanetas(Planet planets[]) { 
-    Planet temp[NUM_PLANETS] = {
-        {"Sol", MASA_SOLAR, {0, 0}, {0, 0}}, 
-        {"Mercurio", 3.3011e23, {0.39 * AU, 0}, {0, 47400}},
-        {"Venus", 4.8675e24, {0.72 * AU, 0}, {0, 35020}},
-        {"Tierra", 5.97237e24, {1.0 * AU, 0}, {0, 29780}},
-        {"Luna", 7.34767309e22, 
-            {1.0 * AU + 384400000}, 
-            {0, 29780 + 1022}}, // Luna de la Tierra
-        {"Marte", 6.4171e23, {1.52 * AU, 0}, {0, 24070}},
-        {"Júpiter", 1.8982e27, {5.2 * AU, 0}, {0, 13070}},
-        // Lunas de Júpiter
-        {"Ío", 8.9319e22, 
-            {5.2 * AU + 421700000 * cos(0), 421700000 * sin(0)}, 
-            { - sqrt(G * 1.8982e27 / 421700000) * sin(0), 
-             sqrt(G * 1.8982e27 / 421700000) * cos(0) + 13070 }}, // Luna Ío
-        {"Europa", 4.7998e22, 
-            {5.2 * AU + 671100000 * cos(PI/ 2), 671100000 * sin(PI / 2)}, 
-            { - sqrt(G * 1.8982e27 / 671100000) * sin(PI/ 2), 
-             sqrt(G * 1.8982e27 / 671100000) * cos(PI / 2) + 13070}}, // Luna Europa
-        {"Ganímedes", 1.4819e23, 
-            {5.2 * AU + 1070400000 * cos(PI), 1070400000 * sin(PI)}, 
-            {- sqrt(G * 1.8982e27 / 1070400000) * sin(PI), 
-             sqrt(G * 1.8982e27 / 1070400000) * cos(PI)+ 13070}}, // Luna Ganímedes
-        {"Calisto", 1.0759e23, 
-            {5.2 * AU + 1882700000 * cos(3 * PI / 2), 1882700000 * sin(3 * PI / 2)}, 
-            { - sqrt(G * 1.8982e27 / 1882700000) * sin(3 * PI/ 2), 
-             sqrt(G * 1.8982e27 / 1882700000) * cos(3 * PI/ 2) + 13070}}, // Luna Calisto
-        {"Saturno", 5.6834e26, {9.58 * AU, 0}, {0, 9680}},
-        {"Urano", 8.6810e25, {19.22 * AU, 0}, {0, 6800}},
-        {"Neptuno", 1.02413e26, {30.05 * AU, 0}, {0, 5430}},
-        {"Plutón", 1.30900e22, {39.48 * AU, 0}, {0, 4748}}
-    };
-
-    int i;
-    for (i = 0; i < NUM_PLANETS; i++) {
-        planets[i] = temp[i];
-    }
-}
+#include "cuerpos.h"
+#include "barnes_hut.h"
+#include "catalogo.h"
+#include "diagnosticos.h"
+#include "integradores.h"
+
+// Compilación: gcc -O3 -fopenmp planetasIAversion1.c cuerpos.c barnes_hut.c catalogo.c diagnosticos.c integradores.c wisdom_holman.c -o planetas -lm
+// Uso: ./planetas                         (simulación nueva de sistema_solar.txt, gravedad por suma directa)
+//      ./planetas --catalogo cuerpos.txt  (simulación nueva de otro catálogo; ver catalogo.h)
+//      ./planetas --theta 0.5             (gravedad con el árbol de Barnes-Hut y ángulo de apertura 0.5)
+//      ./planetas --integrador wh --dt 1  (Wisdom-Holman con pasos de un día; también verlet, el de
+//                                          siempre y por defecto, leapfrog, yoshida4 y yoshida6)
+//      ./planetas --anos 500              (años de simulación; por defecto 50)
+//      ./planetas --cada 10               (diagnósticos y posiciones cada 10 pasos; por defecto, en todos)
+//      ./planetas --cada-segundos 5       (diagnósticos y posiciones cada 5 segundos de reloj)
+//      ./planetas --continuar             (sigue desde el último punto de control, con la misma gravedad, integrador,
+//                                          paso y cadencia; con --anos se alarga la simulación)
+
+#define INTERVALO_PUNTO_CONTROL YEAR // Días simulados entre puntos de control
+#define INTERVALO_PARTICULAS YEAR // Días simulados entre posiciones guardadas de las partículas de prueba
+#define RUTA_PUNTO_CONTROL "punto_control_planetas.bin"
+#define RUTA_CATALOGO "sistema_solar.txt" // Catálogo por defecto (el sistema solar con lunas)
+#define INTERVALO_IMPRESION 30 // Muestras de diagnósticos entre impresiones de las posiciones en pantalla
 
 // Función para dividir la masa de los planetas entre la masa solar
-void normalizarMasa(Planet planets[]) {
+void normalizarMasa(Planet planets[], int num_planetas) {
     int i;
-    for (i = 0; i < NUM_PLANETS; i++) {
+    for (i = 0; i < num_planetas; i++) {
         planets[i].mass /= MASA_SOLAR;
     }
 }
 
 // Función para convertir distancias y velocidades a unidades astronómicas (UA y UA/s)
-void convertirUnidadesAU(Planet planets[]) {
+void convertirUnidadesAU(Planet planets[], int num_planetas) {
     int i;
-    for (i = 0; i < NUM_PLANETS; i++) {
+    for (i = 0; i < num_planetas; i++) {
         // Convertir posición de metros a UA
         planets[i].position[0] /= AU;
         planets[i].position[1] /= AU;
@@ -87,356 +53,504 @@ void convertirUnidadesAU(Planet planets[]) {
     }
 }
 
-// Función para convertir de unidades rescaladas a unidades originales
-void convertirAUnidadesOriginales(Planet planets[]) {
-    int i; 
-    for (i = 0; i < NUM_PLANETS; i++) {
-        // Convertir masa de masas solares a kilogramos
-        planets[i].mass *= MASA_SOLAR;
-
-        // Convertir posición de UA a metros
-        planets[i].position[0] *= AU;
-        planets[i].position[1] *= AU;
-
-        // Convertir velocidad de UA/s a m/s
-        planets[i].velocity[0] *= AU;
-        planets[i].velocity[1] *= AU;
-    }
-}
-
 // Función para reescalar las velocidades según el factor de tiempo
-void reescalarVelocidades(Planet planets[], double factor_tiempo) {
+void reescalarVelocidades(Planet planets[], int num_planetas, double factor_tiempo) {
     int i;
-    for (i = 0; i < NUM_PLANETS; i++) {
+    for (i = 0; i < num_planetas; i++) {
         planets[i].velocity[0] /= factor_tiempo;
         planets[i].velocity[1] /= factor_tiempo;
     }
 }
 
-// Función para deshacer el reescalado de las velocidades
-void deshacerReescaladoVelocidades(Planet planets[], double factor_tiempo) {
-    int i; 
-    for (i = 0; i < NUM_PLANETS; i++) {
-        planets[i].velocity[0] *= factor_tiempo;
-        planets[i].velocity[1] *= factor_tiempo;
-    }
-}
-
-// Calcular la fuerza gravitacional entre dos planetas
-void calcularFuerza(Planet *a, Planet *b, double *fx, double *fy) {
-    double dx,dy,distancia,fuerza; 
-     dx = b->position[0] - a->position[0];
-     dy = b->position[1] - a->position[1];
-    // dx y dy son las diferencias de posición entre los planetas a y b
-
-    distancia = sqrt(dx * dx + dy * dy);
-    fuerza = (1*a->mass * b->mass) / (distancia * distancia); //G es la unidad debido al rescalamiento
-    *fx = fuerza * dx / distancia; //Componente x del vector fuerza 
-    *fy = fuerza * dy / distancia; //Componente y del vector fuerza
-}
 //ANOTACIÓN SOBRE EL OPERADOR ->
 /*
-b es un puntero de tipo Planet, apunta a una dirección de memoria de una variable de tipo Planet.
--> es un operador de acceso a una propiedad del struct Planet equivalente a
- por ejemplo, (*b).position[0], que accede a la posición en x del planeta b. 
- a->mass accede a la masa del planeta a.
+c es un puntero de tipo Cuerpos, apunta a una dirección de memoria de una variable de tipo Cuerpos.
+-> es un operador de acceso a una propiedad del struct equivalente a
+ por ejemplo, (*c).x[i], que accede a la posición en x del cuerpo i.
+ c->m[i] accede a la masa del cuerpo i.
 */
 
-void calcularAceleraciones(Planet planets[], double a[NUM_PLANETS][2]) {
-
-    double fuerzas[NUM_PLANETS][2] = {0};
-
-    // Paralelizar el cálculo de las fuerzas gravitacionales
-
-    //dynamic apropiado cuando las iteraciones tienen distintos costes computacionales
-    //distribuye las iteraciones de manera dinámica entre los hilos sin orden considerando su tiempo de ejecución
-   // #pragma omp parallel for schedule(dynamic)
-   int i, j, k;
-    for (i = 0; i < NUM_PLANETS; i++) {
-        for (j = i + 1; j < NUM_PLANETS; j++) {
-            double fx, fy;
-            calcularFuerza(&planets[i], &planets[j], &fx, &fy);
-            //omp atomic evita conflictos al utilizar una misma variable compartida
-            //sincronizar entre hilos el acceso a una posición de memoria común, fx y fy
-            //#pragma omp atomic
-            fuerzas[i][0] += fx;
-            //#pragma omp atomic
-            fuerzas[i][1] += fy;
-            //#pragma omp atomic
-            fuerzas[j][0] -= fx;
-            //#pragma omp atomic
-            fuerzas[j][1] -= fy;
-        }
-    }
-
-    // Calcular aceleraciones a partir de las fuerzas
-    #pragma omp parallel for
-    for (k = 0; k < NUM_PLANETS; k++) {
-        a[k][0] = fuerzas[k][0] / planets[k].mass;
-        a[k][1] = fuerzas[k][1] / planets[k].mass;
+// Imprimir las posiciones de los planetas (en m) en un instante de tiempo (en s)
+void imprimirPosiciones(const Cuerpos *c, double tiempo) {
+    printf("Tiempo: %.2f días\n", tiempo / DAY);
+    int i;
+    for ( i = 0; i < c->num; i++) {
+        printf("%s: x = %.2e, y = %.2e\n", c->nombres[i], c->x[i] * AU, c->y[i] * AU);
     }
-
-    /* Creemos que calcular las aceleraciones a partir de la fuerzas disminuye el tiempo de ejecución porque 
-    se calcula sólo la fuerza una vez por cada par de planetas,*/
+    printf("\n"); //salto de línea
 }
- 
-//Calcula el módulo de la velocidad 
-void calcularModulosVelocidad(Planet planets[], double modulosVelocidad[]) {
-    int i; 
-    for (i = 0; i < NUM_PLANETS; i++) {
-        modulosVelocidad[i] = sqrt(planets[i].velocity[0] * planets[i].velocity[0] +
-                                   planets[i].velocity[1] * planets[i].velocity[1]);
+
+// Función para guardar las posiciones de los planetas (en UA) en un archivo
+void guardarPosiciones(const Cuerpos *c, FILE *archivo_posiciones) {
+    int i;
+    for ( i = 0; i < c->num; i++) {
+        fprintf(archivo_posiciones, "%.6e, %.6e\n", c->x[i], c->y[i]);
     }
+    fprintf(archivo_posiciones, "\n"); // Línea en blanco para separar instantes de tiempo
 }
 
-
-// Calcular las energías del sistema (SIN RESCALAMIENTO)
-void calcularEnergias(Planet planets[], double *energiaCinetica, double *energiaPotencial) {
-    energiaCinetica[0] = 0;
-    energiaPotencial[0] = 0;
-    double modulosVelocidad[NUM_PLANETS] ={0};
-    double energiaCineticaLocal = 0;
-    double velocidad2;
+// Lo mismo para las partículas de prueba (en unidades reescaladas, como los planetas)
+void guardarPosicionesParticulas(const Particulas *p, FILE *archivo_particulas) {
     int i;
-    // Energía cinética del sistema
-    //#pragma omp parallel for divide la iteraciones del for entre los hilos disponibles
-    //reduction(+:energiaCinetica) cada hilo tiene su propia copia privada de energiaCinetica y al final se suman todas las copias
-    #pragma omp parallel for reduction(+:energiaCineticaLocal) 
-
-    calcularModulosVelocidad(planets, modulosVelocidad);
-    for (i = 0; i < NUM_PLANETS; i++) {
-        energiaCineticaLocal += 0.5 * planets[i].mass * modulosVelocidad[i]*modulosVelocidad[i]; // Energía cinética
+    for (i = 0; i < p->num; i++) {
+        fprintf(archivo_particulas, "%.6e, %.6e\n", p->x[i], p->y[i]);
     }
-
-    /*Cada hilo calcula el valor de velocidad2 para las iteraciones del bucle que le han sido asignadas. 
-    Cada hilo utiliza su copia privada de *energiaCinetica (creada automáticamente por la cláusula reduction) para acumular las contribuciones de las iteraciones que le corresponden.
-    Una vez que todos los hilos han terminado de procesar sus iteraciones, OpenMP combina las copias privadas de *energiaCinetica en una única copia global. 
-    En este caso, las copias privadas se suman para obtener el valor final de *energiaCinetica
-    */
-
-    //Usamos una variable de tipo double porque no se pueden utilizar punteros en reduction.
-
-    *energiaCinetica = energiaCineticaLocal;
-    
-     // Energía potencial del sistema
-     double energiaPotencialLocal = 0; // Variable local para la reducción
-     int j;
-     double dx, dy, distancia;
-     #pragma omp parallel for reduction(+:energiaPotencialLocal)
-     for (i = 0; i < NUM_PLANETS; i++) {
-         for (j = i + 1; j < NUM_PLANETS; j++) {
-             dx = planets[j].position[0] - planets[i].position[0];
-             dy = planets[j].position[1] - planets[i].position[1];
-             distancia = sqrt(dx * dx + dy * dy);
-             energiaPotencialLocal -= (G * planets[i].mass * planets[j].mass) / distancia;
-         }
-     }
-     *energiaPotencial = energiaPotencialLocal; 
+    fprintf(archivo_particulas, "\n");
 }
 
+// Estado completo de la simulación en un punto de control: con él se
+// continúa exactamente igual que si no se hubiera interrumpido. En el fichero
+// va esta cabecera y detrás, para los num_planetas cuerpos masivos, planets
+// (en unidades reescaladas), periodos, cruzo_eje e y_anterior, y para las
+// num_particulas partículas de prueba x, y, vx y vy, y por último el estado
+// del integrador (enteros_integrador enteros)
+#define PUNTO_CONTROL_MAGIA "PLANETP5"
 
-// Actualizar posiciones y velocidades usando el método de Verlet
-void actualizarPlanetas(Planet planets[], double dt) {
-    double a[NUM_PLANETS][2] = {0};
-
-    //Calcula las aceleraciones en el tiempo t a partir de las fuerzas con las posiciones en el tiempo t
-    calcularAceleraciones(planets, a); 
-
-    double w[NUM_PLANETS][2] = {0};
+typedef struct {
+    char magia[8];
+    int num_planetas;                 // Cuerpos con masa
+    int num_particulas;               // Partículas de prueba
+    long paso;                        // Pasos ya hechos
+    double t;                         // Tiempo (reescalado) del siguiente paso
+    long bytes_energias;              // Tamaño de los ficheros de salida hasta aquí
+    long bytes_posiciones;
+    long bytes_momento;
+    long bytes_particulas;
+    double theta;                     // Ángulo de apertura de Barnes-Hut (0: suma directa)
+    long cada_pasos;                  // Cadencia de los diagnósticos (pasos o segundos de reloj)
+    double cada_segundos;
+    long muestras;                    // Diagnósticos escritos hasta aquí
+    int integrador;                   // TipoIntegrador
+    int enteros_integrador;           // Enteros del estado del integrador (detrás de las partículas)
+    double dt;                        // Paso y duración (reescalados)
+    double tiempo_total;
+} EstadoSimulacion;
+
+// Escribe (o lee) n elementos de tamaño bytes; con n = 0 no hay nada que hacer
+static int escribirVector(const void *datos, size_t bytes, int n, FILE *archivo) {
+    return n > 0 && fwrite(datos, bytes, n, archivo) != (size_t)n;
+}
 
-    //Almacena en un array w las velocidades y aceleraciones en el tiempo t 
-    int i; 
-    for (i = 1; i < NUM_PLANETS; i++) {
-        w[i][0] = planets[i].velocity[0] + 0.5 * dt * a[i][0];
-        w[i][1] = planets[i].velocity[1] + 0.5 * dt * a[i][1];
-    }
+static int leerVector(void *datos, size_t bytes, int n, FILE *archivo) {
+    return n > 0 && fread(datos, bytes, n, archivo) != (size_t)n;
+}
 
-    // Actualizar posiciones al tiempo t+dt
-    int j;
-    for (j= 0; j < NUM_PLANETS; j++) {
-        planets[j].position[0] += planets[j].velocity[0] * dt + 0.5 * a[j][0] * dt * dt;
-        planets[j].position[1] += planets[j].velocity[1] * dt + 0.5 * a[j][1] * dt * dt;
+// Guarda el punto de control en un fichero temporal y lo renombra al
+// terminar: si el programa se corta a mitad, el anterior sigue intacto
+int guardarPuntoControl(const EstadoSimulacion *estado, const Planet planets[], const double periodos[],
+                        const bool cruzo_eje[], const double y_anterior[], const Particulas *particulas,
+                        const int estado_integrador[]) {
+    const char *ruta_temporal = RUTA_PUNTO_CONTROL ".tmp";
+    FILE *archivo = fopen(ruta_temporal, "wb");
+    int n = estado->num_planetas, np = estado->num_particulas;
+    if (archivo == NULL) {
+        return 1;
     }
-
-    // Calcular la aceleración con las posiciones actualizadas
-    calcularAceleraciones(planets, a);
-
-    //Calcular las nuevas velocidades al tiempo t+dt a partir de las aceleraciones en el tiempo t+dt y el array w
-    int k; 
-    for ( k = 0; k < NUM_PLANETS; k++) {
-        planets[k].velocity[0] = w[k][0] + 0.5 * a[k][0] * dt;
-        planets[k].velocity[1] = w[k][1] + 0.5 * a[k][1] * dt;
+    int error = fwrite(estado, sizeof(*estado), 1, archivo) != 1;
+    error |= escribirVector(planets, sizeof(Planet), n, archivo);
+    error |= escribirVector(periodos, sizeof(double), n, archivo);
+    error |= escribirVector(cruzo_eje, sizeof(bool), n, archivo);
+    error |= escribirVector(y_anterior, sizeof(double), n, archivo);
+    error |= escribirVector(particulas->x, sizeof(double), np, archivo);
+    error |= escribirVector(particulas->y, sizeof(double), np, archivo);
+    error |= escribirVector(particulas->vx, sizeof(double), np, archivo);
+    error |= escribirVector(particulas->vy, sizeof(double), np, archivo);
+    error |= escribirVector(estado_integrador, sizeof(int), estado->enteros_integrador, archivo);
+    // Los datos tienen que estar en el disco antes de sustituir al anterior
+    error |= fflush(archivo) != 0;
+    error |= fsync(fileno(archivo)) != 0;
+    error |= fclose(archivo) != 0;
+    if (error || rename(ruta_temporal, RUTA_PUNTO_CONTROL) != 0) {
+        remove(ruta_temporal);
+        return 1;
     }
+    return 0;
 }
 
-// Imprimir las posiciones de los planetas en un instante de tiempo
-void imprimirPosiciones(Planet planets[], double tiempo) {
-    printf("Tiempo: %.2f días\n", tiempo / DAY);
-    int i;
-    for ( i = 0; i < NUM_PLANETS; i++) {
-        printf("%s: x = %.2e, y = %.2e\n", planets[i].name, planets[i].position[0], planets[i].position[1]);
+// Lee la cabecera del punto de control. Devuelve el fichero abierto justo
+// detrás, para leer los datos con leerDatosPuntoControl una vez reservados
+// los vectores, o NULL si no hay un punto de control válido.
+FILE *abrirPuntoControl(EstadoSimulacion *estado) {
+    FILE *archivo = fopen(RUTA_PUNTO_CONTROL, "rb");
+    if (archivo == NULL) {
+        return NULL;
     }
-    printf("\n"); //salto de línea
+    if (fread(estado, sizeof(*estado), 1, archivo) != 1 ||
+        memcmp(estado->magia, PUNTO_CONTROL_MAGIA, 8) != 0 ||
+        estado->num_planetas <= 0 || estado->num_particulas < 0 ||
+        estado->integrador < 0 || estado->integrador >= NUM_INTEGRADORES ||
+        estado->enteros_integrador != enterosEstadoIntegrador(estado->integrador, estado->num_planetas,
+                                                              estado->num_particulas)) {
+        fclose(archivo);
+        return NULL;
+    }
+    return archivo;
 }
 
-// Función para guardar las posiciones de los planetas en un archivo
-void guardarPosiciones(Planet planets[], FILE *archivo_posiciones) {
-    int i;
-    for ( i = 0; i < NUM_PLANETS; i++) {
-        fprintf(archivo_posiciones, "%.6e, %.6e\n", planets[i].position[0], planets[i].position[1]);
-    }
-    fprintf(archivo_posiciones, "\n"); // Línea en blanco para separar instantes de tiempo
+// Lee los datos que siguen a la cabecera y cierra el fichero. Devuelve 0 si todo va bien.
+int leerDatosPuntoControl(FILE *archivo, const EstadoSimulacion *estado, Planet planets[], double periodos[],
+                          bool cruzo_eje[], double y_anterior[], Particulas *particulas, int estado_integrador[]) {
+    int n = estado->num_planetas, np = estado->num_particulas;
+    int error = leerVector(planets, sizeof(Planet), n, archivo);
+    error |= leerVector(periodos, sizeof(double), n, archivo);
+    error |= leerVector(cruzo_eje, sizeof(bool), n, archivo);
+    error |= leerVector(y_anterior, sizeof(double), n, archivo);
+    error |= leerVector(particulas->x, sizeof(double), np, archivo);
+    error |= leerVector(particulas->y, sizeof(double), np, archivo);
+    error |= leerVector(particulas->vx, sizeof(double), np, archivo);
+    error |= leerVector(particulas->vy, sizeof(double), np, archivo);
+    error |= leerVector(estado_integrador, sizeof(int), estado->enteros_integrador, archivo);
+    fclose(archivo);
+    return error;
 }
 
-// Función para calcular los períodos de los planetas usando la Tercera Ley de Kepler
-void calcularPeriodos(Planet planets[], double periodos[], double t) {
-    int i; 
-    for (i = 0; i < NUM_PLANETS; i++) {
-            if((planets[i].position[1] < 0) && (periodos[i]==0))
-            {
-                periodos[i] = 2*t;
-            }
-        }
+// Abre un fichero de salida. Al continuar se recorta a los bytes que tenía
+// en el punto de control y se sigue escribiendo al final.
+FILE *abrirSalida(const char *ruta, bool continuar, long bytes) {
+    if (!continuar) {
+        return fopen(ruta, "w");
     }
-
- 
-double calcularMomentoAngularTotal(Planet planets[]) {
-    double momento_angular_total = 0.0;
-    int i;
-    double r, momento_angular; 
-    double modulosVelocidad[NUM_PLANETS] = {0};
-
-    for (i = 0; i < NUM_PLANETS; i++) {
-        // Módulo de la posición
-        double r = sqrt(planets[i].position[0] * planets[i].position[0] +
-                        planets[i].position[1] * planets[i].position[1]);
-
-        // Módulo de la velocidad
-      calcularModulosVelocidad(planets, modulosVelocidad);
-
-        // Momento angular del planeta
-        double momento_angular = planets[i].mass * r * modulosVelocidad[i];
-
-        // Sumar al momento angular total
-        momento_angular_total += momento_angular;
+    if (truncate(ruta, bytes) != 0) {
+        return NULL;
     }
-
-    return momento_angular_total;
+    return fopen(ruta, "a");
 }
 
-
-int main() {
+int main(int argc, char *argv[]) {
 
     //omp_set_num_threads(2); 
     // Establecer el número de hilos 
 
     time_t inicio = time(NULL); // Guardar el tiempo de inicio de la simulación
 
-    int vueltas[NUM_PLANETS];
-    Planet planets[NUM_PLANETS];
-    double periodos[NUM_PLANETS] = {0}; 
+    int i;
+    bool continuar = false;
+    double theta = 0.0;
+    long cada_pasos = 1;
+    double cada_segundos = 0.0;
+    int integrador = INTEGRADOR_VERLET;
+    double dias_paso = 0.1, anos = 50.0;
+    bool anos_dados = false;
+    const char *ruta_catalogo = RUTA_CATALOGO;
+    EstadoSimulacion estado = {0};
+    Catalogo catalogo = {0};
+    FILE *archivo_control = NULL;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--continuar") == 0) {
+            continuar = true;
+        } else if (strcmp(argv[i], "--theta") == 0 && i + 1 < argc) {
+            char *fin;
+            i++;
+            errno = 0;
+            theta = strtod(argv[i], &fin);
+            if (errno != 0 || fin == argv[i] || *fin != '\0') {
+                fprintf(stderr, "Ángulo de apertura no válido: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--catalogo") == 0 && i + 1 < argc) {
+            ruta_catalogo = argv[++i];
+        } else if (strcmp(argv[i], "--integrador") == 0 && i + 1 < argc) {
+            integrador = buscarIntegrador(argv[++i]);
+            if (integrador < 0) {
+                fprintf(stderr, "Integrador desconocido %s (verlet, leapfrog, yoshida4, yoshida6 o wh)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            dias_paso = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--anos") == 0 && i + 1 < argc) {
+            anos = atof(argv[++i]);
+            anos_dados = true;
+        } else if (strcmp(argv[i], "--cada") == 0 && i + 1 < argc) {
+            cada_pasos = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--cada-segundos") == 0 && i + 1 < argc) {
+            cada_segundos = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Uso: %s [--catalogo fichero] [--theta angulo] [--integrador nombre] [--dt dias] [--anos anos]\n"
+                    "       [--cada pasos | --cada-segundos s] [--continuar]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!(theta >= 0 && theta <= THETA_MAXIMO)) {
+        fprintf(stderr, "El ángulo de apertura tiene que estar entre 0 y %.1f\n", THETA_MAXIMO);
+        return 1;
+    }
+    if (dias_paso <= 0 || anos <= 0) {
+        fprintf(stderr, "El paso y la duración de la simulación tienen que ser positivos\n");
+        return 1;
+    }
+    if (cada_pasos < 1 || cada_segundos < 0) {
+        fprintf(stderr, "La cadencia de los diagnósticos tiene que ser de al menos un paso (o de segundos positivos)\n");
+        return 1;
+    }
 
+    // Al continuar, los cuerpos y la gravedad son los del punto de control;
+    // si no, los cuerpos salen del catálogo
+    int num_planetas, num_particulas;
+    if (continuar) {
+        archivo_control = abrirPuntoControl(&estado);
+        if (archivo_control == NULL) {
+            fprintf(stderr, "No se puede leer el punto de control %s\n", RUTA_PUNTO_CONTROL);
+            return 1;
+        }
+        theta = estado.theta;
+        cada_pasos = estado.cada_pasos;
+        cada_segundos = estado.cada_segundos;
+        num_planetas = estado.num_planetas;
+        num_particulas = estado.num_particulas;
+    } else {
+        if (leerCatalogo(ruta_catalogo, &catalogo) != 0) {
+            return 1;
+        }
+        num_planetas = catalogo.num_masivos;
+        num_particulas = catalogo.num_particulas;
+    }
 
-    inicializarPlanetas(planets);
+    Planet *planets = malloc(num_planetas * sizeof(Planet));
+    double *periodos = calloc(num_planetas, sizeof(double));
+    bool *cruzo_eje = calloc(num_planetas, sizeof(bool)); // Indica si el planeta ha cruzado el eje y (inicialmente ninguno)
+    double *y_anterior = calloc(num_planetas, sizeof(double)); // y de cada planeta en el paso anterior
+    Particulas particulas;
+    if (planets == NULL || periodos == NULL || cruzo_eje == NULL || y_anterior == NULL ||
+        crearParticulas(&particulas, num_particulas) != 0) {
+        fprintf(stderr, "Sin memoria para los cuerpos\n");
+        return 1;
+    }
 
+    // Calcular el factor de reescalado del tiempo
+    double factor_tiempo = sqrt(G * MASA_SOLAR / pow(AU, 3));
 
+    // Los diagnósticos se calculan en unidades reescaladas: estos factores los
+    // pasan a J y a kg m^2/s al escribirlos
+    double factor_energia = MASA_SOLAR * pow(AU * factor_tiempo, 2);
+    double factor_momento = MASA_SOLAR * AU * AU * factor_tiempo;
 
-    // Rescalar masas (a masa solar) y posiciones y velocidades a UA y UA/s
-    normalizarMasa(planets);
-    convertirUnidadesAU(planets);
+    if (!continuar) {
+        memcpy(planets, catalogo.masivos, num_planetas * sizeof(Planet));
 
-    // Calcular el factor de reescalado del tiempo
-    double factor_tiempo = sqrt(G * MASA_SOLAR / pow(AU, 3));
+        // Rescalar masas (a masa solar) y posiciones y velocidades a UA y UA/s
+        normalizarMasa(planets, num_planetas);
+        convertirUnidadesAU(planets, num_planetas);
+
+        // Reescalar las velocidades según el factor de tiempo
+        reescalarVelocidades(planets, num_planetas, factor_tiempo);
 
-    // Reescalar las velocidades según el factor de tiempo
-    reescalarVelocidades(planets, factor_tiempo);
+        // Las partículas de prueba, igual (su masa es 0)
+        convertirUnidadesAU(catalogo.particulas, num_particulas);
+        reescalarVelocidades(catalogo.particulas, num_particulas, factor_tiempo);
+        cargarParticulas(&particulas, catalogo.particulas);
+        liberarCatalogo(&catalogo);
+    }
 
     // Reescalar el tiempo
-    double dt = 0.1*DAY * factor_tiempo; 
-    double tiempo_total = 50*YEAR * DAY * factor_tiempo; 
+    double dt = dias_paso*DAY * factor_tiempo; 
+    double tiempo_total = anos*YEAR * DAY * factor_tiempo; 
+    if (continuar) {
+        integrador = estado.integrador;
+        dt = estado.dt;
+        if (!anos_dados) {
+            tiempo_total = estado.tiempo_total;
+        }
+    }
 
-    FILE *archivo = fopen("energias.txt", "w");
+    FILE *archivo = abrirSalida("energias.txt", continuar, estado.bytes_energias);
     if (!archivo) {
         perror("Error al abrir el archivo");
         return 1;
     }
 
     // Abrir archivo para guardar las posiciones
-    FILE *archivo_posiciones = fopen("posiciones_planetas.txt", "w");
+    FILE *archivo_posiciones = abrirSalida("posiciones_planetas.txt", continuar, estado.bytes_posiciones);
      if (!archivo_posiciones) {
         perror("Error al abrir el archivo de posiciones");
         return 1;
     }
     
     // Abrir archivo para guardar el momento angular total
-    FILE *archivo_momento_total = fopen("momento_angular_total.txt", "w");
+    FILE *archivo_momento_total = abrirSalida("momento_angular_total.txt", continuar, estado.bytes_momento);
     if (!archivo_momento_total) {
     perror("Error al abrir el archivo de momento angular total");
     return 1;
     }
 
-    //Inicializar el número de vueltas completas de cada planeta
-    int i; 
-    for (i = 0; i < NUM_PLANETS; i++) {
-        vueltas[i] = 0;
+    // Las posiciones de las partículas, solo si las hay y cada INTERVALO_PARTICULAS días
+    FILE *archivo_particulas = NULL;
+    if (num_particulas > 0) {
+        archivo_particulas = abrirSalida("posiciones_particulas.txt", continuar, estado.bytes_particulas);
+        if (!archivo_particulas) {
+            perror("Error al abrir el archivo de posiciones de las partículas");
+            return 1;
+        }
     }
 
-    bool cruzo_eje[NUM_PLANETS]; // Indica si el planeta ha cruzado el eje y
-    for (i = 0; i < NUM_PLANETS; i++) {
-        cruzo_eje[i] = false; // Inicialmente, ningún planeta ha cruzado el eje
+
+    // Al continuar, el estado de los planetas, las partículas y los diagnósticos sale del punto de control
+    double t = 0;
+    long paso = 0, muestras = 0;
+    int *estado_integrador = NULL;
+    if (continuar) {
+        estado_integrador = malloc((estado.enteros_integrador + 1) * sizeof(int));
+        if (estado_integrador == NULL ||
+            leerDatosPuntoControl(archivo_control, &estado, planets, periodos, cruzo_eje, y_anterior, &particulas,
+                                  estado_integrador) != 0) {
+            fprintf(stderr, "No se puede leer el punto de control %s\n", RUTA_PUNTO_CONTROL);
+            return 1;
+        }
+        t = estado.t;
+        paso = estado.paso;
+        muestras = estado.muestras;
+        printf("Continuando desde el paso %ld (%.2f días)\n", paso, t / factor_tiempo / DAY);
+    }
+
+    // Los cuerpos se integran en la estructura de vectores; planets es solo
+    // la vista para cargarlos y para el punto de control
+    Cuerpos cuerpos;
+    if (crearCuerpos(&cuerpos, num_planetas) != 0) {
+        fprintf(stderr, "Sin memoria para los cuerpos\n");
+        return 1;
+    }
+    cargarCuerpos(&cuerpos, planets);
+    if (!continuar) {
+        for (i = 0; i < num_planetas; i++) {
+            y_anterior[i] = cuerpos.y[i]; // Los períodos se miden desde las posiciones iniciales
+        }
+    }
+    printf("%d cuerpos con masa y %d partículas de prueba\n", num_planetas, num_particulas);
+
+    // Con theta > 0 la gravedad sale del árbol de Barnes-Hut; antes de empezar
+    // se compara con la suma directa para saber qué error se comete
+    ArbolBarnesHut arbol, *usar_arbol = NULL;
+    if (theta > 0) {
+        double error_medio, error_maximo;
+        if (crearArbolBarnesHut(&arbol, &cuerpos, theta) != 0 ||
+            compararConSumaDirecta(&cuerpos, &arbol, &error_medio, &error_maximo) != 0) {
+            fprintf(stderr, "Sin memoria para el árbol de Barnes-Hut\n");
+            return 1;
+        }
+        usar_arbol = &arbol;
+        printf("Barnes-Hut (theta = %.3f): error relativo de la aceleración frente a la suma directa %.2e de media, "
+               "%.2e como máximo; %.1f interacciones por cuerpo\n", theta, error_medio, error_maximo,
+               (double)arbol.interacciones / cuerpos.num);
+    } else {
+        printf("Cálculo de fuerzas: suma directa (%s)\n", rutaFuerzas());
     }
 
+    // El integrador calcula ya las aceleraciones en el tiempo t del primer paso
+    Integrador integracion;
+    if (crearIntegrador(&integracion, integrador, &cuerpos, &particulas, usar_arbol,
+                        continuar ? estado_integrador : NULL) != 0) {
+        fprintf(stderr, "Sin memoria para el integrador\n");
+        return 1;
+    }
+    free(estado_integrador);
+    // Los intervalos en días, pasados a pasos con el dt de la simulación
+    double dias_dt = dt / factor_tiempo / DAY;
+    long pasos_punto_control = (long)ceil(INTERVALO_PUNTO_CONTROL / dias_dt);
+    long pasos_particulas = (long)ceil(INTERVALO_PARTICULAS / dias_dt);
+    printf("Integrador: %s con dt = %g días durante %g años\n", nombreIntegrador(integrador),
+           dias_dt, tiempo_total / factor_tiempo / DAY / YEAR);
+
+    // Muestras de diagnósticos cada cada_pasos pasos o, con --cada-segundos,
+    // cada cada_segundos segundos de reloj
+    double reloj_muestra = omp_get_wtime();
 
     //CON EL TIEMPO Y LAS CONDICIONES INICIALES RESCALADAS
-    for (double t = 0; t < tiempo_total; t += dt) {
+    for (; t < tiempo_total; t += dt) {
 
         //Calcular posiciones y velocidades en el tiempo t+dt
-        actualizarPlanetas(planets, dt);
-        // Guardar las posiciones de los planetas para cada tiempo.
-        guardarPosiciones(planets, archivo_posiciones);
-        
-        // Convertir a unidades originales antes de calcular las energías
-        convertirAUnidadesOriginales(planets);
-        // Deshacer el reescalado de las velocidades por el factor tiempo 
-        deshacerReescaladoVelocidades(planets, factor_tiempo);
-        
-
-        double energiaCinetica, energiaPotencial;
-        //Devuelve la energía cinética y potencial del sistema en el tiempo t + dt  en (m, kg, s)
-        calcularEnergias(planets, &energiaCinetica, &energiaPotencial);
-        double energiaMecanica = energiaCinetica + energiaPotencial;
-
-        //Guarda las energías en el archivo. El tiempo en días se tiene en cuenta en el código de python 
-        fprintf(archivo, "%.6e %.6e %.6e\n", energiaCinetica, energiaPotencial, energiaMecanica);
-
-        // Calcular el momento angular total y guardarlo en el archivo
-        double momento_angular_total = calcularMomentoAngularTotal(planets);
-         fprintf(archivo_momento_total, "%.6e\n", momento_angular_total);
-
-        if ((int)(t / dt) % 30 == 0) { // Imprimir cada 30 días
-            imprimirPosiciones(planets, t / factor_tiempo); // Tiempo en unidades originales
+        pasoIntegrador(&integracion, &cuerpos, &particulas, dt);
+        paso++;
+
+        // Los cruces del eje x, en todos los pasos: es O(N) y no depende de los diagnósticos
+        actualizarPeriodos(&cuerpos, t, t + dt, y_anterior, periodos, cruzo_eje);
+
+        bool toca_muestra = (cada_segundos > 0) ? omp_get_wtime() - reloj_muestra >= cada_segundos
+                                                : paso % cada_pasos == 0;
+        if (toca_muestra) {
+            double t_estado = t + dt; // Tiempo (reescalado) de las posiciones y velocidades
+            double dias = t_estado / factor_tiempo / DAY;
+            reloj_muestra = omp_get_wtime();
+            muestras++;
+
+            // Guardar las posiciones de los planetas en este tiempo
+            guardarPosiciones(&cuerpos, archivo_posiciones);
+
+            // Energías y momento angular en (m, kg, s) y el tiempo en días
+            Diagnosticos diagnosticos;
+            calcularDiagnosticos(&cuerpos, &diagnosticos);
+            double energiaCinetica = diagnosticos.cinetica * factor_energia;
+            double energiaPotencial = diagnosticos.potencial * factor_energia;
+            fprintf(archivo, "%.6e %.6e %.6e %.6e\n", energiaCinetica, energiaPotencial,
+                    energiaCinetica + energiaPotencial, dias);
+            fprintf(archivo_momento_total, "%.6e %.6e\n", diagnosticos.momento_angular * factor_momento, dias);
+
+            if ((muestras - 1) % INTERVALO_IMPRESION == 0) {
+                imprimirPosiciones(&cuerpos, t_estado / factor_tiempo); // Tiempo en unidades originales
+            }
         }
 
-        // Volver a normalizar las unidades para continuar la simulación
-        normalizarMasa(planets);
-        convertirUnidadesAU(planets);
-
-        // Reescalar las velocidades nuevamente para continuar la simulación
-        reescalarVelocidades(planets, factor_tiempo);
+        if (archivo_particulas != NULL && paso % pasos_particulas == 0) {
+            guardarPosicionesParticulas(&particulas, archivo_particulas);
+        }
 
-        
-            calcularPeriodos(planets, periodos, t);
+        // Punto de control cada INTERVALO_PUNTO_CONTROL días, con el tamaño
+        // que tienen en ese momento los ficheros de salida
+        if (paso % pasos_punto_control == 0) {
+            fflush(archivo);
+            fflush(archivo_posiciones);
+            fflush(archivo_momento_total);
+            memcpy(estado.magia, PUNTO_CONTROL_MAGIA, 8);
+            estado.num_planetas = num_planetas;
+            estado.num_particulas = num_particulas;
+            estado.paso = paso;
+            estado.theta = theta;
+            estado.cada_pasos = cada_pasos;
+            estado.cada_segundos = cada_segundos;
+            estado.muestras = muestras;
+            estado.integrador = integrador;
+            estado.enteros_integrador = enterosEstadoIntegrador(integrador, num_planetas, num_particulas);
+            estado.dt = dt;
+            estado.tiempo_total = tiempo_total;
+            estado.t = t + dt;
+            extraerPlanetas(&cuerpos, planets); // En unidades reescaladas
+            estado.bytes_energias = ftell(archivo);
+            estado.bytes_posiciones = ftell(archivo_posiciones);
+            estado.bytes_momento = ftell(archivo_momento_total);
+            estado.bytes_particulas = 0;
+            if (archivo_particulas != NULL) {
+                fflush(archivo_particulas);
+                estado.bytes_particulas = ftell(archivo_particulas);
+            }
+            if (guardarPuntoControl(&estado, planets, periodos, cruzo_eje, y_anterior, &particulas,
+                                    estadoIntegrador(&integracion)) != 0) {
+                fprintf(stderr, "Aviso: no se ha podido guardar el punto de control\n");
+            }
+        }
     }
 
     fclose(archivo);
     fclose(archivo_posiciones);
     fclose(archivo_momento_total);
+    if (archivo_particulas != NULL) {
+        fclose(archivo_particulas);
+    }
+    printf("%ld cálculos de fuerzas\n", integracion.evaluaciones);
+    liberarIntegrador(&integracion);
+    liberarCuerpos(&cuerpos);
+    liberarParticulas(&particulas);
+    if (usar_arbol != NULL) {
+        liberarArbolBarnesHut(usar_arbol);
+    }
     time_t fin = time(NULL); // Guardar el tiempo de finalización de la simulación
 
     // Imprimir los períodos de cada planeta
-    for (int i = 0; i < NUM_PLANETS; i++) {
+    for (int i = 0; i < num_planetas; i++) {
         printf("%s: %.2f años\n", planets[i].name, periodos[i]/( factor_tiempo*DAY* YEAR)); 
      }
+    free(planets);
+    free(periodos);
+    free(cruzo_eje);
+    free(y_anterior);
 
 
     printf("Tiempo de inicio: %s", ctime(&inicio)); // Imprimir el tiempo de inicio
@@ -444,4 +558,4 @@ int main() {
     double tiempo_total_simulacion = difftime(fin, inicio); // Calcular el tiempo total de la simulación
     printf("Tiempo total de simulación: %.8f segundos\n", tiempo_total_simulacion); // Imprimir el tiempo total de la simulación
     return 0;
-}
\ No newline at end of file
+}
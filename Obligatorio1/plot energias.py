@@ -11,8 +11,8 @@ T = data[:, 0]  # Energía cinética
 V = data[:, 1]  # Energía potencial
 E = data[:, 2]  # Energía mecánica total
 
-# Crear un array de tiempo (en días)
-days = np.arange(1, len(T) + 1)
+# Tiempo (en días) de cada muestra: los diagnósticos no tienen por qué estar en todos los pasos
+days = data[:, 3]
 
 # Representar las energías en función del tiempo
 plt.figure(figsize=(10, 6))
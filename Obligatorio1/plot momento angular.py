@@ -1,12 +1,11 @@
 import matplotlib.pyplot as plt
 
 def graficar_momento_angular(fichero):
-    # Leer los valores del momento angular desde el fichero
+    # Leer los valores del momento angular y el tiempo (en días) de cada muestra
     with open(fichero, 'r') as archivo:
-        momento_angular = [float(line.strip()) for line in archivo]
-
-    # Crear el eje de tiempo (un año con pasos de un día)
-    tiempo = [i for i in range(len(momento_angular))]  # Tiempo en días
+        columnas = [line.split() for line in archivo]
+    momento_angular = [float(c[0]) for c in columnas]
+    tiempo = [float(c[1]) for c in columnas]  # Tiempo en días
 
     # Calcular los límites del eje y basados en el rango de los datos
     valor_maximo = max(momento_angular)
@@ -0,0 +1,410 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <omp.h>
+#include "wisdom_holman.h"
+
+#define PI 3.14159265358979323846
+#define UMBRAL_PARALELO 256 // Como en cuerpos.c: con menos no compensa repartir entre hilos
+#define MAXIMO_ITERACIONES_KEPLER 50
+
+// Funciones de Stumpff c2(z) = (1 - cos sqrt z) / z y c3(z) = (sqrt z - sin sqrt z) / z^(3/2)
+// (con cosh y sinh para z < 0). Cerca de 0 las formas cerradas restan
+// números casi iguales, así que se usa la serie.
+static void stumpff(double z, double *c2, double *c3) {
+    if (z > 0.5) {
+        double s = sqrt(z), h = sin(0.5 * s);
+        *c2 = 2.0 * h * h / z;
+        *c3 = (s - sin(s)) / (z * s);
+    } else if (z < -0.5) {
+        double s = sqrt(-z), h = sinh(0.5 * s);
+        *c2 = -2.0 * h * h / z;
+        *c3 = (sinh(s) - s) / (-z * s);
+    } else {
+        // c2 = sum_k (-z)^k / (2k+2)!, c3 = sum_k (-z)^k / (2k+3)!
+        double t2 = 0.5, t3 = 1.0 / 6.0, s2 = 0.0, s3 = 0.0;
+        int k;
+        for (k = 0; k < 12; k++) {
+            s2 += t2;
+            s3 += t3;
+            t2 *= -z / ((2 * k + 3) * (2 * k + 4));
+            t3 *= -z / ((2 * k + 4) * (2 * k + 5));
+        }
+        *c2 = s2;
+        *c3 = s3;
+    }
+}
+
+void derivaKepler(double mu, double dt, double *x, double *y, double *vx, double *vy) {
+    double x0 = *x, y0 = *y, vx0 = *vx, vy0 = *vy;
+    double r0 = sqrt(x0 * x0 + y0 * y0);
+    double eta = x0 * vx0 + y0 * vy0;                  // r0 · v0
+    double beta = 2.0 * mu / r0 - (vx0 * vx0 + vy0 * vy0); // > 0: órbita elíptica
+    double s, g0, g1, g2, g3, r, c2, c3;
+    int k;
+
+    if (dt == 0.0 || r0 == 0.0) {
+        return;
+    }
+    if (beta > 0) {
+        // Las vueltas enteras no cambian nada: solo se avanza lo que sobra
+        dt = fmod(dt, 2.0 * PI * mu / (beta * sqrt(beta)));
+    }
+
+    // Ecuación de Kepler en la variable universal s:
+    // f(s) = r0 G1 + eta G2 + mu G3 - dt = 0, con f' = r. Se resuelve con el
+    // método de Laguerre-Conway, que converge desde casi cualquier punto.
+    s = dt / r0;
+    for (k = 0; k < MAXIMO_ITERACIONES_KEPLER; k++) {
+        double z = beta * s * s;
+        stumpff(z, &c2, &c3);
+        g0 = 1.0 - z * c2;
+        g1 = s * (1.0 - z * c3);
+        g2 = s * s * c2;
+        g3 = s * s * s * c3;
+        double f = r0 * g1 + eta * g2 + mu * g3 - dt;
+        double fp = r0 * g0 + eta * g1 + mu * g2;
+        double fpp = eta * g0 + (mu - beta * r0) * g1;
+        double raiz = sqrt(fabs(16.0 * fp * fp - 20.0 * f * fpp));
+        double ds = -5.0 * f / (fp + copysign(raiz, fp));
+        s += ds;
+        if (fabs(ds) <= 4.0 * DBL_EPSILON * fabs(s)) {
+            break;
+        }
+    }
+
+    double z = beta * s * s;
+    stumpff(z, &c2, &c3);
+    g0 = 1.0 - z * c2;
+    g1 = s * (1.0 - z * c3);
+    g2 = s * s * c2;
+    r = r0 * g0 + eta * g1 + mu * g2;
+
+    // Funciones f y g de Gauss
+    double f = 1.0 - mu * g2 / r0;
+    double g = r0 * g1 + eta * g2;
+    double fd = -mu * g1 / (r * r0);
+    double gd = 1.0 - mu * g2 / r;
+    *x = f * x0 + g * vx0;
+    *y = f * y0 + g * vy0;
+    *vx = fd * x0 + gd * vx0;
+    *vy = fd * y0 + gd * vy0;
+}
+
+int enterosJerarquiaJacobi(int num_cuerpos, int num_particulas) {
+    return 2 * num_cuerpos + num_particulas;
+}
+
+// Para ordenar cuerpos por distancia (de menor a mayor) o por masa (de mayor a menor)
+typedef struct {
+    double valor;
+    int cuerpo;
+} ValorCuerpo;
+
+static int compararAscendente(const void *a, const void *b) {
+    const ValorCuerpo *u = a, *v = b;
+    if (u->valor != v->valor) {
+        return (u->valor < v->valor) ? -1 : 1;
+    }
+    return u->cuerpo - v->cuerpo;
+}
+
+static int compararDescendente(const void *a, const void *b) {
+    const ValorCuerpo *u = a, *v = b;
+    if (u->valor != v->valor) {
+        return (u->valor > v->valor) ? -1 : 1;
+    }
+    return u->cuerpo - v->cuerpo;
+}
+
+static double distancia(double x1, double y1, double x2, double y2) {
+    return hypot(x2 - x1, y2 - y1);
+}
+
+// Anfitrión del punto (x, y): el cuerpo con la esfera de Hill más pequeña de
+// las que lo contienen (radio_hill[k] = 0: k no puede ser anfitrión), o el central
+static int buscarAnfitrion(const Cuerpos *c, const double *radio_hill, int central, double x, double y) {
+    double mejor_radio = INFINITY;
+    int mejor = central, k;
+    for (k = 0; k < c->num; k++) {
+        if (radio_hill[k] > 0 && radio_hill[k] < mejor_radio &&
+            distancia(c->x[k], c->y[k], x, y) < radio_hill[k]) {
+            mejor_radio = radio_hill[k];
+            mejor = k;
+        }
+    }
+    return mejor;
+}
+
+// Los anfitriones se eligen de más a menos masivo: así el de cada cuerpo
+// ya tiene el suyo y su esfera de Hill se mide respecto a él (la de una luna,
+// respecto a su planeta, no al Sol). Deja en radio_hill el de cada cuerpo.
+static void elegirAnfitriones(JerarquiaJacobi *j, const Cuerpos *c, ValorCuerpo *orden, double *radio_hill) {
+    int n = c->num, i, k;
+
+    for (i = 0; i < n; i++) {
+        orden[i].valor = c->m[i];
+        orden[i].cuerpo = i;
+        radio_hill[i] = 0.0;
+    }
+    qsort(orden, n, sizeof(*orden), compararDescendente);
+    int central = orden[0].cuerpo;
+    j->anfitrion[central] = -1;
+    for (k = 1; k < n; k++) {
+        i = orden[k].cuerpo;
+        int h = buscarAnfitrion(c, radio_hill, central, c->x[i], c->y[i]);
+        j->anfitrion[i] = h;
+        radio_hill[i] = distancia(c->x[i], c->y[i], c->x[h], c->y[h]) * cbrt(c->m[i] / (3.0 * c->m[h]));
+    }
+
+    // Luego, por distancia a su anfitrión (el central, a 0)
+    for (i = 0; i < n; i++) {
+        int h = (i == central) ? i : j->anfitrion[i];
+        orden[i].valor = distancia(c->x[i], c->y[i], c->x[h], c->y[h]);
+        orden[i].cuerpo = i;
+    }
+    qsort(orden, n, sizeof(*orden), compararAscendente);
+    for (i = 0; i < n; i++) {
+        j->orden[i] = orden[i].cuerpo;
+    }
+}
+
+// Subsistema del cuerpo h: h con sus satélites (cada uno con los suyos)
+// encadenados de dentro afuera. Devuelve el elemento que lo representa y deja
+// en union_satelite[s] el nodo que une cada satélite s a lo que tiene por dentro.
+static int construirSubsistema(JerarquiaJacobi *j, int h, int *union_satelite) {
+    int n = j->num_cuerpos, elemento = h, k;
+    for (k = 0; k < n; k++) {
+        int s = j->orden[k];
+        if (j->anfitrion[s] == h) {
+            int subsistema = construirSubsistema(j, s, union_satelite);
+            int nodo = j->num_nodos++;
+            j->hijo_a[nodo] = elemento;
+            j->hijo_b[nodo] = subsistema;
+            j->masa[n + nodo] = j->masa[elemento] + j->masa[subsistema];
+            elemento = n + nodo;
+            union_satelite[s] = elemento;
+        }
+    }
+    return elemento;
+}
+
+// Cada partícula orbita el subsistema de su anfitrión con los satélites que
+// están más cerca del anfitrión que ella
+static void elegirNodosParticulas(JerarquiaJacobi *j, const Cuerpos *c, const Particulas *p,
+                                  const int *union_satelite, const double *radio_hill) {
+    int central = 0, q;
+    while (j->anfitrion[central] != -1) {
+        central++;
+    }
+    #pragma omp parallel for schedule(dynamic, 256) if (p->num >= UMBRAL_PARALELO)
+    for (q = 0; q < p->num; q++) {
+        int h = buscarAnfitrion(c, radio_hill, central, p->x[q], p->y[q]), elemento = h, k;
+        double d = distancia(c->x[h], c->y[h], p->x[q], p->y[q]);
+        for (k = 0; k < c->num; k++) {
+            int s = j->orden[k];
+            if (j->anfitrion[s] != h) {
+                continue;
+            }
+            if (distancia(c->x[h], c->y[h], c->x[s], c->y[s]) >= d) {
+                break;
+            }
+            elemento = union_satelite[s];
+        }
+        j->nodo_particula[q] = elemento;
+    }
+}
+
+int crearJerarquiaJacobi(JerarquiaJacobi *j, const Cuerpos *c, const Particulas *p, const int *definicion) {
+    int n = c->num, elementos = 2 * n - 1, nodos = (n > 1) ? n - 1 : 1, error = 0, i;
+    int *union_satelite = malloc(n * sizeof(int));
+    ValorCuerpo *orden = malloc(n * sizeof(ValorCuerpo));
+    double *radio_hill = malloc(n * sizeof(double));
+
+    memset(j, 0, sizeof(*j));
+    j->num_cuerpos = n;
+    j->num_particulas = p->num;
+    j->definicion = malloc(enterosJerarquiaJacobi(n, p->num) * sizeof(int));
+    j->hijo_a = malloc(nodos * sizeof(int));
+    j->hijo_b = malloc(nodos * sizeof(int));
+    double **vectores[11] = {&j->masa, &j->x, &j->y, &j->vx, &j->vy, &j->kx, &j->ky,
+                             &j->rx, &j->ry, &j->rvx, &j->rvy};
+    for (i = 0; i < 11; i++) {
+        *vectores[i] = malloc((i < 7 ? elementos : nodos) * sizeof(double));
+        error |= *vectores[i] == NULL;
+    }
+    if (error || union_satelite == NULL || orden == NULL || radio_hill == NULL || j->definicion == NULL ||
+        j->hijo_a == NULL || j->hijo_b == NULL) {
+        free(union_satelite);
+        free(orden);
+        free(radio_hill);
+        liberarJerarquiaJacobi(j);
+        return 1;
+    }
+    j->anfitrion = j->definicion;
+    j->orden = j->definicion + n;
+    j->nodo_particula = j->definicion + 2 * n;
+
+    if (definicion != NULL) {
+        memcpy(j->definicion, definicion, enterosJerarquiaJacobi(n, p->num) * sizeof(int));
+    } else {
+        elegirAnfitriones(j, c, orden, radio_hill);
+    }
+
+    int central = 0;
+    while (j->anfitrion[central] != -1) {
+        central++;
+    }
+    for (i = 0; i < n; i++) {
+        j->masa[i] = c->m[i];
+    }
+    construirSubsistema(j, central, union_satelite);
+    if (definicion == NULL) {
+        elegirNodosParticulas(j, c, p, union_satelite, radio_hill);
+    }
+    free(union_satelite);
+    free(orden);
+    free(radio_hill);
+    return 0;
+}
+
+void liberarJerarquiaJacobi(JerarquiaJacobi *j) {
+    free(j->definicion);
+    free(j->hijo_a);
+    free(j->hijo_b);
+    free(j->masa);
+    free(j->x);
+    free(j->y);
+    free(j->vx);
+    free(j->vy);
+    free(j->kx);
+    free(j->ky);
+    free(j->rx);
+    free(j->ry);
+    free(j->rvx);
+    free(j->rvy);
+    memset(j, 0, sizeof(*j));
+}
+
+static int raiz(const JerarquiaJacobi *j) {
+    if (j->num_nodos > 0) {
+        return j->num_cuerpos + j->num_nodos - 1;
+    }
+    return 0; // Un solo cuerpo
+}
+
+// Centros de masas de todos los elementos, de las hojas a la raíz
+static void centrosDeMasas(JerarquiaJacobi *j, const Cuerpos *c) {
+    int n = j->num_cuerpos, i, k;
+    for (i = 0; i < n; i++) {
+        j->x[i] = c->x[i];
+        j->y[i] = c->y[i];
+        j->vx[i] = c->vx[i];
+        j->vy[i] = c->vy[i];
+    }
+    for (k = 0; k < j->num_nodos; k++) {
+        int e = n + k, a = j->hijo_a[k], b = j->hijo_b[k];
+        double ma = j->masa[a] / j->masa[e], mb = j->masa[b] / j->masa[e];
+        j->x[e] = ma * j->x[a] + mb * j->x[b];
+        j->y[e] = ma * j->y[a] + mb * j->y[b];
+        j->vx[e] = ma * j->vx[a] + mb * j->vx[b];
+        j->vy[e] = ma * j->vy[a] + mb * j->vy[b];
+    }
+}
+
+void derivaJacobi(JerarquiaJacobi *j, Cuerpos *c, Particulas *p, double dt) {
+    int n = j->num_cuerpos, r = raiz(j), i, k, q;
+
+    // De cartesianas a Jacobi
+    centrosDeMasas(j, c);
+    for (k = 0; k < j->num_nodos; k++) {
+        int a = j->hijo_a[k], b = j->hijo_b[k];
+        j->rx[k] = j->x[b] - j->x[a];
+        j->ry[k] = j->y[b] - j->y[a];
+        j->rvx[k] = j->vx[b] - j->vx[a];
+        j->rvy[k] = j->vy[b] - j->vy[a];
+    }
+    #pragma omp parallel for if (p->num >= UMBRAL_PARALELO)
+    for (q = 0; q < p->num; q++) {
+        int e = j->nodo_particula[q];
+        p->x[q] -= j->x[e];
+        p->y[q] -= j->y[e];
+        p->vx[q] -= j->vx[e];
+        p->vy[q] -= j->vy[e];
+    }
+
+    // Cada vector de Jacobi por su órbita de Kepler (masa del nodo: m_A + m_B)
+    // y el centro de masas del sistema en línea recta
+    #pragma omp parallel for schedule(dynamic, 16) if (j->num_nodos >= UMBRAL_PARALELO)
+    for (k = 0; k < j->num_nodos; k++) {
+        derivaKepler(j->masa[n + k], dt, &j->rx[k], &j->ry[k], &j->rvx[k], &j->rvy[k]);
+    }
+    j->x[r] += j->vx[r] * dt;
+    j->y[r] += j->vy[r] * dt;
+
+    // De Jacobi a cartesianas, de la raíz a las hojas
+    for (k = j->num_nodos - 1; k >= 0; k--) {
+        int e = n + k, a = j->hijo_a[k], b = j->hijo_b[k];
+        double fa = j->masa[b] / j->masa[e], fb = j->masa[a] / j->masa[e];
+        j->x[a] = j->x[e] - fa * j->rx[k];
+        j->y[a] = j->y[e] - fa * j->ry[k];
+        j->vx[a] = j->vx[e] - fa * j->rvx[k];
+        j->vy[a] = j->vy[e] - fa * j->rvy[k];
+        j->x[b] = j->x[e] + fb * j->rx[k];
+        j->y[b] = j->y[e] + fb * j->ry[k];
+        j->vx[b] = j->vx[e] + fb * j->rvx[k];
+        j->vy[b] = j->vy[e] + fb * j->rvy[k];
+    }
+    for (i = 0; i < n; i++) {
+        c->x[i] = j->x[i];
+        c->y[i] = j->y[i];
+        c->vx[i] = j->vx[i];
+        c->vy[i] = j->vy[i];
+    }
+
+    // Las partículas, por su órbita alrededor del subsistema que ya se ha movido
+    #pragma omp parallel for schedule(dynamic, 256) if (p->num >= UMBRAL_PARALELO)
+    for (q = 0; q < p->num; q++) {
+        int e = j->nodo_particula[q];
+        derivaKepler(j->masa[e], dt, &p->x[q], &p->y[q], &p->vx[q], &p->vy[q]);
+        p->x[q] += j->x[e];
+        p->y[q] += j->y[e];
+        p->vx[q] += j->vx[e];
+        p->vy[q] += j->vy[e];
+    }
+}
+
+void restarKepler(JerarquiaJacobi *j, Cuerpos *c, Particulas *p) {
+    int n = j->num_cuerpos, r = raiz(j), i, k, q;
+
+    // La parte de Kepler del nodo k atrae cada cuerpo de A hacia el centro de
+    // masas de B y al revés. Se acumula de la raíz a las hojas: cada
+    // elemento recibe la de todos los nodos que lo contienen.
+    centrosDeMasas(j, c);
+    j->kx[r] = 0.0;
+    j->ky[r] = 0.0;
+    for (k = j->num_nodos - 1; k >= 0; k--) {
+        int e = n + k, a = j->hijo_a[k], b = j->hijo_b[k];
+        double dx = j->x[b] - j->x[a], dy = j->y[b] - j->y[a];
+        double r2 = dx * dx + dy * dy, inversa3 = 1.0 / (r2 * sqrt(r2));
+        j->kx[a] = j->kx[e] + j->masa[b] * dx * inversa3;
+        j->ky[a] = j->ky[e] + j->masa[b] * dy * inversa3;
+        j->kx[b] = j->kx[e] - j->masa[a] * dx * inversa3;
+        j->ky[b] = j->ky[e] - j->masa[a] * dy * inversa3;
+    }
+    for (i = 0; i < n; i++) {
+        c->ax[i] -= j->kx[i];
+        c->ay[i] -= j->ky[i];
+    }
+
+    // Una partícula recibe lo mismo que su subsistema más la atracción de Kepler hacia él
+    #pragma omp parallel for if (p->num >= UMBRAL_PARALELO)
+    for (q = 0; q < p->num; q++) {
+        int e = j->nodo_particula[q];
+        double dx = p->x[q] - j->x[e], dy = p->y[q] - j->y[e];
+        double r2 = dx * dx + dy * dy, inversa3 = 1.0 / (r2 * sqrt(r2));
+        p->ax[q] -= j->kx[e] - j->masa[e] * dx * inversa3;
+        p->ay[q] -= j->ky[e] - j->masa[e] * dy * inversa3;
+    }
+}
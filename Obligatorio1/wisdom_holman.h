@@ -0,0 +1,70 @@
+#ifndef WISDOM_HOLMAN_H
+#define WISDOM_HOLMAN_H
+
+#include "cuerpos.h"
+
+// Mapa de Wisdom y Holman en coordenadas de Jacobi jerárquicas. Cada cuerpo
+// orbita un anfitrión: el cuerpo más pequeño (pero más masivo que él) en
+// cuya esfera de Hill está, o el cuerpo central (el más masivo) si no está
+// en ninguna. Los satélites de un anfitrión se encadenan de dentro afuera,
+// como en las coordenadas de Jacobi de siempre, así que queda un árbol
+// binario: cada nodo une un subsistema interior A (el que tiene el
+// anfitrión) con el subsistema B que lo orbita, y su vector de Jacobi es el
+// de centro de masas de A a centro de masas de B. Con eso
+//
+//     H = sum_nodos [mu_k v_k^2 / 2 - m_A m_B / r_k] + P^2 / 2M + H_interaccion
+//
+// La primera parte son problemas de Kepler independientes, que se avanzan
+// exactamente (deriva); la interacción, lo que queda de la gravedad, es
+// pequeña y solo depende de las posiciones (patada). Las lunas de Júpiter
+// orbitan Júpiter y la Luna la Tierra, así que el paso ya no lo limita la
+// gravedad del planeta sobre sus lunas, sino lo que se aparta cada órbita de
+// una elipse.
+//
+// Las partículas de prueba (sin masa) orbitan el subsistema de su
+// anfitrión con los satélites que están más cerca que ellas.
+
+typedef struct {
+    int num_cuerpos, num_particulas;
+
+    // Lo que define la jerarquía, en un solo vector para guardarlo en el
+    // punto de control: anfitrion[num_cuerpos] (-1 el central),
+    // orden[num_cuerpos] (los cuerpos por distancia a su anfitrión al
+    // empezar) y nodo_particula[num_particulas] (el elemento que orbita cada partícula)
+    int *definicion;
+    int *anfitrion, *orden, *nodo_particula;
+
+    // El árbol: los elementos 0..num_cuerpos-1 son los cuerpos y los
+    // siguientes los nodos, cada uno después de sus dos hijos (la raíz, el último)
+    int num_nodos;
+    int *hijo_a, *hijo_b;
+    double *masa;              // Masa de cada elemento (la del subsistema, para los nodos)
+    double *x, *y, *vx, *vy;   // Centro de masas de cada elemento
+    double *kx, *ky;           // Aceleración de Kepler que reciben los cuerpos de cada elemento
+    double *rx, *ry, *rvx, *rvy; // Vector de Jacobi de cada nodo
+} JerarquiaJacobi;
+
+// Número de enteros de definicion para n cuerpos y np partículas
+int enterosJerarquiaJacobi(int num_cuerpos, int num_particulas);
+
+// Construye la jerarquía. Con definicion = NULL se eligen los anfitriones
+// con las posiciones actuales; si no, se copia la definición (la de un punto
+// de control), así que la jerarquía es la misma que al empezar. Devuelve 0
+// si todo va bien.
+int crearJerarquiaJacobi(JerarquiaJacobi *j, const Cuerpos *c, const Particulas *p, const int *definicion);
+void liberarJerarquiaJacobi(JerarquiaJacobi *j);
+
+// Deriva: cada vector de Jacobi avanza dt por su órbita de Kepler y el
+// centro de masas del sistema en línea recta
+void derivaJacobi(JerarquiaJacobi *j, Cuerpos *c, Particulas *p, double dt);
+
+// Quita de c->ax, c->ay (y p->ax, p->ay), que tienen la gravedad completa, la
+// parte de Kepler: deja la aceleración de la interacción
+void restarKepler(JerarquiaJacobi *j, Cuerpos *c, Particulas *p);
+
+// Avanza dt el problema de Kepler de (x, y, vx, vy) alrededor de una masa mu
+// fija en el origen (G = 1), con variables universales: vale para órbitas
+// elípticas, parabólicas e hiperbólicas
+void derivaKepler(double mu, double dt, double *x, double *y, double *vx, double *vy);
+
+#endif
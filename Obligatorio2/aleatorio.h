@@ -0,0 +1,108 @@
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+#include <stdint.h>
+#include <string.h>
+#include "philox.h"
+
+// Generador de números aleatorios de cada hilo, basado en Philox4x32-10.
+// El flujo queda fijado por (semilla, hilo, réplica): la semilla es la clave
+// y hilo y réplica ocupan las dos palabras altas del contador, de modo que
+// dos flujos distintos nunca comparten bloques. Las dos palabras bajas
+// cuentan los bloques, que se generan de PHILOX_BLOQUES en PHILOX_BLOQUES.
+typedef struct {
+    uint32_t clave[2];
+    uint32_t contador[4];
+    uint32_t buffer[4 * PHILOX_BLOQUES];
+    int posicion;             // Siguiente palabra sin usar del buffer
+} GeneradorHilo;
+
+// Flujo reservado para inicializar redes (no coincide con ningún hilo)
+#define FLUJO_INICIALIZACION 0xFFFFFFFFu
+
+// Mezcla splitmix64: convierte un entero en otro bien distribuido (se usa
+// como función hash, por ejemplo para decidir la inversión de un cluster)
+static inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Flujo (semilla, hilo, replica)
+static inline void inicializarGeneradorFlujo(GeneradorHilo *g, uint64_t semilla, uint32_t hilo, uint32_t replica) {
+    g->clave[0] = (uint32_t)semilla;
+    g->clave[1] = (uint32_t)(semilla >> 32);
+    g->contador[0] = 0;
+    g->contador[1] = 0;
+    g->contador[2] = hilo;
+    g->contador[3] = replica;
+    g->posicion = 4 * PHILOX_BLOQUES; // Buffer vacío: se llena en la primera llamada
+}
+
+// Flujo de un hilo (réplica 0)
+static inline void inicializarGeneradorHilo(GeneradorHilo *g, uint64_t semilla, int hilo) {
+    inicializarGeneradorFlujo(g, semilla, (uint32_t)hilo, 0);
+}
+
+// Calcula los siguientes PHILOX_BLOQUES bloques del flujo
+static inline void rellenarGenerador(GeneradorHilo *g) {
+    philox4x32Bloques(g->contador, g->clave, g->buffer);
+    uint32_t anterior = g->contador[0];
+    g->contador[0] += PHILOX_BLOQUES;
+    g->contador[1] += g->contador[0] < anterior;
+    g->posicion = 0;
+}
+
+static inline uint32_t siguienteAleatorio32(GeneradorHilo *g) {
+    if (g->posicion == 4 * PHILOX_BLOQUES) {
+        rellenarGenerador(g);
+    }
+    return g->buffer[g->posicion++];
+}
+
+static inline uint64_t siguienteAleatorio(GeneradorHilo *g) {
+    uint64_t alto = siguienteAleatorio32(g);
+    return (alto << 32) | siguienteAleatorio32(g);
+}
+
+// Copia en destino los siguientes 'cantidad' números de 32 bits del flujo
+// (los mismos que darían 'cantidad' llamadas a siguienteAleatorio32)
+static inline void rellenarAleatorios32(GeneradorHilo *g, uint32_t *destino, int cantidad) {
+    while (cantidad > 0) {
+        if (g->posicion == 4 * PHILOX_BLOQUES) {
+            rellenarGenerador(g);
+        }
+        int copiar = 4 * PHILOX_BLOQUES - g->posicion;
+        if (copiar > cantidad) {
+            copiar = cantidad;
+        }
+        memcpy(destino, g->buffer + g->posicion, copiar * sizeof(uint32_t));
+        g->posicion += copiar;
+        destino += copiar;
+        cantidad -= copiar;
+    }
+}
+
+// Número uniforme en [0, 1) con 53 bits
+static inline double aleatorioUniforme(GeneradorHilo *g) {
+    return (siguienteAleatorio(g) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Entero uniforme en [0, limite) sin el sesgo de rand() % limite (método de
+// Lemire): se multiplica por el límite y se queda la parte alta; solo se
+// repite cuando la parte baja cae en la zona sesgada, lo que casi nunca pasa.
+static inline uint32_t aleatorioEntero(GeneradorHilo *g, uint32_t limite) {
+    uint64_t producto = (uint64_t)siguienteAleatorio32(g) * limite;
+    uint32_t bajo = (uint32_t)producto;
+    if (bajo < limite) {
+        uint32_t umbral = (0u - limite) % limite;
+        while (bajo < umbral) {
+            producto = (uint64_t)siguienteAleatorio32(g) * limite;
+            bajo = (uint32_t)producto;
+        }
+    }
+    return (uint32_t)(producto >> 32);
+}
+
+#endif
@@ -31,6 +31,12 @@
 # El programa asume que las dimensiones del retículo no cambian a lo
 # largo del tiempo.
 # 
+# También se puede leer el formato binario que escriben ising.c e
+# isignencplusplus.cpp (fichero .bin, ver trayectoria.h): una cabecera de
+# 64 bytes y después un bit por espín en cada fotograma. El fichero se
+# proyecta en memoria (np.memmap) y solo se desempaqueta el fotograma que
+# se está dibujando.
+#
 # Si solo se especifica un instante de tiempo, se genera una imagen en pdf
 # en lugar de una animación
 #
@@ -44,10 +50,11 @@ from matplotlib import pyplot as plt
 from matplotlib.animation import FuncAnimation
 import numpy as np
 import io
+import os
 
 # Parámetros
 # ========================================
-file_in = "matriz_red.txt" # Nombre del fichero de datos
+file_in = "matriz_red.bin" # Nombre del fichero de datos (.bin binario o .txt de texto)
 file_out = "animacion_ising. T=1.0" # Nombre del fichero de salida (sin extensión)
 interval = 100 # Tiempo entre fotogramas en milisegundos
 save_to_file = True # False: muestra la animación por pantalla,
@@ -57,25 +64,75 @@ dpi = 150 # Calidad del vídeo de salida (dots per inch)
 
 # Lectura del fichero de datos
 # ========================================
-# Lee el fichero a una cadena de texto
-with open(file_in, "r") as f:
-    data_str = f.read()
-
-# Inicializa la lista con los datos de cada fotograma.
-# frames_data[j] contiene los datos del fotograma j-ésimo
-frames_data = list()
-
-# Itera sobre los bloques de texto separados por líneas vacías
-# (cada bloque corresponde a un instante de tiempo)
-for frame_data_str in data_str.split("\n\n"):
-    # Almacena el bloque en una matriz
-    # (io.StringIO permite leer una cadena de texto como si fuera un
-    # fichero, lo que nos permite usar la función loadtxt de numpy)
-    frame_data = np.loadtxt(io.StringIO(frame_data_str), delimiter=",")
-
-    # Añade los datos del fotograma (la configuración del sistema)
-    # a la lista
-    frames_data.append(frame_data)
+# Cabecera del formato binario (64 bytes, little-endian), igual que
+# CabeceraTrayectoria en trayectoria.h
+cabecera_dtype = np.dtype([
+    ("magia", "S8"),
+    ("version", "<u4"),
+    ("n", "<u4"),
+    ("fotogramas", "<u8"),
+    ("bytes_fotograma", "<u8"),
+    ("temperatura", "<f8"),
+    ("semilla", "<u8"),
+    ("reservado", "u1", 16),
+])
+
+
+class TrayectoriaBinaria:
+    """Acceso por índice a los fotogramas de un fichero .bin sin leerlo entero."""
+
+    def __init__(self, ruta):
+        cabecera = np.fromfile(ruta, dtype=cabecera_dtype, count=1)[0]
+        if cabecera["magia"] != b"ISINGBIN" or cabecera["version"] != 1:
+            raise ValueError("{} no es una trayectoria binaria de Ising".format(ruta))
+        self.n = int(cabecera["n"])
+        self.temperatura = float(cabecera["temperatura"])
+        self.semilla = int(cabecera["semilla"])
+        bytes_fotograma = int(cabecera["bytes_fotograma"])
+
+        # Si el programa no cerró el fichero, la cabecera dice 0 fotogramas:
+        # se usan los que caben completos en el fichero
+        tamano = os.path.getsize(ruta)
+        completos = (tamano - cabecera_dtype.itemsize) // bytes_fotograma
+        fotogramas = int(cabecera["fotogramas"])
+        if fotogramas == 0 or fotogramas > completos:
+            fotogramas = completos
+
+        self.datos = np.memmap(ruta, dtype=np.uint8, mode="r",
+                               offset=cabecera_dtype.itemsize,
+                               shape=(fotogramas, bytes_fotograma))
+
+    def __len__(self):
+        return self.datos.shape[0]
+
+    def __getitem__(self, j):
+        # Bit k % 8 del byte k / 8 es el espín k = i * n + j (1 -> +1, 0 -> -1)
+        bits = np.unpackbits(self.datos[j], bitorder="little")[: self.n * self.n]
+        return bits.reshape(self.n, self.n).astype(np.int8) * 2 - 1
+
+
+if file_in.endswith(".bin"):
+    frames_data = TrayectoriaBinaria(file_in)
+else:
+    # Lee el fichero a una cadena de texto
+    with open(file_in, "r") as f:
+        data_str = f.read()
+
+    # Inicializa la lista con los datos de cada fotograma.
+    # frames_data[j] contiene los datos del fotograma j-ésimo
+    frames_data = list()
+
+    # Itera sobre los bloques de texto separados por líneas vacías
+    # (cada bloque corresponde a un instante de tiempo)
+    for frame_data_str in data_str.strip("\n").split("\n\n"):
+        # Almacena el bloque en una matriz
+        # (io.StringIO permite leer una cadena de texto como si fuera un
+        # fichero, lo que nos permite usar la función loadtxt de numpy)
+        frame_data = np.loadtxt(io.StringIO(frame_data_str), delimiter=",")
+
+        # Añade los datos del fotograma (la configuración del sistema)
+        # a la lista
+        frames_data.append(frame_data)
 
 # Creación de la animación/gráfico
 # ========================================
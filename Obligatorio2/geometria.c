@@ -0,0 +1,253 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "geometria.h"
+
+// Lado de los bloques en que se recorre la red al hacer las listas de colores
+#define BLOQUE_2D 32
+#define BLOQUE_3D 8
+
+// Extensión de la red en z (1 en 2D)
+static int ladoZ(const Geometria *g) {
+    return (g->dimension == 3) ? g->lado : 1;
+}
+
+// Índice del sitio (x, y, z), o del fantasma si se sale de una red abierta
+static int32_t indiceSitio(const Geometria *g, int x, int y, int z) {
+    int lado = g->lado, lado_z = ladoZ(g);
+    if (x < 0 || x >= lado || y < 0 || y >= lado || z < 0 || z >= lado_z) {
+        if (g->contorno == CONTORNO_ABIERTO) {
+            return g->num_sitios;
+        }
+        x = (x + lado) % lado;
+        y = (y + lado) % lado;
+        z = (z + lado_z) % lado_z;
+    }
+    return ((int32_t)x * lado + y) * lado_z + z;
+}
+
+// Color del sitio: dos vecinos nunca tienen el mismo
+static int colorSitio(const Geometria *g, int x, int y, int z) {
+    if (g->tipo == GEOMETRIA_TRIANGULAR) {
+        return (x + 2 * y) % 3;
+    }
+    return (x + y + z) % 2;
+}
+
+// Desplazamientos de los vecinos del sitio (x, y). En el panal el tercer
+// vecino está abajo o arriba según la paridad de x + y.
+static int desplazamientos(const Geometria *g, int x, int y, int d[MAXIMA_COORDINACION][3]) {
+    static const int cuadrada[4][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}};
+    static const int triangular[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {-1, 1, 0}, {1, -1, 0}};
+    static const int cubica[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    switch (g->tipo) {
+    case GEOMETRIA_CUADRADA:
+        memcpy(d, cuadrada, sizeof(cuadrada));
+        return 4;
+    case GEOMETRIA_TRIANGULAR:
+        memcpy(d, triangular, sizeof(triangular));
+        return 6;
+    case GEOMETRIA_PANAL:
+        memcpy(d, cuadrada + 2, 2 * sizeof(cuadrada[0]));
+        d[2][0] = ((x + y) % 2 == 0) ? 1 : -1;
+        d[2][1] = d[2][2] = 0;
+        return 3;
+    case GEOMETRIA_CUBICA:
+        memcpy(d, cubica, sizeof(cubica));
+        return 6;
+    }
+    return 0;
+}
+
+int crearGeometria(Geometria *g, TipoGeometria tipo, TipoContorno contorno, int lado) {
+    int x, y, z, c, v;
+    memset(g, 0, sizeof(*g));
+    g->tipo = tipo;
+    g->contorno = contorno;
+    g->lado = lado;
+    g->dimension = (tipo == GEOMETRIA_CUBICA) ? 3 : 2;
+    g->num_colores = (tipo == GEOMETRIA_TRIANGULAR) ? 3 : 2;
+
+    // Con contorno periódico el coloreado tiene que cerrar al dar la vuelta
+    if (lado < 2 || (contorno == CONTORNO_PERIODICO && lado % g->num_colores != 0)) {
+        return 1;
+    }
+    int lado_z = ladoZ(g);
+    g->num_sitios = lado * lado * lado_z;
+
+    // Cada fila de la tabla tiene siempre MAXIMA_COORDINACION vecinos (los
+    // que sobran son el fantasma): el bucle del barrido tiene una longitud
+    // fija y el compilador lo desenrolla
+    g->vecinos = malloc((size_t)g->num_sitios * MAXIMA_COORDINACION * sizeof(int32_t));
+    for (c = 0; c < g->num_colores; c++) {
+        g->sitios_color[c] = malloc((size_t)g->num_sitios * sizeof(int32_t));
+    }
+    for (c = 0; c < g->num_colores; c++) {
+        if (g->vecinos == NULL || g->sitios_color[c] == NULL) {
+            liberarGeometria(g);
+            return 1;
+        }
+    }
+
+    for (x = 0; x < lado; x++) {
+        for (y = 0; y < lado; y++) {
+            for (z = 0; z < lado_z; z++) {
+                int d[MAXIMA_COORDINACION][3];
+                int32_t *fila = g->vecinos + (size_t)indiceSitio(g, x, y, z) * MAXIMA_COORDINACION;
+                g->coordinacion = desplazamientos(g, x, y, d);
+                for (v = 0; v < MAXIMA_COORDINACION; v++) {
+                    fila[v] = (v < g->coordinacion) ? indiceSitio(g, x + d[v][0], y + d[v][1], z + d[v][2])
+                                                    : g->num_sitios;
+                }
+            }
+        }
+    }
+
+    // Listas de colores recorriendo la red por bloques
+    int bloque = (g->dimension == 3) ? BLOQUE_3D : BLOQUE_2D;
+    int bloque_z = (g->dimension == 3) ? BLOQUE_3D : 1;
+    int bx, by, bz;
+    for (bx = 0; bx < lado; bx += bloque) {
+        for (by = 0; by < lado; by += bloque) {
+            for (bz = 0; bz < lado_z; bz += bloque_z) {
+                for (x = bx; x < bx + bloque && x < lado; x++) {
+                    for (y = by; y < by + bloque && y < lado; y++) {
+                        for (z = bz; z < bz + bloque_z && z < lado_z; z++) {
+                            c = colorSitio(g, x, y, z);
+                            g->sitios_color[c][g->num_sitios_color[c]++] = indiceSitio(g, x, y, z);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+void liberarGeometria(Geometria *g) {
+    int c;
+    free(g->vecinos);
+    g->vecinos = NULL;
+    for (c = 0; c < MAXIMO_COLORES; c++) {
+        free(g->sitios_color[c]);
+        g->sitios_color[c] = NULL;
+    }
+}
+
+int8_t *crearEspinesGeometria(const Geometria *g) {
+    int8_t *espines = malloc((size_t)g->num_sitios + 1);
+    if (espines != NULL) {
+        memset(espines, 1, g->num_sitios);
+        espines[g->num_sitios] = 0; // El fantasma no suma nunca
+    }
+    return espines;
+}
+
+void inicializarEspinesGeometria(const Geometria *g, int8_t *espines, int sesgo, GeneradorHilo *generador) {
+    int k;
+    for (k = 0; k < g->num_sitios; k++) {
+        espines[k] = ((int)aleatorioEntero(generador, 100) < sesgo) ? 1 : -1;
+    }
+    espines[g->num_sitios] = 0;
+}
+
+// Suma de los vecinos del sitio k
+static inline int campoLocal(const int32_t *vecinos, const int8_t *espines, int32_t k) {
+    const int32_t *v = vecinos + (size_t)k * MAXIMA_COORDINACION;
+    int h = 0, w;
+    for (w = 0; w < MAXIMA_COORDINACION; w++) {
+        h += espines[v[w]];
+    }
+    return h;
+}
+
+double energiaGeometria(const Geometria *g, const int8_t *espines) {
+    long doble = 0;
+    int32_t k;
+    // Cada enlace aparece dos veces (una desde cada extremo)
+    #pragma omp parallel for reduction(+:doble) schedule(static)
+    for (k = 0; k < g->num_sitios; k++) {
+        doble += espines[k] * campoLocal(g->vecinos, espines, k);
+    }
+    return -(double)(doble / 2);
+}
+
+long magnetizacionGeometria(const Geometria *g, const int8_t *espines) {
+    long magnetizacion = 0;
+    int32_t k;
+    for (k = 0; k < g->num_sitios; k++) {
+        magnetizacion += espines[k];
+    }
+    return magnetizacion;
+}
+
+void barridoGeometria(const Geometria *g, int8_t *espines, double beta, GeneradorHilo generadores[],
+                      double *energia, long *magnetizacion) {
+    int z = g->coordinacion, c, k;
+    long delta_energia = 0, delta_magnetizacion = 0;
+    // Probabilidad de aceptación para cada s * h entre -z y z, con índice s * h + z
+    double tabla[2 * MAXIMA_COORDINACION + 1];
+
+    for (k = 0; k <= 2 * z; k++) {
+        double deltaE = 2.0 * (k - z);
+        tabla[k] = (deltaE <= 0) ? 1.0 : exp(-beta * deltaE);
+    }
+
+    for (c = 0; c < g->num_colores; c++) {
+        const int32_t *sitios = g->sitios_color[c];
+        int num = g->num_sitios_color[c];
+
+        // schedule(static): con los mismos hilos y la misma semilla, el mismo resultado
+        #pragma omp parallel reduction(+:delta_energia, delta_magnetizacion)
+        {
+            GeneradorHilo *generador = &generadores[omp_get_thread_num()];
+            int m;
+
+            #pragma omp for schedule(static)
+            for (m = 0; m < num; m++) {
+                int32_t sitio = sitios[m];
+                int s = espines[sitio];
+                int h = campoLocal(g->vecinos, espines, sitio);
+                int acepta = aleatorioUniforme(generador) < tabla[s * h + z];
+                delta_energia += acepta * 2 * s * h;
+                delta_magnetizacion -= acepta * 2 * s;
+                espines[sitio] = (int8_t)(s * (1 - 2 * acepta));
+            }
+        }
+    }
+
+    *energia += delta_energia;
+    *magnetizacion += delta_magnetizacion;
+}
+
+static const char *const NOMBRES_GEOMETRIAS[] = {"cuadrada", "triangular", "panal", "cubica"};
+static const char *const NOMBRES_CONTORNOS[] = {"periodico", "abierto"};
+
+const char *nombreGeometria(TipoGeometria tipo) {
+    return NOMBRES_GEOMETRIAS[tipo];
+}
+
+int geometriaPorNombre(const char *nombre) {
+    int k;
+    for (k = 0; k < 4; k++) {
+        if (strcmp(NOMBRES_GEOMETRIAS[k], nombre) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+const char *nombreContorno(TipoContorno contorno) {
+    return NOMBRES_CONTORNOS[contorno];
+}
+
+int contornoPorNombre(const char *nombre) {
+    int k;
+    for (k = 0; k < 2; k++) {
+        if (strcmp(NOMBRES_CONTORNOS[k], nombre) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,74 @@
+#ifndef GEOMETRIA_H
+#define GEOMETRIA_H
+
+#include <stdint.h>
+#include "aleatorio.h"
+
+// Modelo de Ising sobre una red cualquiera descrita por una tabla de
+// vecinos calculada al empezar: el sitio k tiene como vecinos los sitios
+// vecinos[k * MAXIMA_COORDINACION + v], v = 0 .. coordinacion - 1. El barrido solo
+// lee la tabla, así que es el mismo para todas las geometrías y no tiene
+// condiciones de contorno. Con contorno abierto los vecinos que faltan
+// apuntan al sitio num_sitios, un espín fantasma que vale siempre 0.
+//
+// Los sitios se numeran k = (x * lado + y) * lado + z en 3D y k = x * lado + y
+// en 2D. Cada geometría se colorea de modo que dos vecinos nunca tengan el
+// mismo color, y los sitios de un color se actualizan a la vez (como el
+// tablero de ajedrez de ising.c). La lista de cada color recorre la red por
+// bloques para que los vecinos sigan en la caché.
+typedef enum {
+    GEOMETRIA_CUADRADA,   // 4 vecinos, 2 colores
+    GEOMETRIA_TRIANGULAR, // 6 vecinos (la cuadrada con la diagonal (x-1, y+1)), 3 colores
+    GEOMETRIA_PANAL,      // 3 vecinos (panal de abeja como pared de ladrillos), 2 colores
+    GEOMETRIA_CUBICA      // 6 vecinos en 3D, 2 colores
+} TipoGeometria;
+
+typedef enum {
+    CONTORNO_PERIODICO,
+    CONTORNO_ABIERTO
+} TipoContorno;
+
+#define MAXIMO_COLORES 3
+#define MAXIMA_COORDINACION 6
+
+typedef struct {
+    TipoGeometria tipo;
+    TipoContorno contorno;
+    int lado;                       // Sitios por lado
+    int dimension;                  // 2 o 3
+    int num_sitios;                 // lado^dimension
+    int coordinacion;               // Vecinos de cada sitio
+    int32_t *vecinos;               // num_sitios * MAXIMA_COORDINACION índices
+    int num_colores;
+    int num_sitios_color[MAXIMO_COLORES];
+    int32_t *sitios_color[MAXIMO_COLORES]; // Sitios de cada color, por bloques
+} Geometria;
+
+// Construye la tabla de vecinos. Con contorno periódico el coloreado exige
+// lado par (lado múltiplo de 3 en la triangular). Devuelve 0 si todo va bien.
+int crearGeometria(Geometria *g, TipoGeometria tipo, TipoContorno contorno, int lado);
+void liberarGeometria(Geometria *g);
+
+// Reserva los espines de la geometría (num_sitios + 1, con el fantasma a 0)
+int8_t *crearEspinesGeometria(const Geometria *g);
+
+// Espines aleatorios con un 'sesgo' por ciento de +1
+void inicializarEspinesGeometria(const Geometria *g, int8_t *espines, int sesgo, GeneradorHilo *generador);
+
+// Energía (cada enlace una vez, J = 1) y magnetización totales
+double energiaGeometria(const Geometria *g, const int8_t *espines);
+long magnetizacionGeometria(const Geometria *g, const int8_t *espines);
+
+// Un paso Monte Carlo de Metropolis: los colores uno detrás de otro, cada
+// uno repartido entre los hilos con un generador por hilo. energia y
+// magnetizacion se actualizan con cada inversión aceptada.
+void barridoGeometria(const Geometria *g, int8_t *espines, double beta, GeneradorHilo generadores[],
+                      double *energia, long *magnetizacion);
+
+// Nombres ("cuadrada", "periodico"...) y lo contrario (-1 si no existe)
+const char *nombreGeometria(TipoGeometria tipo);
+int geometriaPorNombre(const char *nombre);
+const char *nombreContorno(TipoContorno contorno);
+int contornoPorNombre(const char *nombre);
+
+#endif
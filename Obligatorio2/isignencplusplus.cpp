@@ -1,28 +1,42 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
-#include <random> // Para std::philox_engine
+#include <random> // Para std::random_device
 #include <ctime>
+#include "nucleo_ising.hpp"
+#include "trayectoria.h"
+#include "registro_inversiones.h"
+#include "aleatorio.h" // Philox4x32-10 (philox.h), compartido con ising.c
+
+// Compilación: gcc -O3 -c trayectoria.c registro_inversiones.c &&
+//              g++ -O3 isignencplusplus.cpp trayectoria.o registro_inversiones.o -o ising
 
 using namespace std;
 
 // Constantes
 const int N = 10;          // Tamaño de la red (N x N)
-const int ITERACIONES = 100000; // Número de iteraciones
+const int ITERACIONES = 100000; // Número de intentos de inversión (ITERACIONES / (N * N) barridos)
 const double T = 0.0001;
 const double K_BOLTZMANN = 1.0; // Constante de Boltzmann (J/K)
+const bool GUARDAR_TEXTO = false; // true: guarda además matriz_red.txt en formato de texto (mucho más lento)
+const int INTERVALO_CLAVES = 10000; // Intentos entre redes clave del registro de inversiones
+
+// Modos de salida
+const int SALIDA_FOTOGRAMAS = 1; // Red completa tras cada intento (matriz_red.bin)
+const int SALIDA_REGISTRO = 2;   // Red inicial y solo las inversiones aceptadas (registro_red.bin)
 
 // Inicializar el generador de números aleatorios
+// (std::philox_engine es de C++26 y nuestros compiladores no lo tienen)
 std::random_device rd; // Semilla aleatoria
-std::philox_engine<uint64_t, 10, 256> rng(rd()); // Motor Philox
-std::uniform_real_distribution<double> uniform_dist(0.0, 1.0); // Distribución uniforme [0, 1]
+uint64_t semilla = (static_cast<uint64_t>(rd()) << 32) | rd(); // Se guarda en la cabecera de la trayectoria
+GeneradorHilo rng; // Flujo Philox (semilla, hilo 0, réplica 0)
 
 // Función para inicializar la red con espines aleatorios (+1 o -1)
 void inicializarRed(int red[N][N], int sesgo) {
     for (int i = 0; i < N; i++) {
         for (int j = 0; j < N; j++) {
-            // Generar un número aleatorio entre 0 y 99
-            int probabilidad = static_cast<int>(uniform_dist(rng) * 100);
+            // Generar un número aleatorio entre 0 y 99 (sin sesgo de módulo)
+            int probabilidad = static_cast<int>(aleatorioEntero(&rng, 100));
             // Asignar +1 si está dentro del porcentaje de sesgo, -1 en caso contrario
             red[i][j] = (probabilidad < sesgo) ? 1 : -1;
         }
@@ -53,45 +67,67 @@ void guardarRed(ofstream &archivo, int red[N][N]) {
 }
 
 // Algoritmo de Monte Carlo para el modelo de Ising
-void monteCarloIsing(int red[N][N], double beta, int iteraciones) {
-    ofstream archivo("matriz_red.txt");
-    if (!archivo.is_open()) {
+void monteCarloIsing(int red[N][N], double beta, int iteraciones, int salida) {
+    double temperatura = 1.0 / (K_BOLTZMANN * beta);
+
+    // Trayectoria binaria con un bit por espín (ver trayectoria.h)
+    EscritorTrayectoria trayectoria;
+    // Registro de inversiones: O(1) por intento en lugar de O(N^2) (ver registro_inversiones.h)
+    EscritorRegistro registro;
+    int error;
+    if (salida == SALIDA_REGISTRO) {
+        error = abrirRegistroEscritura(&registro, "registro_red.bin", N, &red[0][0], INTERVALO_CLAVES, temperatura, semilla);
+    } else {
+        error = abrirTrayectoriaEscritura(&trayectoria, "matriz_red.bin", N, temperatura, semilla);
+    }
+    if (error != 0) {
         cerr << "Error al abrir el archivo para guardar la red." << endl;
         exit(1);
     }
 
-    for (int i = 0; i < iteraciones; i++) {
-        // Elegir un espín aleatorio en la red
-        int n = static_cast<int>(uniform_dist(rng) * N);
-        int m = static_cast<int>(uniform_dist(rng) * N);
-
-        // Calcular los vecinos con condiciones de contorno periódicas
-        int arriba = (n == 0) ? red[N - 1][m] : red[n - 1][m];
-        int abajo = (n == N - 1) ? red[0][m] : red[n + 1][m];
-        int izquierda = (m == 0) ? red[n][N - 1] : red[n][m - 1];
-        int derecha = (m == N - 1) ? red[n][0] : red[n][m + 1];
-
-        // Calcular el cambio de energía cuando se invierte el espín
-        int suma_vecinos = arriba + abajo + izquierda + derecha;
-        double deltaE = 2 * red[n][m] * suma_vecinos;
-
-        // Calcular la probabilidad de transición
-        double probabilidad = exp(-beta * deltaE);
-        if (probabilidad > 1.0) {
-            probabilidad = 1.0;
+    ofstream archivo;
+    if (GUARDAR_TEXTO) {
+        archivo.open("matriz_red.txt");
+        if (!archivo.is_open()) {
+            cerr << "Error al abrir el archivo para guardar la red." << endl;
+            exit(1);
         }
+    }
 
-        // Generar un número aleatorio con probabilidad uniforme entre 0 y 1 para decidir si aceptar el cambio
-        double r = uniform_dist(rng);
-        if (r < probabilidad) {
-            red[n][m] *= -1; // Si se acepta el cambio, invertir el signo del espín
+    // Núcleo especializado para esta red: tabla de aceptación calculada una sola vez
+    NucleoIsing<N, Contorno::Periodico> nucleo(beta);
+    auto uniforme = [] { return aleatorioUniforme(&rng); };
+
+    // Guardar la red (o solo la inversión) después de cada intento
+    auto guardarIntento = [&](int sitio, bool aceptado) {
+        int error_intento;
+        if (salida == SALIDA_REGISTRO) {
+            error_intento = registrarPaso(&registro, aceptado ? sitio : -1, &red[0][0]);
+        } else {
+            error_intento = escribirFotograma(&trayectoria, &red[0][0]);
+        }
+        if (error_intento != 0) {
+            cerr << "Error al escribir la trayectoria." << endl;
+            exit(1);
+        }
+        if (GUARDAR_TEXTO) {
+            guardarRed(archivo, red);
         }
+    };
 
-        // Guardar la red en el archivo después de cada iteración
-        guardarRed(archivo, red);
+    // Barridos en tablero de ajedrez: el interior sin condiciones de contorno y después el borde
+    for (int b = 0; b < iteraciones / (N * N); b++) {
+        nucleo.barrido(red, uniforme, guardarIntento);
     }
 
-    archivo.close();
+    if (salida == SALIDA_REGISTRO) {
+        cerrarRegistroEscritura(&registro);
+    } else {
+        cerrarTrayectoriaEscritura(&trayectoria);
+    }
+    if (GUARDAR_TEXTO) {
+        archivo.close();
+    }
 }
 
 // Función para imprimir la red
@@ -106,9 +142,10 @@ void imprimirRed(int red[N][N]) {
 
 int main() {
     double beta = 1.0 / (K_BOLTZMANN * T); // Beta = 1 / (k_B * T)
+    inicializarGeneradorHilo(&rng, semilla, 0);
 
     int red[N][N];
-    int opcion, sesgo;
+    int opcion, sesgo, salida;
 
     // Solicitar al usuario cómo inicializar la red
     cout << "Seleccione cómo inicializar la red:" << endl;
@@ -134,12 +171,22 @@ int main() {
         inicializarRed(red, 50);
     }
 
+    // Solicitar el modo de salida
+    cout << "Seleccione la salida:" << endl;
+    cout << "1. Red completa tras cada intento (matriz_red.bin)" << endl;
+    cout << "2. Registro de inversiones aceptadas (registro_red.bin)" << endl;
+    cout << "Ingrese su opción (1 o 2): ";
+    if (!(cin >> salida) || (salida != SALIDA_FOTOGRAMAS && salida != SALIDA_REGISTRO)) {
+        cout << "Opción no válida. Guardando la red completa por defecto." << endl;
+        salida = SALIDA_FOTOGRAMAS;
+    }
+
     // Imprimir la configuración inicial
     cout << "Configuración inicial de la red:" << endl;
     imprimirRed(red);
 
     // Ejecutar el algoritmo de Monte Carlo
-    monteCarloIsing(red, beta, ITERACIONES);
+    monteCarloIsing(red, beta, ITERACIONES, salida);
 
     // Imprimir la configuración final
     cout << "\nConfiguración final de la red:" << endl;
@@ -1,48 +1,54 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h> // Required for log() and sqrt() functions
 #include <time.h>
-
-// Constantes
-#define N 200 // Tamaño de la red (N x N)
-#define pasosmontecarlo 100 
-#define T 3.0
-#define K_BOLTZMANN 1.0 // Constante de Boltzmann (J/K)
-
-// Función para inicializar la red con espines aleatorios (+1 o -1)
-void inicializarRed(int red[N][N], int sesgo) {
-    int i, j;
-    for (i = 0; i < N; i++) {
-        for (j = 0; j < N; j++) {
-            // Generar un número aleatorio entre 0 y 99 (ambos incluidos)
-            int probabilidad = rand() % 100;
-            // Asignar +1 si está dentro del porcentaje de sesgo, -1 en caso contrario
-            if (probabilidad < sesgo) {
-                red[i][j] = 1;
-            } else {
-                red[i][j] = -1;
-            }
-        }
-    }
-}
-
-// Función para inicializar la red de forma ordenada (+1 o -1)
-void inicializarRedOrdenada(int red[N][N], int valor) {
-    int i, j;
-    for (i = 0; i < N; i++) {
-        for (j = 0; j < N; j++) {
-            red[i][j] = valor; // Asigna el valor +1 o -1 a toda la red
-        }
-    }
-}
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h> // truncate() para recortar las salidas al continuar
+#include <omp.h> // OpenMP para el barrido en tablero de ajedrez
+#include "aleatorio.h"
+#include "red_ising.h"
+#include "simulacion_ising.h"
+#include "observables.h"
+#include "ising_templado.h"
+#include "ising_replicas.h"
+#include "ising_wang_landau.h"
+#include "trayectoria.h"
+#include "punto_control.h"
+#include "parametros_ising.h"
+
+// Compilación: gcc -O3 -march=native -fopenmp ising.c ising_multiespin.c ising_cluster.c ising_templado.c ising_simd.c observables.c red_ising.c trayectoria.c punto_control.c simulacion_ising.c geometria.c ising_nfold.c ising_replicas.c ising_wang_landau.c -o ising -lm
+// Uso: ./ising [tamaño de la red]  (por defecto N; par y al menos 2)
+//      ./ising --continuar         (sigue desde el último punto de control)
+
+// Constantes (N, T, K_BOLTZMANN, pasosmontecarlo y errorobjetivo están en parametros_ising.h)
+#define TAMANO_MAXIMO_IMPRESION 200 // Redes más grandes no se imprimen por pantalla
+#define GUARDAR_TEXTO 0 // 1: guarda además matriz_red.txt en el formato de texto (mucho más lento)
+#define intervalopuntocontrol 200 // Pasos entre puntos de control
+#define intervalofotogramas 1 // Pasos entre fotogramas de la trayectoria (y de matriz_red.txt)
+#define RUTA_PUNTO_CONTROL "punto_control_ising.bin"
+
+// Opciones del menú que no son un algoritmo de actualización (los
+// algoritmos, ALGORITMO_*, están en simulacion_ising.h)
+#define COMPROBAR_MULTIESPIN 4 // Comparación estadística del multiespín con el tablero de enteros
+#define TEMPLADO_PARALELO 7    // Réplicas a varias temperaturas con intercambios (ising_templado.c)
+#define REPLICAS_INDEPENDIENTES 11 // 64 réplicas por palabra a la misma temperatura (ising_replicas.c)
+#define WANG_LANDAU 12             // Densidad de estados g(E) por ventanas de energía (ising_wang_landau.c)
+
+#define intervaloajusteescalera 200 // Pasos entre reajustes de la escalera (unos 100 intercambios por pareja)
+#define intervalowanglandau 100     // Pasos de cada caminante entre comprobaciones de planitud e intercambios
+#define RUTA_DENSIDAD_ESTADOS "densidad_estados.txt"
 
 // Función para guardar la red en un archivo
-void guardarRed(FILE *archivo, int red[N][N]) {
+void guardarRed(FILE *archivo, const RedIsing *red) {
     int i, j;
-    for (i = 0; i < N; i++) {
-        for (j = 0; j < N; j++) {
-            fprintf(archivo, "%d", red[i][j]);
-            if (j < N - 1) {
+    for (i = 0; i < red->n; i++) {
+        const int8_t *fila = filaRed(red, i);
+        for (j = 0; j < red->n; j++) {
+            fprintf(archivo, "%d", fila[j]);
+            if (j < red->n - 1) {
                 fprintf(archivo, ","); // Separador entre columnas
             }
         }
@@ -51,178 +57,414 @@ void guardarRed(FILE *archivo, int red[N][N]) {
     fprintf(archivo, "\n"); // Línea en blanco para separar iteraciones
 }
 
-// Función para calcular la energía total del sistema
-double calcularEnergia(int red[N][N]) {
-    double energia = 0.0;
-    int i, j;
-    int arriba, abajo, izquierda, derecha;
-
-    for (i = 0; i < N; i++) {
-        for (j = 0; j < N; j++) {
-            // Condiciones de contorno periódicas
-            // Vecino de arriba
-            if (i == 0) {
-                arriba = red[N - 1][j]; // Si está en el borde superior, conecta con el último
-            } else {
-                arriba = red[i - 1][j];
-            }
-
-            // Vecino de abajo
-            if (i == N - 1) {
-                abajo = red[0][j]; // Si está en el borde inferior, conecta con el primero
-            } else {
-                abajo = red[i + 1][j];
-            }
-
-            // Vecino de la izquierda
-            if (j == 0) {
-                izquierda = red[i][N - 1]; // Si está en el borde izquierdo, conecta con el último
-            } else {
-                izquierda = red[i][j - 1];
-            }
-
-            // Vecino de la derecha
-            if (j == N - 1) {
-                derecha = red[i][0]; // Si está en el borde derecho, conecta con el primero
-            } else {
-                derecha = red[i][j + 1];
-            }
-
-            // Sumar las interacciones con los vecinos
-            energia += red[i][j] * (arriba + abajo + izquierda + derecha);
-        }
+// Abre un fichero de salida de texto. Al continuar desde un punto de control
+// se recorta a los bytes que tenía entonces y se sigue escribiendo al final.
+FILE *abrirSalida(const char *ruta, int continuar, long bytes) {
+    if (!continuar) {
+        return fopen(ruta, "w");
+    }
+    if (truncate(ruta, bytes) != 0) {
+        return NULL;
     }
-    return -energia / 2.0; // Dividir entre 2 para evitar contar interacciones duplicadas
+    return fopen(ruta, "a");
 }
 
-
-// Algoritmo de Monte Carlo para el modelo de Ising
-void monteCarloIsing(int red[N][N], double beta) {
-    int i, j, n, m, suma_vecinos;
-    double deltaE, probabilidad, r;
+// Algoritmo de Monte Carlo para el modelo de Ising. Con continuar = 1 la red,
+// los generadores, el análisis y el paso salen del último punto de control.
+void monteCarloIsing(RedIsing *red, double beta, int algoritmo, uint64_t semilla, int continuar) {
+    int i, primer_paso = 0, n = red->n;
+    long pasos_hechos = 0; // Pasos de esta ejecución (sin los de antes del punto de control)
+    // Energía y magnetización se calculan una vez (medirMotor, al crear el
+    // motor) y después se siguen con cada inversión
     double energia_actual;
+    long magnetizacion_actual;
+    ResultadosObservables resultados;
+    // Termalización (MSER), medias, autocorrelación y errores por bloques de e y |m|
+    static AnalisisSimulacion analisis;
+    double inicio = omp_get_wtime();
+    GeneradorHilo *generadores = crearGeneradores(semilla);
+
+    EstadoPuntoControl punto_control;
+    memset(&punto_control, 0, sizeof(punto_control));
+    if (continuar) {
+        if (leerPuntoControl(RUTA_PUNTO_CONTROL, &punto_control, red, generadores, &analisis) != 0 ||
+            punto_control.hilos != omp_get_max_threads()) {
+            fprintf(stderr, "Error al leer el punto de control %s.\n", RUTA_PUNTO_CONTROL);
+            exit(1);
+        }
+        primer_paso = (int)punto_control.paso;
+        printf("Continuando desde el paso montecarlo %d.\n", primer_paso);
+    } else if (iniciarAnalisis(&analisis) != 0) {
+        fprintf(stderr, "Error al reservar las series de la termalización.\n");
+        exit(1);
+    }
 
-    // Array circular para almacenar las últimas 6 energías
-    double energias[1000] = {0};
-    for (int k = 0; k < 1000; k++) {
-        energias[k] = calcularEnergia(red);
+    // Cada algoritmo prepara sus propias estructuras a partir de la red
+    MotorIsing motor;
+    if (crearMotorIsing(&motor, algoritmo, red, beta) != 0) {
+        fprintf(stderr, "Error al reservar las estructuras del algoritmo.\n");
+        exit(1);
+    }
+    if (continuar && algoritmo == ALGORITMO_WOLFF) {
+        motor.cluster.ajuste = punto_control.ajuste_wolff;
+    }
+    medirMotor(&motor, red, &energia_actual, &magnetizacion_actual);
+    // Al continuar, la energía y la magnetización seguidas hasta el punto de
+    // control tienen que ser las de la red guardada
+    if (continuar && (energia_actual != punto_control.energia ||
+                      magnetizacion_actual != punto_control.magnetizacion)) {
+        fprintf(stderr, "El punto de control %s no es coherente: E = %.1f y M = %ld guardadas, "
+                "E = %.1f y M = %ld en la red.\n", RUTA_PUNTO_CONTROL, punto_control.energia,
+                (long)punto_control.magnetizacion, energia_actual, magnetizacion_actual);
+        exit(1);
+    }
+    if (algoritmo == ALGORITMO_SIMD) {
+        printf("Barrido SIMD: ruta %s\n", nombreRutaSimd(motor.red_simd.ruta));
     }
 
-    FILE *archivo_red = fopen("matriz_red.txt", "w");
-    if (archivo_red == NULL) {
+    // Trayectoria binaria: un bit por espín (ver trayectoria.h y animacion.py)
+    EscritorTrayectoria trayectoria;
+    int error_trayectoria = continuar
+        ? continuarTrayectoriaEscritura(&trayectoria, "matriz_red.bin", punto_control.fotogramas)
+        : abrirTrayectoriaEscritura(&trayectoria, "matriz_red.bin", n, 1.0 / (K_BOLTZMANN * beta), semilla);
+    if (error_trayectoria != 0) {
         fprintf(stderr, "Error al abrir el archivo para guardar la red.\n");
         exit(1);
     }
 
-    FILE *archivo_energias = fopen("energias.txt", "w");
+    FILE *archivo_red = NULL;
+    if (GUARDAR_TEXTO) {
+        archivo_red = abrirSalida("matriz_red.txt", continuar, punto_control.bytes_texto);
+        if (archivo_red == NULL) {
+            fprintf(stderr, "Error al abrir el archivo para guardar la red.\n");
+            exit(1);
+        }
+    }
+
+    FILE *archivo_energias = abrirSalida("energias.txt", continuar, punto_control.bytes_energias);
     if (archivo_energias == NULL) {
         fprintf(stderr, "Error al abrir el archivo para guardar las energías.\n");
-        fclose(archivo_red);
         exit(1);
     }
 
-    for (i = 0; i < pasosmontecarlo; i++) {
+    for (i = primer_paso; i < pasosmontecarlo; i++) {
         if (i==0){
-            guardarRed(archivo_red, red);
+            escribirFotogramaFilas(&trayectoria, red->espines, red->paso);
+            if (archivo_red != NULL) {
+                guardarRed(archivo_red, red);
+            }
         }
 
-        for (int j = 0; j < N * N; j++) {
-            // Elegir un espín aleatorio en la red
-            n = rand() % N;
-            m = rand() % N;
+        pasoMonteCarlo(&motor, red, generadores, &energia_actual, &magnetizacion_actual);
+        pasos_hechos++;
 
-            // Calcular los vecinos con condiciones de contorno periódicas
-            int arriba, abajo, izquierda, derecha;
+        int termalizado = analisis.termalizado;
+        anadirMedida(&analisis, energia_actual, magnetizacion_actual, n * n);
+        if (!termalizado && analisis.termalizado) {
+            printf("Termalización detectada en el paso %d (MSER descarta los %ld primeros).\n",
+                   i, analisis.corte);
+        }
 
-            // Vecino de arriba
-            if (n == 0) {
-                arriba = red[N - 1][m];
-            } else {
-                arriba = red[n - 1][m];
+        // Guardar la red en el fichero cada intervalofotogramas pasos; solo
+        // entonces hace falta traerla de la copia del motor
+        if ((i + 1) % intervalofotogramas == 0) {
+            sincronizarRed(&motor, red);
+            if (escribirFotogramaFilas(&trayectoria, red->espines, red->paso) != 0) {
+                fprintf(stderr, "Error al escribir la trayectoria.\n");
+                exit(1);
             }
-
-            // Vecino de abajo
-            if (n == N - 1) {
-                abajo = red[0][m];
-            } else {
-                abajo = red[n + 1][m];
+            if (archivo_red != NULL) {
+                guardarRed(archivo_red, red);
             }
+        }
 
-            // Vecino de la izquierda
-            if (m == 0) {
-                izquierda = red[n][N - 1];
-            } else {
-                izquierda = red[n][m - 1];
-            }
+        // Guardar la energía en el archivo
+        fprintf(archivo_energias, "%d %.6f\n", i, energia_actual);
 
-            // Vecino de la derecha
-            if (m == N - 1) {
-                derecha = red[n][0];
-            } else {
-                derecha = red[n][m + 1];
+        // Parar en cuanto los errores de <e> y <|m|> bajan del objetivo
+        if (errorObjetivoAlcanzado(&analisis, errorobjetivo)) {
+            printf("Error objetivo %.1e alcanzado en el paso montecarlo %d.\n", errorobjetivo, i);
+            break;
+        }
+
+        // Punto de control: todo lo necesario para repetir los pasos
+        // siguientes igual, y hasta dónde llegaban entonces las salidas
+        if ((i + 1) % intervalopuntocontrol == 0) {
+            fflush(trayectoria.archivo);
+            fflush(archivo_energias);
+            punto_control.n = n;
+            punto_control.algoritmo = algoritmo;
+            punto_control.hilos = omp_get_max_threads();
+            punto_control.semilla = semilla;
+            punto_control.beta = beta;
+            punto_control.paso = i + 1;
+            punto_control.energia = energia_actual;
+            punto_control.magnetizacion = magnetizacion_actual;
+            punto_control.fotogramas = trayectoria.cabecera.fotogramas;
+            punto_control.bytes_energias = ftell(archivo_energias);
+            if (algoritmo == ALGORITMO_WOLFF) {
+                // Los demás motores no tienen ajuste: se queda a cero (memset de punto_control)
+                punto_control.ajuste_wolff = motor.cluster.ajuste;
+            }
+            if (archivo_red != NULL) {
+                fflush(archivo_red);
+                punto_control.bytes_texto = ftell(archivo_red);
             }
+            sincronizarRed(&motor, red);
+            if (guardarPuntoControl(RUTA_PUNTO_CONTROL, &punto_control, red, generadores, &analisis) != 0) {
+                fprintf(stderr, "Aviso: no se ha podido guardar el punto de control.\n");
+            }
+        }
+    }
+    sincronizarRed(&motor, red); // La red final, para imprimirla
+    if (algoritmo == ALGORITMO_NFOLD && pasos_hechos > 0) {
+        // Metropolis haría n*n intentos por paso para el mismo tiempo físico
+        printf("n-fold way: %.1f inversiones por paso Monte Carlo (Metropolis haría %d intentos).\n",
+               (double)motor.nfold.inversiones / pasos_hechos, n * n);
+    }
+    if (!analisis.termalizado) {
+        printf("Aviso: no se ha detectado la termalización en %d pasos; no hay medidas.\n", pasosmontecarlo);
+    }
 
-            // Calcular el cambio de energía cuando se invierte el espín
-            suma_vecinos = arriba + abajo + izquierda + derecha;
-            deltaE = 2 * red[n][m] * suma_vecinos;
+    if (cerrarTrayectoriaEscritura(&trayectoria) != 0) {
+        fprintf(stderr, "Error al cerrar la trayectoria.\n");
+    }
+    if (archivo_red != NULL) {
+        fclose(archivo_red);
+    }
+    fclose(archivo_energias);
+    double tiempo = omp_get_wtime() - inicio;
+
+    // Muestras independientes por segundo: cada 2 tau pasos se obtiene una
+    // medida descorrelacionada (se toma el mayor de los tiempos de E y |M|)
+    double tau_e = tiempoAutocorrelacion(&analisis.autocorrelacion_e);
+    double tau_m = tiempoAutocorrelacion(&analisis.autocorrelacion_m);
+    double tau = (tau_e > tau_m) ? tau_e : tau_m;
+    long medidas = analisis.acumulador.muestras;
+    printf("Tiempo de autocorrelación: tau(E) = %.2f, tau(|M|) = %.2f pasos\n", tau_e, tau_m);
+    printf("Muestras independientes: %.1f (%.2f por segundo)\n", medidas / (2 * tau), medidas / (2 * tau) / tiempo);
+
+    // Observables promediados sin guardar la serie temporal
+    calcularResultados(&analisis.acumulador, beta, n * n, &resultados);
+    // Error por bloques y, para comparar, el que da tau: sqrt(2 tau var / n)
+    double error_e = errorBloques(&analisis.bloques_e);
+    double error_m = errorBloques(&analisis.bloques_m);
+    double varianza_e = resultados.energia2 - resultados.energia * resultados.energia;
+    double varianza_m = resultados.magnetizacion2 - resultados.magnetizacion_abs * resultados.magnetizacion_abs;
+    printf("Observables por espín (T = %.4f, %ld medidas tras descartar %ld):\n",
+           1.0 / (K_BOLTZMANN * beta), resultados.muestras, analisis.corte);
+    escribirResultados(stdout, &resultados);
+    printf("error_e %.8f (tau: %.8f)\n", error_e, sqrt(2 * tau_e * fmax(varianza_e, 0) / fmax(medidas, 1)));
+    printf("error_m %.8f (tau: %.8f)\n", error_m, sqrt(2 * tau_m * fmax(varianza_m, 0) / fmax(medidas, 1)));
+    FILE *archivo_observables = fopen("observables.txt", "w");
+    if (archivo_observables == NULL) {
+        fprintf(stderr, "Error al abrir el archivo para guardar los observables.\n");
+    } else {
+        escribirResultados(archivo_observables, &resultados);
+        fprintf(archivo_observables, "error_e %.8f\n", error_e);
+        fprintf(archivo_observables, "error_m %.8f\n", error_m);
+        fprintf(archivo_observables, "termalizacion %ld\n", analisis.corte);
+        fclose(archivo_observables);
+    }
+    liberarAnalisis(&analisis);
 
-            // Calcular la probabilidad de transición
-            probabilidad = exp(-beta * deltaE);
-            if (probabilidad > 1.0) {
-                probabilidad = 1.0;
-            }
+    liberarMotorIsing(&motor);
+    free(generadores);
+}
 
-            // Generar un número aleatorio con probabilidad uniforme entre 0 y 1 para decidir si aceptar el cambio
-            r = (double)rand() / RAND_MAX;
+// Compara el motor multiespín con el de enteros (mismo tablero de ajedrez):
+// la energía por popcount debe coincidir exactamente con calcularEnergia, y
+// <E>/N^2 y <|M|>/N^2 deben coincidir dentro del error estadístico.
+void comprobarMultiespin(RedIsing *red, double beta, uint64_t semilla) {
+    const int termalizacion = 500, medidas = 2000, bloques = 20;
+    int motor, i, n = red->n;
+    double media_e[2], error_e[2], media_m[2], error_m[2];
+    RedIsing copia;
+    RedMultiespin red_bits;
+
+    if (crearRedMultiespin(&red_bits, n) != 0 || crearRedIsing(&copia, n) != 0) {
+        fprintf(stderr, "Error al reservar la red multiespín.\n");
+        exit(1);
+    }
 
-            if (r < probabilidad) {
-                red[n][m] *= -1; // Si se acepta el cambio, invertir el signo del espín
-            }
-        }
+    empaquetarRed(&red_bits, red);
+    printf("Energía inicial: calcularEnergia = %.1f, popcount = %.1f\n",
+           calcularEnergia(red), energiaMultiespin(&red_bits));
 
-        // Guardar la red en el fichero cada paso montecarlo
-        guardarRed(archivo_red, red);
+    for (motor = 0; motor < 2; motor++) {
+        GeneradorHilo *generadores = crearGeneradores(semilla + motor);
+        // Medias por bloques para estimar el error aunque las medidas estén correlacionadas
+        double suma_e = 0, suma_e2 = 0, suma_m = 0, suma_m2 = 0;
+        double bloque_e = 0, bloque_m = 0;
 
-        energia_actual = calcularEnergia(red);
+        copiarRedIsing(&copia, red);
+        empaquetarRed(&red_bits, red);
 
-        // Guardar la energía en el archivo
-        fprintf(archivo_energias, "%d %.6f\n", i, energia_actual);
+        double e_incremental = calcularEnergia(&copia);
+        long m_incremental = calcularMagnetizacion(&copia);
 
-        // Verificar convergencia: comparar energía actual con la de 10 pasos antes
-        if (i >= 1000) {
-            if (fabs(energia_actual - energias[i % 1000]) < 2) {
-                printf("Convergencia alcanzada en el paso montecarlo %d.\n", i);
-                break;
+        for (i = 0; i < termalizacion + medidas; i++) {
+            double e, m;
+            if (motor == 0) {
+                barridoTablero(&copia, beta, generadores, &e_incremental, &m_incremental);
+                e = e_incremental;
+                m = m_incremental;
+            } else {
+                barridoMultiespin(&red_bits, beta, generadores);
+                e = energiaMultiespin(&red_bits);
+                m = magnetizacionMultiespin(&red_bits);
+            }
+            if (i < termalizacion) {
+                continue;
             }
+            bloque_e += e / (n * n);
+            bloque_m += fabs(m) / (n * n);
+            if ((i - termalizacion + 1) % (medidas / bloques) == 0) {
+                bloque_e /= medidas / bloques;
+                bloque_m /= medidas / bloques;
+                suma_e += bloque_e;
+                suma_e2 += bloque_e * bloque_e;
+                suma_m += bloque_m;
+                suma_m2 += bloque_m * bloque_m;
+                bloque_e = bloque_m = 0;
+            }
+        }
+        if (motor == 0) {
+            printf("Seguimiento incremental: E = %.1f (calcularEnergia = %.1f), M = %ld (calcularMagnetizacion = %ld)\n",
+                   e_incremental, calcularEnergia(&copia), m_incremental, calcularMagnetizacion(&copia));
         }
-        // Guardar la energía en el array circular
-         energias[i % 1000] = energia_actual;
+        media_e[motor] = suma_e / bloques;
+        media_m[motor] = suma_m / bloques;
+        error_e[motor] = sqrt((suma_e2 / bloques - media_e[motor] * media_e[motor]) / (bloques - 1));
+        error_m[motor] = sqrt((suma_m2 / bloques - media_m[motor] * media_m[motor]) / (bloques - 1));
+        free(generadores);
     }
 
-    fclose(archivo_red);
-    fclose(archivo_energias);
+    desempaquetarRed(&red_bits, &copia);
+    printf("Energía final multiespín: calcularEnergia = %.1f, popcount = %.1f\n",
+           calcularEnergia(&copia), energiaMultiespin(&red_bits));
+    printf("<E>/N^2:   enteros = %.5f +- %.5f, multiespín = %.5f +- %.5f (%.1f sigma)\n",
+           media_e[0], error_e[0], media_e[1], error_e[1],
+           fabs(media_e[0] - media_e[1]) / sqrt(error_e[0] * error_e[0] + error_e[1] * error_e[1]));
+    printf("<|M|>/N^2: enteros = %.5f +- %.5f, multiespín = %.5f +- %.5f (%.1f sigma)\n",
+           media_m[0], error_m[0], media_m[1], error_m[1],
+           fabs(media_m[0] - media_m[1]) / sqrt(error_m[0] * error_m[0] + error_m[1] * error_m[1]));
+
+    liberarRedMultiespin(&red_bits);
+    liberarRedIsing(&copia);
+}
+
+// Templado paralelo entre t_min y t_max: se adapta la escalera de temperaturas
+// durante pasosmontecarlo pasos y después se miden otros tantos
+void templadoParalelo(int n, double t_min, double t_max, int replicas, int algoritmo, uint64_t semilla) {
+    TempladoParalelo tp;
+
+    if (crearTempladoParalelo(&tp, n, replicas, t_min, t_max, algoritmo, semilla) != 0) {
+        fprintf(stderr, "Error al crear las réplicas del templado paralelo.\n");
+        exit(1);
+    }
+
+    ejecutarTempladoParalelo(&tp, pasosmontecarlo, intervaloajusteescalera, pasosmontecarlo, 1);
+
+    printf("Observables por temperatura:\n");
+    escribirTempladoParalelo(stdout, &tp);
+    FILE *archivo = fopen("templado_paralelo.txt", "w");
+    if (archivo == NULL) {
+        fprintf(stderr, "Error al abrir el archivo del templado paralelo.\n");
+    } else {
+        escribirTempladoParalelo(archivo, &tp);
+        fclose(archivo);
+    }
+
+    liberarTempladoParalelo(&tp);
+}
+
+// Réplicas independientes a la temperatura T con los espines de 64 réplicas
+// en cada palabra: pasosmontecarlo pasos para termalizar y otros tantos de medida
+void replicasIndependientes(int n, double beta, int grupos, int sesgo, uint64_t semilla) {
+    RedReplicas replicas;
+
+    if (crearRedReplicas(&replicas, n, grupos, sesgo, semilla) != 0) {
+        fprintf(stderr, "Error al crear las réplicas independientes.\n");
+        exit(1);
+    }
+
+    ejecutarReplicas(&replicas, beta, pasosmontecarlo, pasosmontecarlo);
+
+    FILE *archivo = fopen("replicas_independientes.txt", "w");
+    if (archivo == NULL) {
+        fprintf(stderr, "Error al abrir el archivo de las réplicas independientes.\n");
+    } else {
+        escribirReplicas(archivo, &replicas, beta);
+        fclose(archivo);
+    }
+
+    // Por pantalla solo las medias entre réplicas
+    printf("Observables por espín (T = %.4f, %d réplicas, %d medidas cada una):\n",
+           1.0 / (K_BOLTZMANN * beta), REPLICAS_POR_PALABRA * grupos, pasosmontecarlo);
+    escribirMediasReplicas(stdout, &replicas, beta);
+
+    liberarRedReplicas(&replicas);
+}
+
+// Densidad de estados de la red n x n con Wang-Landau en 'ventanas' ventanas
+// de energía (un caminante por ventana, repartidos entre los hilos)
+void wangLandau(int n, int ventanas, double log_f_final, uint64_t semilla) {
+    WangLandau wl;
+    DensidadEstados densidad;
+    int w;
+
+    if (crearWangLandau(&wl, n, ventanas, log_f_final, semilla) != 0) {
+        fprintf(stderr, "Error al preparar Wang-Landau (demasiadas ventanas para n = %d o sin memoria).\n", n);
+        exit(1);
+    }
+
+    ejecutarWangLandau(&wl, intervalowanglandau, stdout);
+
+    printf("Intercambios aceptados entre ventanas vecinas:");
+    for (w = 0; w < ventanas - 1; w++) {
+        printf(" %.3f", (wl.intentos[w] > 0) ? (double)wl.aceptados[w] / wl.intentos[w] : 0.0);
+    }
+    printf("\n");
+
+    if (unirVentanas(&wl, &densidad) != 0) {
+        fprintf(stderr, "Las ventanas no se solapan en energías visitadas: no se pueden unir.\n");
+        liberarWangLandau(&wl);
+        exit(1);
+    }
+    // Comprobación: el estado fundamental (todos +1 o todos -1) tiene g = 2
+    printf("ln g(E = %ld) = %.6f (exacto: ln 2 = %.6f)\n", densidad.energia_minima, densidad.log_densidad[0],
+           log(2.0));
+    if (guardarDensidadEstados(RUTA_DENSIDAD_ESTADOS, &densidad) != 0) {
+        fprintf(stderr, "Error al escribir %s.\n", RUTA_DENSIDAD_ESTADOS);
+    } else {
+        printf("Densidad de estados en %s (./termodinamica %s para F, U, C y S)\n", RUTA_DENSIDAD_ESTADOS,
+               RUTA_DENSIDAD_ESTADOS);
+    }
+
+    liberarDensidadEstados(&densidad);
+    liberarWangLandau(&wl);
 }
 
 // Función para imprimir la red
-void imprimirRed(int red[N][N]) {
+void imprimirRed(const RedIsing *red) {
     int i, j;
-    for (i = 0; i < N; i++) {
-        for (j = 0; j < N; j++) {
-            printf("%2d ", red[i][j]);
+    if (red->n > TAMANO_MAXIMO_IMPRESION) {
+        printf("(red de %d x %d, no se imprime)\n", red->n, red->n);
+        return;
+    }
+    for (i = 0; i < red->n; i++) {
+        const int8_t *fila = filaRed(red, i);
+        for (j = 0; j < red->n; j++) {
+            printf("%2d ", fila[j]);
         }
         printf("\n");
     }
 }
 
-int main() {
-    // Medir el tiempo de inicio
-    double beta = 1.0 / (K_BOLTZMANN * T); // Beta = 1 / (k_B * T)
-
-    // Inicializa la semilla de números aleatorios
-    srand(time(NULL));
-
-    int red[N][N];
-    int opcion;
+// Pregunta cómo inicializar la red y qué algoritmo usar. Devuelve el algoritmo.
+int elegirConfiguracion(RedIsing *red, GeneradorHilo *generador_inicial) {
+    int opcion, algoritmo;
 
     // Solicitar al usuario cómo inicializar la red
     printf("Seleccione cómo inicializar la red:\n");
@@ -233,32 +475,170 @@ int main() {
 
     if (opcion == 1) {
         // Inicializar la red de forma completamente aleatoria
-        inicializarRed(red, 50); // 50% de probabilidad para +1 o -1
+        inicializarRed(red, 50, generador_inicial); // 50% de probabilidad para +1 o -1
     } else if (opcion == 2) {
         // Inicializar la red de forma ordenada (+1)
-        inicializarRedOrdenada(red, 50);
+        inicializarRedOrdenada(red, 1);
     } else {
         printf("Opción no válida. Inicializando de forma aleatoria por defecto.\n");
-        inicializarRed(red, 50);
+        inicializarRed(red, 50, generador_inicial);
+    }
+
+    // Solicitar el algoritmo de actualización
+    printf("Seleccione el algoritmo de actualización:\n");
+    printf("1. Metropolis en posiciones aleatorias (un hilo)\n");
+    printf("2. Metropolis en tablero de ajedrez (OpenMP, %d hilos)\n", omp_get_max_threads());
+    printf("3. Metropolis multiespín (64 espines por palabra, OpenMP)\n");
+    printf("4. Comprobar el multiespín frente al tablero de enteros\n");
+    printf("5. Clusters de Wolff\n");
+    printf("6. Clusters de Swendsen-Wang (OpenMP)\n");
+    printf("7. Templado paralelo (réplicas a varias temperaturas, OpenMP)\n");
+    printf("8. Metropolis SIMD (un espín por byte, AVX2/AVX-512, OpenMP)\n");
+    printf("9. Metropolis con tabla de vecinos (la misma de las redes triangular, panal y cúbica, OpenMP)\n");
+    printf("10. n-fold way (sin rechazos en tiempo continuo, un hilo; para temperaturas bajas)\n");
+    printf("11. Réplicas independientes (64 redes por palabra, OpenMP)\n");
+    printf("12. Wang-Landau: densidad de estados g(E) (ventanas de energía en paralelo, OpenMP)\n");
+    printf("Ingrese su opción (1 a 12): ");
+    if (scanf("%d", &algoritmo) != 1 || algoritmo < ALGORITMO_ALEATORIO || algoritmo > WANG_LANDAU) {
+        printf("Opción no válida. Usando posiciones aleatorias por defecto.\n");
+        algoritmo = ALGORITMO_ALEATORIO;
+    }
+    return algoritmo;
+}
+
+int main(int argc, char *argv[]) {
+    // Medir el tiempo de inicio
+    double beta = 1.0 / (K_BOLTZMANN * T); // Beta = 1 / (k_B * T)
+
+    // Inicializa la semilla de números aleatorios: todos los flujos de Philox
+    // (uno por hilo o réplica) salen de ella
+    uint64_t semilla = (uint64_t)time(NULL);
+
+    // Argumentos: tamaño de la red (N por defecto) o --continuar
+    int n = N, continuar = 0, k;
+    for (k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "--continuar") == 0) {
+            continuar = 1;
+        } else {
+            // Los barridos en tablero de ajedrez (y el multiespín y SIMD) necesitan n par
+            char *fin;
+            errno = 0;
+            long leido = strtol(argv[k], &fin, 10);
+            if (errno != 0 || fin == argv[k] || *fin != '\0' || leido < 2 || leido > INT_MAX || leido % 2 != 0) {
+                fprintf(stderr, "Tamaño de red no válido: '%s' (tiene que ser un entero par mayor o igual que 2).\n",
+                        argv[k]);
+                return 1;
+            }
+            n = (int)leido;
+        }
+    }
+
+    // Al continuar, la red, la temperatura, la semilla y el algoritmo son los del punto de control
+    EstadoPuntoControl punto_control;
+    if (continuar) {
+        if (leerEstadoPuntoControl(RUTA_PUNTO_CONTROL, &punto_control) != 0) {
+            fprintf(stderr, "No se puede leer el punto de control %s.\n", RUTA_PUNTO_CONTROL);
+            return 1;
+        }
+        n = punto_control.n;
+        beta = punto_control.beta;
+        semilla = punto_control.semilla;
+        // Con los mismos hilos cada uno recibe las mismas filas y el mismo generador
+        omp_set_num_threads(punto_control.hilos);
+    }
+
+    GeneradorHilo generador_inicial;
+    inicializarGeneradorFlujo(&generador_inicial, semilla, 0, FLUJO_INICIALIZACION);
+
+    RedIsing red;
+    if (crearRedIsing(&red, n) != 0) {
+        fprintf(stderr, "Tamaño de red no válido o sin memoria (n = %d).\n", n);
+        return 1;
+    }
+    int algoritmo = continuar ? punto_control.algoritmo : elegirConfiguracion(&red, &generador_inicial);
+
+    // omp_get_wtime mide tiempo real; clock() sumaría el tiempo de CPU de todos los hilos
+    double inicio = omp_get_wtime();
+
+    if (algoritmo == TEMPLADO_PARALELO) {
+        double t_min, t_max;
+        int replicas;
+        printf("Ingrese temperatura mínima, temperatura máxima y número de réplicas: ");
+        if (scanf("%lf %lf %d", &t_min, &t_max, &replicas) != 3 || t_min <= 0 || t_max <= t_min || replicas < 2) {
+            printf("Parámetros no válidos. Usando T entre 1.5 y 3.5 con 16 réplicas.\n");
+            t_min = 1.5;
+            t_max = 3.5;
+            replicas = 16;
+        }
+        int algoritmo_replicas;
+        printf("Algoritmo de las réplicas (1 aleatorio, 2 tablero, 3 multiespín, 8 SIMD): ");
+        if (scanf("%d", &algoritmo_replicas) != 1 || !algoritmoTempladoValido(algoritmo_replicas)) {
+            printf("Algoritmo no válido. Usando el tablero de ajedrez.\n");
+            algoritmo_replicas = ALGORITMO_TABLERO;
+        }
+        templadoParalelo(n, t_min, t_max, replicas, algoritmo_replicas, semilla);
+        printf("\nTiempo de ejecución: %.2f segundos.\n", omp_get_wtime() - inicio);
+        liberarRedIsing(&red);
+        return 0;
     }
 
-    clock_t inicio = clock();
+    if (algoritmo == REPLICAS_INDEPENDIENTES) {
+        int replicas;
+        printf("Ingrese el número de réplicas (múltiplo de %d): ", REPLICAS_POR_PALABRA);
+        if (scanf("%d", &replicas) != 1 || replicas < REPLICAS_POR_PALABRA || replicas % REPLICAS_POR_PALABRA != 0) {
+            printf("Número no válido. Usando %d réplicas.\n", REPLICAS_POR_PALABRA);
+            replicas = REPLICAS_POR_PALABRA;
+        }
+        // Cada réplica empieza como se ha elegido: ordenada o aleatoria (con
+        // su propia configuración, no una copia de la red)
+        int sesgo = (calcularMagnetizacion(&red) == (long)n * n) ? 100 : 50;
+        replicasIndependientes(n, beta, replicas / REPLICAS_POR_PALABRA, sesgo, semilla);
+        printf("\nTiempo de ejecución: %.2f segundos.\n", omp_get_wtime() - inicio);
+        liberarRedIsing(&red);
+        return 0;
+    }
+
+    if (algoritmo == WANG_LANDAU) {
+        int ventanas;
+        double log_f_final;
+        printf("Ingrese el número de ventanas de energía y ln f final (por ejemplo %d 1e-6): ",
+               omp_get_max_threads());
+        if (scanf("%d %lf", &ventanas, &log_f_final) != 2 || ventanas < 1 || log_f_final <= 0) {
+            printf("Parámetros no válidos. Usando %d ventanas y ln f final = 1e-6.\n", omp_get_max_threads());
+            ventanas = omp_get_max_threads();
+            log_f_final = 1e-6;
+        }
+        // Los caminantes no usan la red elegida: cada uno empieza en su ventana
+        wangLandau(n, ventanas, log_f_final, semilla);
+        printf("\nTiempo de ejecución: %.2f segundos.\n", omp_get_wtime() - inicio);
+        liberarRedIsing(&red);
+        return 0;
+    }
+
+    if (algoritmo == COMPROBAR_MULTIESPIN) {
+        comprobarMultiespin(&red, beta, semilla);
+        liberarRedIsing(&red);
+        return 0;
+    }
 
     // Imprimir la configuración inicial
-    printf("Configuración inicial de la red:\n");
-    imprimirRed(red);
+    if (!continuar) {
+        printf("Configuración inicial de la red:\n");
+        imprimirRed(&red);
+    }
 
     // Ejecutar el algoritmo de Monte Carlo
-    monteCarloIsing(red, beta);
+    monteCarloIsing(&red, beta, algoritmo, semilla, continuar);
 
     // Imprimir la configuración final
     printf("\nConfiguración final de la red:\n");
-    imprimirRed(red);
+    imprimirRed(&red);
 
     // Medir el tiempo de finalización
-    clock_t fin = clock();
-    double tiempo = (double)(fin - inicio) / CLOCKS_PER_SEC;
+    double fin = omp_get_wtime();
+    double tiempo = fin - inicio;
     printf("\nTiempo de ejecución: %.2f segundos.\n", tiempo);
 
+    liberarRedIsing(&red);
     return 0;
 }
\ No newline at end of file
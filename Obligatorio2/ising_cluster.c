@@ -0,0 +1,288 @@
+#include <stdlib.h>
+#include <math.h>
+#include <limits.h>
+#include <string.h>
+#include <omp.h>
+#include "ising_cluster.h"
+
+int crearMotorCluster(MotorCluster *c, int n, double beta) {
+    c->n = n;
+    c->p_anadir = 1.0 - exp(-2.0 * beta);
+    c->pila = malloc((size_t)n * n * sizeof(int));
+    c->llegada = malloc((size_t)n * n * sizeof(int));
+    c->invertir = malloc((size_t)n * n);
+    c->contador = INT_MAX; // Se rellena llegada al construir el primer cluster
+    c->padre = malloc((size_t)n * n * sizeof(int));
+    c->frontera = malloc((size_t)n * omp_get_max_threads());
+    c->ajuste.pasos = 0;
+    c->ajuste.clusters = 0;
+    c->ajuste.espines = 0;
+    c->ajuste.clusters_por_paso = 0;
+    if (c->pila == NULL || c->llegada == NULL || c->invertir == NULL || c->padre == NULL || c->frontera == NULL) {
+        liberarMotorCluster(c);
+        return 1;
+    }
+    return 0;
+}
+
+void liberarMotorCluster(MotorCluster *c) {
+    free(c->pila);
+    free(c->llegada);
+    free(c->invertir);
+    free(c->padre);
+    free(c->frontera);
+    c->pila = c->llegada = c->padre = NULL;
+    c->invertir = c->frontera = NULL;
+}
+
+// Posiciones de los cuatro vecinos de k con contorno periódico
+static inline void vecinosCluster(int n, int k, int vecinos[4]) {
+    int i = k / n, j = k % n;
+    vecinos[0] = ((i == 0) ? n - 1 : i - 1) * n + j;
+    vecinos[1] = ((i == n - 1) ? 0 : i + 1) * n + j;
+    vecinos[2] = i * n + ((j == 0) ? n - 1 : j - 1);
+    vecinos[3] = i * n + ((j == n - 1) ? 0 : j + 1);
+}
+
+// Construye un cluster de Wolff a partir de la semilla y lo invierte.
+// Cada espín se invierte en cuanto entra en el cluster, así que un vecino ya
+// añadido ya no es paralelo a la semilla. Los bordes fantasma no se tocan
+// mientras se construye: se rehacen al final del barrido.
+//
+// El cambio de energía sale sin otra pasada: con la suma S de espin * (suma
+// de vecinos antes de invertir) de los espines del cluster y sus I enlaces
+// internos, los del borde suman S - 2 I y cada uno cambia la energía en 2
+// espin * vecino. Cada enlace interno se cuenta una vez, al sacar de la pila
+// el espín que llegó después (el que tiene mayor c->llegada).
+static long clusterWolff(MotorCluster *c, RedIsing *red, int semilla, GeneradorHilo *g,
+                         long *delta_energia, long *delta_magnetizacion) {
+    int n = c->n;
+    int espin = filaRed(red, semilla / n)[semilla % n];
+    int *pila = c->pila, *llegada = c->llegada;
+    double p_anadir = c->p_anadir;
+    int cima = 0, v;
+    long suma = 0, internos = 0;
+
+    // Las llegadas de clusters anteriores son menores que base
+    if (c->contador > INT_MAX - n * n) {
+        memset(llegada, 0xff, (size_t)n * n * sizeof(int));
+        c->contador = 0;
+    }
+    int base = c->contador, contador = base;
+
+    filaRed(red, semilla / n)[semilla % n] = (int8_t)-espin;
+    llegada[semilla] = contador++;
+    pila[cima++] = semilla;
+
+    while (cima > 0) {
+        int k = pila[--cima];
+        int llegada_k = llegada[k];
+        int vecinos[4];
+        vecinosCluster(n, k, vecinos);
+        for (v = 0; v < 4; v++) {
+            int vecino = vecinos[v];
+            int8_t *s = filaRed(red, vecino / n) + vecino % n;
+            if (*s == espin) {
+                // Paralelo y fuera del cluster (los de dentro ya están invertidos)
+                suma++;
+                if (aleatorioUniforme(g) < p_anadir) {
+                    *s = (int8_t)-espin;
+                    llegada[vecino] = contador++;
+                    pila[cima++] = vecino;
+                }
+            } else {
+                // Ya en el cluster (antes era paralelo) o antiparalelo desde el principio
+                int llegada_vecino = llegada[vecino];
+                int dentro = llegada_vecino >= base;
+                suma += 2 * dentro - 1;
+                internos += dentro & (llegada_vecino < llegada_k);
+            }
+        }
+    }
+    c->contador = contador;
+
+    long tamano = contador - base;
+    *delta_energia += 2 * (suma - 2 * internos);
+    *delta_magnetizacion -= 2 * espin * tamano;
+    return tamano;
+}
+
+long barridoWolff(MotorCluster *c, RedIsing *red, GeneradorHilo *g, double *energia, long *magnetizacion) {
+    AjusteWolff *a = &c->ajuste;
+    long invertidos = 0, clusters = 0;
+    long total = (long)c->n * c->n;
+    long delta_energia = 0, delta_magnetizacion = 0;
+
+    if (a->pasos == 0) {
+        // Sin estimación todavía: hasta invertir n*n espines
+        while (invertidos < total) {
+            invertidos += clusterWolff(c, red, (int)aleatorioEntero(g, (uint32_t)total), g,
+                                       &delta_energia, &delta_magnetizacion);
+            clusters++;
+        }
+    } else {
+        for (clusters = 0; clusters < a->clusters_por_paso; clusters++) {
+            invertidos += clusterWolff(c, red, (int)aleatorioEntero(g, (uint32_t)total), g,
+                                       &delta_energia, &delta_magnetizacion);
+        }
+    }
+    *energia += delta_energia;
+    *magnetizacion += delta_magnetizacion;
+
+    if (a->pasos < PASOS_AJUSTE_WOLFF) {
+        a->clusters += clusters;
+        a->espines += invertidos;
+        a->clusters_por_paso = (long)ceil(total * a->clusters / a->espines);
+    }
+    a->pasos++;
+    actualizarBordes(red);
+    return clusters;
+}
+
+// Búsqueda de la raíz con división del camino a la mitad
+static inline int raiz(int *padre, int k) {
+    while (padre[k] != k) {
+        padre[k] = padre[padre[k]];
+        k = padre[k];
+    }
+    return k;
+}
+
+// Búsqueda de la raíz sin modificar el bosque (se puede usar desde varios hilos)
+static inline int raizSoloLectura(const int *padre, int k) {
+    while (padre[k] != k) {
+        k = padre[k];
+    }
+    return k;
+}
+
+// Une los clusters de a y b; la raíz con menor índice queda como raíz común
+static inline void unir(int *padre, int a, int b) {
+    a = raiz(padre, a);
+    b = raiz(padre, b);
+    if (a < b) {
+        padre[b] = a;
+    } else if (b < a) {
+        padre[a] = b;
+    }
+}
+
+long barridoSwendsenWang(MotorCluster *c, RedIsing *red, GeneradorHilo generadores[],
+                         double *energia, long *magnetizacion) {
+    int n = c->n;
+    long clusters = 0, delta_energia = 0, delta_magnetizacion = 0;
+    int num_franjas = 1;
+    // Semilla del paso para decidir qué clusters se invierten: la decisión
+    // depende solo de la raíz, así que cualquier hilo la puede tomar
+    uint64_t semilla_inversion = siguienteAleatorio(&generadores[0]);
+
+    // 1. Cada hilo activa los enlaces de su franja de filas y une sus clusters.
+    // Los enlaces hacia la primera fila de la franja siguiente se guardan aparte.
+    #pragma omp parallel
+    {
+        int hilo = omp_get_thread_num();
+        int franjas = omp_get_num_threads();
+        int inicio = (int)((long)hilo * n / franjas);
+        int fin = (int)((long)(hilo + 1) * n / franjas);
+        GeneradorHilo *g = &generadores[hilo];
+        int i, j;
+
+        #pragma omp single
+        num_franjas = franjas;
+
+        for (i = inicio; i < fin; i++) {
+            for (j = 0; j < n; j++) {
+                c->padre[i * n + j] = i * n + j;
+            }
+        }
+
+        // Los vecinos de la derecha y de abajo se leen del borde fantasma en
+        // la última columna y la última fila
+        for (i = inicio; i < fin; i++) {
+            int abajo = (i == n - 1) ? 0 : i + 1;
+            const int8_t *fila = filaRed(red, i), *fila_abajo = filaRed(red, i + 1);
+            for (j = 0; j < n; j++) {
+                int k = i * n + j;
+                int derecha = i * n + ((j == n - 1) ? 0 : j + 1);
+
+                if (fila[j] == fila[j + 1] && aleatorioUniforme(g) < c->p_anadir) {
+                    unir(c->padre, k, derecha);
+                }
+
+                int activo = fila[j] == fila_abajo[j] && aleatorioUniforme(g) < c->p_anadir;
+                if (i < fin - 1) {
+                    if (activo) {
+                        unir(c->padre, k, abajo * n + j);
+                    }
+                } else {
+                    c->frontera[(size_t)hilo * n + j] = (unsigned char)activo;
+                }
+            }
+        }
+    }
+
+    // 2. Unir los clusters a través de las fronteras entre franjas (O(n) por franja)
+    for (int franja = 0; franja < num_franjas; franja++) {
+        int fin = (int)((long)(franja + 1) * n / num_franjas);
+        int inicio = (int)((long)franja * n / num_franjas);
+        if (fin == inicio) {
+            continue; // Franja vacía si hay más hilos que filas
+        }
+        int ultima = fin - 1;
+        int siguiente = (fin == n) ? 0 : fin;
+        for (int j = 0; j < n; j++) {
+            if (c->frontera[(size_t)franja * n + j]) {
+                unir(c->padre, ultima * n + j, siguiente * n + j);
+            }
+        }
+    }
+
+    // 3. Cada cluster se invierte con probabilidad 1/2 (el bosque ya no cambia).
+    // Primero se apunta qué espines se invierten; después, con la red todavía
+    // sin tocar, cambian M los espines que se invierten y E los enlaces entre un
+    // espín que se invierte y otro que no (el vecino de la derecha y el de abajo, del
+    // borde fantasma); por último se invierten.
+    #pragma omp parallel
+    {
+        int i, j;
+
+        #pragma omp for reduction(+:clusters) schedule(static)
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < n; j++) {
+                int k = i * n + j;
+                int r = raizSoloLectura(c->padre, k);
+                if (r == k) {
+                    clusters++;
+                }
+                c->invertir[k] = (unsigned char)(splitmix64(semilla_inversion ^ (uint64_t)r) & 1);
+            }
+        }
+
+        #pragma omp for reduction(+:delta_energia, delta_magnetizacion) schedule(static)
+        for (i = 0; i < n; i++) {
+            const int8_t *fila = filaRed(red, i), *fila_abajo = filaRed(red, i + 1);
+            const unsigned char *invertir = c->invertir + (size_t)i * n;
+            const unsigned char *invertir_abajo = c->invertir + (size_t)((i == n - 1) ? 0 : i + 1) * n;
+            for (j = 0; j < n; j++) {
+                int derecha = (j == n - 1) ? 0 : j + 1;
+                delta_magnetizacion -= invertir[j] * 2 * fila[j];
+                delta_energia += (invertir[j] != invertir[derecha]) * 2 * fila[j] * fila[j + 1] +
+                                 (invertir[j] != invertir_abajo[j]) * 2 * fila[j] * fila_abajo[j];
+            }
+        }
+
+        #pragma omp for schedule(static)
+        for (i = 0; i < n; i++) {
+            int8_t *fila = filaRed(red, i);
+            const unsigned char *invertir = c->invertir + (size_t)i * n;
+            for (j = 0; j < n; j++) {
+                fila[j] = (int8_t)(fila[j] * (1 - 2 * invertir[j]));
+            }
+        }
+    }
+    actualizarBordes(red);
+    *energia += delta_energia;
+    *magnetizacion += delta_magnetizacion;
+
+    return clusters;
+}
@@ -0,0 +1,58 @@
+#ifndef ISING_CLUSTER_H
+#define ISING_CLUSTER_H
+
+#include "aleatorio.h"
+#include "red_ising.h"
+
+// Algoritmos de cluster (Wolff y Swendsen-Wang) sobre la red n x n con
+// contorno periódico. Las posiciones se numeran k = i * n + j. Cerca de Tc
+// invierten dominios enteros de una vez y evitan la ralentización crítica
+// de Metropolis.
+
+// Número de clusters de cada paso de Wolff. Parar cuando se han invertido
+// n*n espines hace que el final del paso dependa del último cluster (suele
+// ser grande) y sesga las medidas hacia estados con más orden. En su lugar
+// cada paso construye un número fijo de clusters: durante los primeros
+// PASOS_AJUSTE_WOLFF pasos se estima con el tamaño medio de los anteriores
+// y después queda fijo.
+#define PASOS_AJUSTE_WOLFF 100
+
+typedef struct {
+    long pasos;              // Pasos de Wolff hechos
+    long clusters;           // Clusters construidos durante el ajuste
+    double espines;          // Espines invertidos durante el ajuste
+    long clusters_por_paso;  // Clusters de cada paso (fijo tras el ajuste)
+} AjusteWolff;
+
+typedef struct {
+    int n;
+    double p_anadir;       // Probabilidad de activar un enlace entre espines paralelos: 1 - exp(-2 beta)
+    int *pila;             // Pila explícita de posiciones pendientes (Wolff)
+    int *llegada;          // Orden de llegada de cada espín a un cluster (Wolff)
+    int contador;          // Siguiente llegada (Wolff)
+    unsigned char *invertir; // 1 si el cluster del espín se invierte (Swendsen-Wang)
+    int *padre;            // Bosque de unión-búsqueda (Swendsen-Wang)
+    unsigned char *frontera; // Enlaces activados entre franjas de hilos (Swendsen-Wang)
+    AjusteWolff ajuste;    // Clusters por paso de Wolff
+} MotorCluster;
+
+// Reserva los buffers para una red n x n a temperatura 1/beta. Devuelve 0 si todo va bien.
+int crearMotorCluster(MotorCluster *c, int n, double beta);
+void liberarMotorCluster(MotorCluster *c);
+
+// Un paso de Wolff: construye e invierte los clusters necesarios para
+// invertir en media n*n espines, para que sea comparable con un paso Monte
+// Carlo (ver AjusteWolff). energia y magnetizacion se actualizan con cada
+// cluster (M con sus espines, E con los enlaces de su borde), sin recorrer la
+// red. Devuelve el número de clusters construidos.
+long barridoWolff(MotorCluster *c, RedIsing *red, GeneradorHilo *g, double *energia, long *magnetizacion);
+
+// Un paso de Swendsen-Wang: activa enlaces, etiqueta todos los clusters y
+// invierte cada uno con probabilidad 1/2. Se reparte en franjas de filas entre
+// los hilos de OpenMP. energia y magnetizacion se actualizan con los espines
+// invertidos y los enlaces entre un cluster invertido y otro que no.
+// Devuelve el número de clusters.
+long barridoSwendsenWang(MotorCluster *c, RedIsing *red, GeneradorHilo generadores[],
+                         double *energia, long *magnetizacion);
+
+#endif
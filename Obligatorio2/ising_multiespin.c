@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "ising_multiespin.h"
+
+// Patrón de casillas negras ((i + j) par) en una palabra cuya primera columna es par
+#define PATRON_PAR 0x5555555555555555ULL
+
+int crearRedMultiespin(RedMultiespin *r, int n) {
+    if (n <= 0 || n % 2 != 0) {
+        return 1;
+    }
+    r->n = n;
+    r->palabras = (n + 63) / 64;
+    int resto = n - 64 * (r->palabras - 1);
+    r->mascara_ultima = (resto == 64) ? ~0ULL : ((1ULL << resto) - 1);
+    r->bits = calloc((size_t)n * r->palabras, sizeof(uint64_t));
+    return r->bits == NULL;
+}
+
+void liberarRedMultiespin(RedMultiespin *r) {
+    free(r->bits);
+    r->bits = NULL;
+}
+
+void empaquetarRed(RedMultiespin *r, const RedIsing *red) {
+    int i, j, n = r->n;
+    for (i = 0; i < n; i++) {
+        uint64_t *fila = r->bits + (size_t)i * r->palabras;
+        const int8_t *origen = filaRed(red, i);
+        for (j = 0; j < r->palabras; j++) {
+            fila[j] = 0;
+        }
+        for (j = 0; j < n; j++) {
+            if (origen[j] > 0) {
+                fila[j / 64] |= 1ULL << (j % 64);
+            }
+        }
+    }
+}
+
+void desempaquetarRed(const RedMultiespin *r, RedIsing *red) {
+    int i, j, n = r->n;
+    for (i = 0; i < n; i++) {
+        const uint64_t *fila = r->bits + (size_t)i * r->palabras;
+        int8_t *destino = filaRed(red, i);
+        for (j = 0; j < n; j++) {
+            destino[j] = ((fila[j / 64] >> (j % 64)) & 1) ? 1 : -1;
+        }
+    }
+    actualizarBordes(red);
+}
+
+// Vecino de la izquierda (columna j - 1) de cada bit de la palabra w, con contorno periódico
+static inline uint64_t vecinoIzquierda(const RedMultiespin *r, const uint64_t *fila, int w) {
+    uint64_t acarreo;
+    if (w == 0) {
+        int ultima = r->n - 1; // La columna 0 se conecta con la n - 1
+        acarreo = (fila[ultima / 64] >> (ultima % 64)) & 1;
+    } else {
+        acarreo = fila[w - 1] >> 63;
+    }
+    return (fila[w] << 1) | acarreo;
+}
+
+// Vecino de la derecha (columna j + 1) de cada bit de la palabra w, con contorno periódico
+static inline uint64_t vecinoDerecha(const RedMultiespin *r, const uint64_t *fila, int w) {
+    if (w == r->palabras - 1) {
+        // La última columna válida se conecta con la columna 0
+        int ultima = (r->n - 1) % 64;
+        return ((fila[w] >> 1) & (r->mascara_ultima >> 1)) | ((fila[0] & 1) << ultima);
+    }
+    return (fila[w] >> 1) | ((fila[w + 1] & 1) << 63);
+}
+
+// Actualiza los espines de un color en las filas de una paridad. Con las filas
+// separadas por paridad ningún hilo escribe una palabra que otro esté leyendo.
+static void actualizarFilas(RedMultiespin *r, int color, int paridad_fila,
+                            uint64_t p4, uint64_t p8, GeneradorHilo generadores[]) {
+    int n = r->n, palabras = r->palabras;
+
+    #pragma omp parallel
+    {
+        GeneradorHilo *g = &generadores[omp_get_thread_num()];
+        int i, w;
+
+        #pragma omp for schedule(static)
+        for (i = paridad_fila; i < n; i += 2) {
+            uint64_t *fila = r->bits + (size_t)i * palabras;
+            const uint64_t *arriba = r->bits + (size_t)((i == 0) ? n - 1 : i - 1) * palabras;
+            const uint64_t *abajo = r->bits + (size_t)((i == n - 1) ? 0 : i + 1) * palabras;
+            // 64 es par, así que el patrón solo depende de la paridad de la fila
+            uint64_t activos = ((i + color) % 2 == 0) ? PATRON_PAR : ~PATRON_PAR;
+
+            for (w = 0; w < palabras; w++) {
+                uint64_t s = fila[w];
+                uint64_t validos = activos & ((w == palabras - 1) ? r->mascara_ultima : ~0ULL);
+
+                // a_k = 1 si el vecino k es antiparalelo al espín
+                uint64_t a1 = s ^ arriba[w];
+                uint64_t a2 = s ^ abajo[w];
+                uint64_t a3 = s ^ vecinoIzquierda(r, fila, w);
+                uint64_t a4 = s ^ vecinoDerecha(r, fila, w);
+
+                // Contar vecinos antiparalelos c (0..4) con sumadores de bits.
+                // deltaE = 8 - 4c: se acepta siempre si c >= 2
+                uint64_t s12 = a1 ^ a2, c12 = a1 & a2;
+                uint64_t s34 = a3 ^ a4, c34 = a3 & a4;
+                uint64_t al_menos_dos = c12 | c34 | (s12 & s34);
+                uint64_t exactamente_uno = (s12 ^ s34) & ~(c12 | c34);
+                uint64_t ninguno = ~(a1 | a2 | a3 | a4);
+
+                uint64_t invertir = validos & al_menos_dos;
+                uint64_t con_uno = validos & exactamente_uno;
+                uint64_t con_ninguno = validos & ninguno;
+                if (con_uno) {
+                    invertir |= mascaraBernoulli(g, con_uno, p4);   // deltaE = 4
+                }
+                if (con_ninguno) {
+                    invertir |= mascaraBernoulli(g, con_ninguno, p8); // deltaE = 8
+                }
+                fila[w] = s ^ invertir;
+            }
+        }
+    }
+}
+
+void barridoMultiespin(RedMultiespin *r, double beta, GeneradorHilo generadores[]) {
+    // Probabilidades de aceptación en punto fijo con BITS_PRECISION bits
+    double escala = ldexp(1.0, BITS_PRECISION);
+    uint64_t p4 = (uint64_t)(exp(-4.0 * beta) * escala);
+    uint64_t p8 = (uint64_t)(exp(-8.0 * beta) * escala);
+    int color;
+
+    for (color = 0; color < 2; color++) {
+        actualizarFilas(r, color, 0, p4, p8, generadores);
+        actualizarFilas(r, color, 1, p4, p8, generadores);
+    }
+}
+
+double energiaMultiespin(const RedMultiespin *r) {
+    int n = r->n, palabras = r->palabras;
+    long antiparalelos = 0;
+    int i;
+
+    // Cada enlace se cuenta una vez: vecino de la derecha y vecino de abajo
+    #pragma omp parallel for reduction(+:antiparalelos)
+    for (i = 0; i < n; i++) {
+        const uint64_t *fila = r->bits + (size_t)i * palabras;
+        const uint64_t *abajo = r->bits + (size_t)((i == n - 1) ? 0 : i + 1) * palabras;
+        int w;
+        for (w = 0; w < palabras; w++) {
+            uint64_t validos = (w == palabras - 1) ? r->mascara_ultima : ~0ULL;
+            antiparalelos += __builtin_popcountll((fila[w] ^ abajo[w]) & validos);
+            antiparalelos += __builtin_popcountll((fila[w] ^ vecinoDerecha(r, fila, w)) & validos);
+        }
+    }
+
+    // E = -(enlaces paralelos - enlaces antiparalelos), con 2 n^2 enlaces en total
+    return -(2.0 * n * n - 2.0 * antiparalelos);
+}
+
+long magnetizacionMultiespin(const RedMultiespin *r) {
+    long positivos = 0;
+    size_t k, total = (size_t)r->n * r->palabras;
+    for (k = 0; k < total; k++) {
+        positivos += __builtin_popcountll(r->bits[k]);
+    }
+    return 2 * positivos - (long)r->n * r->n;
+}
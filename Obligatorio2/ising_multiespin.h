@@ -0,0 +1,55 @@
+#ifndef ISING_MULTIESPIN_H
+#define ISING_MULTIESPIN_H
+
+#include <stdint.h>
+#include "aleatorio.h"
+#include "red_ising.h"
+
+// Red de Ising con un espín por bit (multi-spin coding): el bit b de la
+// palabra w de la fila i es el espín de la columna 64*w + b.
+// Bit a 1 -> espín +1, bit a 0 -> espín -1.
+typedef struct {
+    int n;                    // Tamaño de la red (n x n), n par
+    int palabras;             // Palabras de 64 bits por fila
+    uint64_t mascara_ultima;  // Bits válidos de la última palabra de cada fila
+    uint64_t *bits;           // n * palabras palabras, fila a fila
+} RedMultiespin;
+
+// Reserva una red de n x n espines (n debe ser par). Devuelve 0 si todo va bien.
+int crearRedMultiespin(RedMultiespin *r, int n);
+void liberarRedMultiespin(RedMultiespin *r);
+
+// Conversión desde/hacia la red de un byte por espín (del mismo tamaño)
+void empaquetarRed(RedMultiespin *r, const RedIsing *red);
+void desempaquetarRed(const RedMultiespin *r, RedIsing *red);
+
+// Bits de precisión con los que se compara cada uniforme con la probabilidad
+#define BITS_PRECISION 32
+
+// Máscara aleatoria en la que cada bit de 'candidatos' vale 1 con probabilidad p.
+// Equivale a comparar un uniforme por bit con p, pero cifra a cifra en binario
+// y para los 64 bits a la vez: un bit queda decidido en la primera cifra en que
+// su uniforme difiere de p, así que en media bastan unas pocas palabras aleatorias.
+static inline uint64_t mascaraBernoulli(GeneradorHilo *g, uint64_t candidatos, uint64_t p_binario) {
+    uint64_t resultado = 0, indecisos = candidatos;
+    int k;
+    for (k = BITS_PRECISION - 1; k >= 0 && indecisos; k--) {
+        uint64_t u = siguienteAleatorio(g);
+        if ((p_binario >> k) & 1) {
+            resultado |= indecisos & ~u; // u = 0 < 1: el uniforme es menor que p
+            indecisos &= u;
+        } else {
+            indecisos &= ~u;             // u = 1 > 0: el uniforme es mayor que p
+        }
+    }
+    return resultado;
+}
+
+// Un paso Monte Carlo (tablero de ajedrez, 64 espines por operación)
+void barridoMultiespin(RedMultiespin *r, double beta, GeneradorHilo generadores[]);
+
+// Energía y magnetización a partir de popcount
+double energiaMultiespin(const RedMultiespin *r);
+long magnetizacionMultiespin(const RedMultiespin *r);
+
+#endif
@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <math.h>
+#include "ising_nfold.h"
+
+// Clase del espín (i, j): (s * suma de vecinos + 4) / 2, entre 0 y 4
+static inline int claseEspin(const RedIsing *red, int i, int j) {
+    const int8_t *fila = filaRed(red, i);
+    int suma = filaRed(red, i - 1)[j] + filaRed(red, i + 1)[j] + fila[j - 1] + fila[j + 1];
+    return (fila[j] * suma + 4) / 2;
+}
+
+// Suma 'valor' en la posición k (0 .. num_sitios - 1) del árbol
+static inline void sumarArbol(int32_t *arbol, int num_sitios, int k, int valor) {
+    for (k++; k <= num_sitios; k += k & -k) {
+        arbol[k] += valor;
+    }
+}
+
+// Posición del espín número 'orden' (empezando en 0) de la clase: se baja
+// por el árbol de la mayor potencia de 2 a la menor
+static inline int buscarArbol(const int32_t *arbol, int num_sitios, int mayor_potencia, int orden) {
+    int posicion = 0, paso;
+    for (paso = mayor_potencia; paso > 0; paso >>= 1) {
+        if (posicion + paso <= num_sitios && arbol[posicion + paso] <= orden) {
+            posicion += paso;
+            orden -= arbol[posicion];
+        }
+    }
+    return posicion;
+}
+
+// Cambia el espín k a la clase que le corresponde ahora
+static inline void reclasificar(MotorNfold *m, const RedIsing *red, int k) {
+    int nueva = claseEspin(red, k / m->n, k % m->n);
+    int antigua = m->clase[k];
+    if (nueva != antigua) {
+        sumarArbol(m->arbol[antigua], m->num_sitios, k, -1);
+        sumarArbol(m->arbol[nueva], m->num_sitios, k, 1);
+        m->num_clase[antigua]--;
+        m->num_clase[nueva]++;
+        m->clase[k] = (int8_t)nueva;
+    }
+}
+
+int crearMotorNfold(MotorNfold *m, const RedIsing *red, double beta) {
+    int c, k;
+    m->n = red->n;
+    m->num_sitios = red->n * red->n;
+    m->inversiones = 0;
+    m->mayor_potencia = 1;
+    while (2 * m->mayor_potencia <= m->num_sitios) {
+        m->mayor_potencia *= 2;
+    }
+
+    m->clase = malloc((size_t)m->num_sitios);
+    for (c = 0; c < CLASES_NFOLD; c++) {
+        m->arbol[c] = calloc((size_t)m->num_sitios + 1, sizeof(int32_t));
+    }
+    for (c = 0; c < CLASES_NFOLD; c++) {
+        if (m->clase == NULL || m->arbol[c] == NULL) {
+            liberarMotorNfold(m);
+            return 1;
+        }
+    }
+
+    // Probabilidad de Metropolis de cada clase: deltaE = 2 * s * suma = 4 * (clase - 2)
+    for (c = 0; c < CLASES_NFOLD; c++) {
+        double deltaE = 4.0 * (c - 2);
+        m->tasa[c] = (deltaE <= 0) ? 1.0 : exp(-beta * deltaE);
+        m->num_clase[c] = 0;
+    }
+
+    // Hojas del árbol y después cada nodo sumado a su padre: O(n^2)
+    for (k = 0; k < m->num_sitios; k++) {
+        c = claseEspin(red, k / m->n, k % m->n);
+        m->clase[k] = (int8_t)c;
+        m->arbol[c][k + 1] = 1;
+        m->num_clase[c]++;
+    }
+    for (c = 0; c < CLASES_NFOLD; c++) {
+        for (k = 1; k <= m->num_sitios; k++) {
+            int padre = k + (k & -k);
+            if (padre <= m->num_sitios) {
+                m->arbol[c][padre] += m->arbol[c][k];
+            }
+        }
+    }
+    return 0;
+}
+
+void liberarMotorNfold(MotorNfold *m) {
+    int c;
+    free(m->clase);
+    m->clase = NULL;
+    for (c = 0; c < CLASES_NFOLD; c++) {
+        free(m->arbol[c]);
+        m->arbol[c] = NULL;
+    }
+}
+
+long barridoNfold(MotorNfold *m, RedIsing *red, GeneradorHilo *g, double *energia, long *magnetizacion) {
+    int n = m->n, c;
+    long inversiones = 0;
+    double tiempo = 0.0;
+
+    // El tiempo hasta el siguiente evento no tiene memoria: se sortea de nuevo
+    // al empezar cada paso y el motor no guarda nada entre pasos salvo la red
+    for (;;) {
+        double tasa_total = 0.0;
+        for (c = 0; c < CLASES_NFOLD; c++) {
+            tasa_total += m->num_clase[c] * m->tasa[c];
+        }
+        if (tasa_total <= 0.0) {
+            break; // Estado fundamental a T = 0: no se invierte nada más
+        }
+        tiempo -= log(1.0 - aleatorioUniforme(g)) / tasa_total;
+        if (tiempo >= 1.0) {
+            break;
+        }
+
+        // Clase con probabilidad proporcional a su tasa total (si el redondeo
+        // se sale del final, la última clase que puede invertirse)
+        double r = aleatorioUniforme(g) * tasa_total;
+        int elegida = -1;
+        for (c = 0; c < CLASES_NFOLD; c++) {
+            if (m->num_clase[c] > 0 && m->tasa[c] > 0.0) {
+                elegida = c;
+                r -= m->num_clase[c] * m->tasa[c];
+                if (r < 0.0) {
+                    break;
+                }
+            }
+        }
+
+        int orden = (int)aleatorioEntero(g, (uint32_t)m->num_clase[elegida]);
+        int k = buscarArbol(m->arbol[elegida], m->num_sitios, m->mayor_potencia, orden);
+        int i = k / n, j = k % n;
+        int espin = filaRed(red, i)[j];
+        // 2 * s * suma = 4 * (clase - 2)
+        *energia += 4 * (elegida - 2);
+        *magnetizacion -= 2 * espin;
+        fijarEspin(red, i, j, -espin);
+
+        // Solo cambian de clase el espín y sus cuatro vecinos
+        reclasificar(m, red, k);
+        reclasificar(m, red, ((i == 0) ? n - 1 : i - 1) * n + j);
+        reclasificar(m, red, ((i == n - 1) ? 0 : i + 1) * n + j);
+        reclasificar(m, red, i * n + ((j == 0) ? n - 1 : j - 1));
+        reclasificar(m, red, i * n + ((j == n - 1) ? 0 : j + 1));
+        inversiones++;
+    }
+
+    m->inversiones += inversiones;
+    return inversiones;
+}
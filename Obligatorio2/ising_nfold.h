@@ -0,0 +1,48 @@
+#ifndef ISING_NFOLD_H
+#define ISING_NFOLD_H
+
+#include <stdint.h>
+#include "aleatorio.h"
+#include "red_ising.h"
+
+// Algoritmo de n-fold way (Bortz, Kalos y Lebowitz) sobre la red n x n con
+// contorno periódico: Metropolis sin rechazos en tiempo continuo. Cada
+// espín está en una de 5 clases según s * (suma de vecinos) = -4, -2, 0, 2, 4,
+// y todos los de una clase se invierten con la misma probabilidad de
+// Metropolis. En cada evento se elige una clase con probabilidad
+// proporcional a su tasa total, un espín al azar dentro de ella, y se invierte
+// siempre; el reloj avanza el tiempo que Metropolis habría tardado en media
+// (en pasos Monte Carlo, una exponencial de media 1 / tasa total).
+// A temperatura baja casi todos los intentos de Metropolis se rechazan y
+// aquí no se hace ninguno.
+//
+// Los espines de cada clase se guardan en un árbol de Fenwick (conteos por
+// posición k = i * n + j): elegir el m-ésimo espín de una clase y mover un
+// espín de clase cuesta O(log n^2). La elección depende solo de la red, no
+// del orden de las inversiones anteriores, así que al continuar desde un
+// punto de control (que reconstruye el motor a partir de la red) se repite
+// exactamente la misma simulación.
+
+#define CLASES_NFOLD 5
+
+typedef struct {
+    int n;
+    int num_sitios;                     // n * n
+    int mayor_potencia;                 // Mayor potencia de 2 <= num_sitios (búsqueda en el árbol)
+    double tasa[CLASES_NFOLD];          // Probabilidad de Metropolis de cada clase
+    int num_clase[CLASES_NFOLD];        // Espines en cada clase
+    int32_t *arbol[CLASES_NFOLD];       // Árboles de Fenwick (índices 1 .. num_sitios)
+    int8_t *clase;                      // Clase de cada espín
+    long inversiones;                   // Inversiones hechas desde que se creó el motor
+} MotorNfold;
+
+// Clasifica los espines de la red a temperatura 1/beta. Devuelve 0 si todo va bien.
+int crearMotorNfold(MotorNfold *m, const RedIsing *red, double beta);
+void liberarMotorNfold(MotorNfold *m);
+
+// Avanza el reloj un paso Monte Carlo (el tiempo en que Metropolis hace n*n
+// intentos), invirtiendo un espín en cada evento. energia y magnetizacion se
+// actualizan con cada inversión. Devuelve el número de inversiones.
+long barridoNfold(MotorNfold *m, RedIsing *red, GeneradorHilo *g, double *energia, long *magnetizacion);
+
+#endif
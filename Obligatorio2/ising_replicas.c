@@ -0,0 +1,221 @@
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "ising_replicas.h"
+#include "ising_multiespin.h"
+
+int crearRedReplicas(RedReplicas *r, int n, int grupos, int sesgo, uint64_t semilla) {
+    int g, k, total = REPLICAS_POR_PALABRA * grupos;
+    size_t sitios = (size_t)n * n;
+
+    r->n = n;
+    r->grupos = grupos;
+    if (n < 2 || grupos < 1) {
+        r->bits = NULL;
+        r->generadores = NULL;
+        r->acumuladores = NULL;
+        return 1;
+    }
+    r->bits = malloc(sitios * grupos * sizeof(uint64_t));
+    r->generadores = malloc(grupos * sizeof(GeneradorHilo));
+    r->acumuladores = malloc(total * sizeof(AcumuladorObservables));
+    if (r->bits == NULL || r->generadores == NULL || r->acumuladores == NULL) {
+        liberarRedReplicas(r);
+        return 1;
+    }
+
+    // Cada bit de la red inicial vale 1 con probabilidad sesgo / 100, con el
+    // mismo sorteo bit a bit que las aceptaciones
+    uint64_t p_sesgo = (uint64_t)(sesgo / 100.0 * ldexp(1.0, BITS_PRECISION));
+    for (g = 0; g < grupos; g++) {
+        inicializarGeneradorFlujo(&r->generadores[g], semilla, (uint32_t)g, FLUJO_REPLICAS);
+        uint64_t *bits = r->bits + g * sitios;
+        size_t s;
+        for (s = 0; s < sitios; s++) {
+            bits[s] = (sesgo >= 100) ? ~0ULL : mascaraBernoulli(&r->generadores[g], ~0ULL, p_sesgo);
+        }
+    }
+    for (k = 0; k < total; k++) {
+        iniciarAcumulador(&r->acumuladores[k]);
+    }
+    return 0;
+}
+
+void liberarRedReplicas(RedReplicas *r) {
+    free(r->bits);
+    free(r->generadores);
+    free(r->acumuladores);
+    r->bits = NULL;
+    r->generadores = NULL;
+    r->acumuladores = NULL;
+}
+
+// Un recorrido secuencial de la red de un grupo: cada sitio en las 64 réplicas a la vez
+static void barridoGrupo(uint64_t *bits, int n, uint64_t p4, uint64_t p8, GeneradorHilo *g) {
+    int i, j;
+    for (i = 0; i < n; i++) {
+        uint64_t *fila = bits + (size_t)i * n;
+        const uint64_t *arriba = bits + (size_t)((i == 0) ? n - 1 : i - 1) * n;
+        const uint64_t *abajo = bits + (size_t)((i == n - 1) ? 0 : i + 1) * n;
+        for (j = 0; j < n; j++) {
+            uint64_t s = fila[j];
+
+            // a_k = 1 en las réplicas en que el vecino k es antiparalelo al espín
+            uint64_t a1 = s ^ arriba[j];
+            uint64_t a2 = s ^ abajo[j];
+            uint64_t a3 = s ^ fila[(j == 0) ? n - 1 : j - 1];
+            uint64_t a4 = s ^ fila[(j == n - 1) ? 0 : j + 1];
+
+            // Vecinos antiparalelos c (0..4) con sumadores de bits, como en
+            // ising_multiespin.c: deltaE = 8 - 4c, se acepta siempre si c >= 2
+            uint64_t s12 = a1 ^ a2, c12 = a1 & a2;
+            uint64_t s34 = a3 ^ a4, c34 = a3 & a4;
+            uint64_t invertir = c12 | c34 | (s12 & s34);
+            uint64_t con_uno = (s12 ^ s34) & ~(c12 | c34);
+            uint64_t con_ninguno = ~(a1 | a2 | a3 | a4);
+
+            if (con_uno) {
+                invertir |= mascaraBernoulli(g, con_uno, p4);     // deltaE = 4
+            }
+            if (con_ninguno) {
+                invertir |= mascaraBernoulli(g, con_ninguno, p8); // deltaE = 8
+            }
+            fila[j] = s ^ invertir;
+        }
+    }
+}
+
+void barridoReplicas(RedReplicas *r, double beta) {
+    double escala = ldexp(1.0, BITS_PRECISION);
+    uint64_t p4 = (uint64_t)(exp(-4.0 * beta) * escala);
+    uint64_t p8 = (uint64_t)(exp(-8.0 * beta) * escala);
+    size_t sitios = (size_t)r->n * r->n;
+    int g;
+
+    #pragma omp parallel for schedule(static)
+    for (g = 0; g < r->grupos; g++) {
+        barridoGrupo(r->bits + g * sitios, r->n, p4, p8, &r->generadores[g]);
+    }
+}
+
+// Suma 1 al contador de las réplicas con el bit a 1 en x (acarreo plano a plano)
+static inline void sumarContador(uint64_t planos[MAXIMO_PLANOS], uint64_t x) {
+    int p;
+    for (p = 0; x != 0; p++) {
+        uint64_t acarreo = planos[p] & x;
+        planos[p] ^= x;
+        x = acarreo;
+    }
+}
+
+// Valor del contador de la réplica b
+static inline long leerContador(const uint64_t planos[MAXIMO_PLANOS], int b) {
+    long valor = 0;
+    int p;
+    for (p = 0; p < MAXIMO_PLANOS; p++) {
+        valor |= (long)((planos[p] >> b) & 1) << p;
+    }
+    return valor;
+}
+
+void medirReplicas(const RedReplicas *r, double energia[], long magnetizacion[]) {
+    int n = r->n, g;
+    long sitios = (long)n * n;
+
+    #pragma omp parallel for schedule(static)
+    for (g = 0; g < r->grupos; g++) {
+        const uint64_t *bits = r->bits + g * sitios;
+        uint64_t positivos[MAXIMO_PLANOS] = {0}, antiparalelos[MAXIMO_PLANOS] = {0};
+        int i, j, b;
+
+        // Cada enlace se cuenta una vez: vecino de la derecha y vecino de abajo
+        for (i = 0; i < n; i++) {
+            const uint64_t *fila = bits + (size_t)i * n;
+            const uint64_t *abajo = bits + (size_t)((i == n - 1) ? 0 : i + 1) * n;
+            for (j = 0; j < n; j++) {
+                sumarContador(positivos, fila[j]);
+                sumarContador(antiparalelos, fila[j] ^ abajo[j]);
+                sumarContador(antiparalelos, fila[j] ^ fila[(j == n - 1) ? 0 : j + 1]);
+            }
+        }
+
+        // E = -(enlaces paralelos - enlaces antiparalelos), con 2 n^2 enlaces en total
+        for (b = 0; b < REPLICAS_POR_PALABRA; b++) {
+            int k = g * REPLICAS_POR_PALABRA + b;
+            energia[k] = -(2.0 * sitios - 2.0 * leerContador(antiparalelos, b));
+            magnetizacion[k] = 2 * leerContador(positivos, b) - sitios;
+        }
+    }
+}
+
+void ejecutarReplicas(RedReplicas *r, double beta, int pasos_termalizacion, int pasos_medida) {
+    int total = REPLICAS_POR_PALABRA * r->grupos, paso, k;
+    double *energia = malloc(total * sizeof(double));
+    long *magnetizacion = malloc(total * sizeof(long));
+    if (energia == NULL || magnetizacion == NULL) {
+        free(energia);
+        free(magnetizacion);
+        return;
+    }
+
+    for (paso = 0; paso < pasos_termalizacion; paso++) {
+        barridoReplicas(r, beta);
+    }
+    for (paso = 0; paso < pasos_medida; paso++) {
+        barridoReplicas(r, beta);
+        medirReplicas(r, energia, magnetizacion);
+        for (k = 0; k < total; k++) {
+            acumularMuestra(&r->acumuladores[k], energia[k], magnetizacion[k], r->n * r->n);
+        }
+    }
+
+    free(energia);
+    free(magnetizacion);
+}
+
+// e, |m|, C, chi y U de la réplica k
+static void observablesReplica(const RedReplicas *r, double beta, int k, double valores[5]) {
+    ResultadosObservables res;
+    calcularResultados(&r->acumuladores[k], beta, r->n * r->n, &res);
+    valores[0] = res.energia;
+    valores[1] = res.magnetizacion_abs;
+    valores[2] = res.calor_especifico;
+    valores[3] = res.susceptibilidad;
+    valores[4] = res.binder;
+}
+
+void escribirMediasReplicas(FILE *archivo, const RedReplicas *r, double beta) {
+    int total = REPLICAS_POR_PALABRA * r->grupos, k, o;
+    double suma[5] = {0}, suma2[5] = {0};
+    static const char *const nombres[5] = {"energia", "magnetizacion_abs", "calor_especifico",
+                                           "susceptibilidad", "binder"};
+
+    for (k = 0; k < total; k++) {
+        double valores[5];
+        observablesReplica(r, beta, k, valores);
+        for (o = 0; o < 5; o++) {
+            suma[o] += valores[o];
+            suma2[o] += valores[o] * valores[o];
+        }
+    }
+
+    fprintf(archivo, "# Media de %d réplicas y error estándar\n", total);
+    for (o = 0; o < 5; o++) {
+        double media = suma[o] / total;
+        double varianza = (total > 1) ? (suma2[o] - total * media * media) / (total - 1) : 0.0;
+        fprintf(archivo, "# %s %.8f +- %.8f\n", nombres[o], media, sqrt(fmax(varianza, 0.0) / total));
+    }
+}
+
+void escribirReplicas(FILE *archivo, const RedReplicas *r, double beta) {
+    int total = REPLICAS_POR_PALABRA * r->grupos, k;
+
+    fprintf(archivo, "# replica e |m| C chi U\n");
+    for (k = 0; k < total; k++) {
+        double valores[5];
+        observablesReplica(r, beta, k, valores);
+        fprintf(archivo, "%d %.8f %.8f %.6f %.6f %.6f\n", k, valores[0], valores[1], valores[2],
+                valores[3], valores[4]);
+    }
+    escribirMediasReplicas(archivo, r, beta);
+}
@@ -0,0 +1,60 @@
+#ifndef ISING_REPLICAS_H
+#define ISING_REPLICAS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "aleatorio.h"
+#include "observables.h"
+
+// Réplicas independientes con codificación multiespín entre réplicas: la
+// palabra de 64 bits del sitio (i, j) guarda ese mismo sitio en 64 redes
+// distintas (bit r -> réplica r; 1 -> espín +1, 0 -> espín -1). Un recorrido
+// de la red en el orden secuencial de siempre (fila a fila) actualiza las 64
+// réplicas con operaciones de bits. A diferencia de ising_multiespin.c, los
+// bits de una palabra no son vecinos entre sí: cada réplica ve su propia red
+// y se decide con sus propios bits aleatorios, así que las 64 son
+// simulaciones independientes a la misma (n, T) con distinta semilla.
+//
+// Con G grupos hay 64 * G réplicas; cada grupo tiene su generador y los
+// grupos se reparten entre los hilos, así que el resultado no depende del
+// número de hilos.
+
+#define REPLICAS_POR_PALABRA 64
+#define FLUJO_REPLICAS 0xFFFFFFFEu // Flujo de los grupos (hilo = grupo), distinto del de inicialización
+#define MAXIMO_PLANOS 40           // Bits de los contadores por réplica
+
+typedef struct {
+    int n;                      // Tamaño de cada red (n x n)
+    int grupos;                 // Grupos de 64 réplicas
+    uint64_t *bits;             // Sitio (i, j) del grupo g en bits[(g * n + i) * n + j]
+    GeneradorHilo *generadores; // Un flujo por grupo
+    AcumuladorObservables *acumuladores; // Observables de cada réplica
+} RedReplicas;
+
+// Reserva 64 * grupos réplicas n x n (n >= 2), cada una con un 'sesgo' por
+// ciento de espines +1 al azar. Devuelve 0 si todo va bien.
+int crearRedReplicas(RedReplicas *r, int n, int grupos, int sesgo, uint64_t semilla);
+void liberarRedReplicas(RedReplicas *r);
+
+// Un paso Monte Carlo de Metropolis en todas las réplicas (n*n sitios en
+// orden secuencial; cada sitio de un grupo se actualiza en las 64 réplicas a la vez)
+void barridoReplicas(RedReplicas *r, double beta);
+
+// Energía y magnetización de cada réplica (vectores de 64 * grupos). Se
+// cuentan con contadores en rodajas de bits: el bit r del plano p es la
+// cifra p del contador de la réplica r, así que cada sitio suma a las 64
+// réplicas con unas pocas operaciones lógicas.
+void medirReplicas(const RedReplicas *r, double energia[], long magnetizacion[]);
+
+// Simulación completa: pasos_termalizacion pasos sin medir y después
+// pasos_medida pasos acumulando los observables de cada réplica
+void ejecutarReplicas(RedReplicas *r, double beta, int pasos_termalizacion, int pasos_medida);
+
+// Media entre réplicas de cada observable con su error estándar (las
+// réplicas son independientes, así que no hace falta el análisis por bloques)
+void escribirMediasReplicas(FILE *archivo, const RedReplicas *r, double beta);
+
+// Una línea por réplica y, al final, las medias de escribirMediasReplicas
+void escribirReplicas(FILE *archivo, const RedReplicas *r, double beta);
+
+#endif
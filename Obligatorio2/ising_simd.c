@@ -0,0 +1,437 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "ising_simd.h"
+
+// Las rutas vectoriales se compilan con atributos target, de modo que el
+// fichero no necesita -mavx2 ni -mavx512bw y la CPU se comprueba al ejecutar
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ISING_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define ISING_SIMD_X86 0
+#endif
+
+// Alineación de cada fila (una línea de caché, un registro AVX-512)
+#define ALINEACION 64
+
+int crearRedSimd(RedSimd *r, int n) {
+    if (n <= 0 || n % 2 != 0) {
+        return 1;
+    }
+    r->n = n;
+    r->mitad = n / 2;
+    r->ruta = rutaSimd();
+    // mitad espines más la columna fantasma derecha; la izquierda de cada
+    // fila es el último byte del hueco de la fila anterior
+    r->paso = (r->mitad + 2 + ALINEACION - 1) / ALINEACION * ALINEACION;
+    size_t bytes_subred = ALINEACION + (size_t)n * r->paso;
+    r->memoria = aligned_alloc(ALINEACION, 2 * bytes_subred);
+    if (r->memoria == NULL) {
+        return 1;
+    }
+    memset(r->memoria, 0, 2 * bytes_subred);
+    r->subred[0] = r->memoria + ALINEACION;
+    r->subred[1] = r->memoria + bytes_subred + ALINEACION;
+    return 0;
+}
+
+void liberarRedSimd(RedSimd *r) {
+    free(r->memoria);
+    r->memoria = NULL;
+}
+
+// Copia periódica de los extremos de cada fila de un color en sus columnas fantasma
+static void actualizarFantasmas(RedSimd *r, int color) {
+    int i;
+    for (i = 0; i < r->n; i++) {
+        int8_t *fila = r->subred[color] + (size_t)i * r->paso;
+        fila[-1] = fila[r->mitad - 1];
+        fila[r->mitad] = fila[0];
+    }
+}
+
+void empaquetarRedSimd(RedSimd *r, const RedIsing *red) {
+    int i, j, n = r->n;
+    for (i = 0; i < n; i++) {
+        const int8_t *fila = filaRed(red, i);
+        for (j = 0; j < n; j++) {
+            int color = (i + j) % 2;
+            r->subred[color][(size_t)i * r->paso + j / 2] = fila[j];
+        }
+    }
+    actualizarFantasmas(r, 0);
+    actualizarFantasmas(r, 1);
+}
+
+void desempaquetarRedSimd(const RedSimd *r, RedIsing *red) {
+    int i, j, n = r->n;
+    for (i = 0; i < n; i++) {
+        int8_t *fila = filaRed(red, i);
+        for (j = 0; j < n; j++) {
+            int color = (i + j) % 2;
+            fila[j] = r->subred[color][(size_t)i * r->paso + j / 2];
+        }
+    }
+    actualizarBordes(red);
+}
+
+// Vecinos de la fila i del color 'color': filas de la otra subred encima y
+// debajo (mismo índice k) y, en la misma fila, el de la izquierda. El de la
+// derecha es el siguiente byte. El desplazamiento depende de en qué columna
+// empieza el color en esta fila.
+typedef struct {
+    int8_t *propia;
+    const int8_t *arriba;
+    const int8_t *abajo;
+    const int8_t *izquierda;
+} FilaSimd;
+
+static inline FilaSimd filaSimd(const RedSimd *r, int color, int i) {
+    FilaSimd f;
+    const int8_t *otra = r->subred[1 - color];
+    int desplazamiento = (i + color) % 2;
+    f.propia = r->subred[color] + (size_t)i * r->paso;
+    f.arriba = otra + (size_t)((i == 0) ? r->n - 1 : i - 1) * r->paso;
+    f.abajo = otra + (size_t)((i == r->n - 1) ? 0 : i + 1) * r->paso;
+    f.izquierda = otra + (size_t)i * r->paso + desplazamiento - 1;
+    return f;
+}
+
+// Un tramo de fila [desde, hasta). Se acepta siempre si x = s * suma <= 0;
+// si no, cuando el uniforme de 32 bits es menor que umbral[(x + 4) / 2].
+// Las rutas vectoriales usan esta misma función para el final de la fila.
+static void filaEscalar(FilaSimd f, const uint32_t *azar, const uint32_t umbral[5],
+                        int desde, int hasta, long *delta_energia, long *delta_magnetizacion) {
+    int k;
+    long de = 0, dm = 0;
+    for (k = desde; k < hasta; k++) {
+        int s = f.propia[k];
+        int x = s * (f.arriba[k] + f.abajo[k] + f.izquierda[k] + f.izquierda[k + 1]);
+        int acepta = (x <= 0) | (azar[k] < umbral[(x + 4) >> 1]);
+        de += acepta * 2 * x;
+        dm -= acepta * 2 * s;
+        f.propia[k] = (int8_t)(s * (1 - 2 * acepta));
+    }
+    *delta_energia += de;
+    *delta_magnetizacion += dm;
+}
+
+// Suma de s * (suma de vecinos) en un tramo de fila
+static long sumaEnlacesEscalar(FilaSimd f, int desde, int hasta) {
+    int k;
+    long suma = 0;
+    for (k = desde; k < hasta; k++) {
+        suma += f.propia[k] * (f.arriba[k] + f.abajo[k] + f.izquierda[k] + f.izquierda[k + 1]);
+    }
+    return suma;
+}
+
+#if ISING_SIMD_X86
+
+// Suma de los 32 bytes con signo de v, acumulada en 8 enteros de 32 bits
+__attribute__((target("avx2")))
+static inline __m256i sumarBytesAvx2(__m256i acumulado, __m256i v) {
+    __m256i pares = _mm256_maddubs_epi16(_mm256_set1_epi8(1), v);
+    return _mm256_add_epi32(acumulado, _mm256_madd_epi16(pares, _mm256_set1_epi16(1)));
+}
+
+__attribute__((target("avx2")))
+static inline long sumaHorizontalAvx2(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+}
+
+// x = s * (suma de los cuatro vecinos) para 32 espines; vpsignb multiplica por el signo de s
+__attribute__((target("avx2")))
+static inline __m256i energiaLocalAvx2(FilaSimd f, int k, __m256i *s) {
+    *s = _mm256_load_si256((const __m256i *)(f.propia + k));
+    __m256i suma = _mm256_add_epi8(
+        _mm256_add_epi8(_mm256_load_si256((const __m256i *)(f.arriba + k)),
+                        _mm256_load_si256((const __m256i *)(f.abajo + k))),
+        _mm256_add_epi8(_mm256_loadu_si256((const __m256i *)(f.izquierda + k)),
+                        _mm256_loadu_si256((const __m256i *)(f.izquierda + k + 1))));
+    return _mm256_sign_epi8(suma, *s);
+}
+
+// Umbral de aceptación de 8 espines: x se amplía a 32 bits, se busca
+// umbral[(x + 4) / 2] con una permutación y se compara con el uniforme.
+// AVX2 solo compara con signo, así que se invierte el bit de signo de ambos.
+__attribute__((target("avx2")))
+static inline __m256i aceptaOchoAvx2(__m128i x8, const uint32_t *azar, __m256i tabla) {
+    const __m256i signo = _mm256_set1_epi32((int)0x80000000u);
+    __m256i x = _mm256_cvtepi8_epi32(x8);
+    __m256i indice = _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(4)), 1);
+    __m256i limite = _mm256_permutevar8x32_epi32(tabla, indice);
+    __m256i u = _mm256_loadu_si256((const __m256i *)azar);
+    return _mm256_cmpgt_epi32(_mm256_xor_si256(limite, signo), _mm256_xor_si256(u, signo));
+}
+
+__attribute__((target("avx2")))
+static void filaAvx2(FilaSimd f, const uint32_t *azar, const uint32_t umbral[5], int mitad,
+                     long *delta_energia, long *delta_magnetizacion) {
+    const __m256i tabla = _mm256_setr_epi32((int)umbral[0], (int)umbral[1], (int)umbral[2],
+                                            (int)umbral[3], (int)umbral[4], 0, 0, 0);
+    // Orden de las palabras de 4 bytes tras empaquetar los cuatro grupos de 8
+    const __m256i reordenar = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i acumulado_e = _mm256_setzero_si256(), acumulado_m = _mm256_setzero_si256();
+    int k;
+
+    for (k = 0; k + 32 <= mitad; k += 32) {
+        __m256i s;
+        __m256i x = energiaLocalAvx2(f, k, &s);
+        __m128i bajo = _mm256_castsi256_si128(x), alto = _mm256_extracti128_si256(x, 1);
+
+        __m256i a0 = aceptaOchoAvx2(bajo, azar + k, tabla);
+        __m256i a1 = aceptaOchoAvx2(_mm_srli_si128(bajo, 8), azar + k + 8, tabla);
+        __m256i a2 = aceptaOchoAvx2(alto, azar + k + 16, tabla);
+        __m256i a3 = aceptaOchoAvx2(_mm_srli_si128(alto, 8), azar + k + 24, tabla);
+        // Máscaras de 32 bits (0 o -1) -> máscara de bytes, con saturación
+        __m256i acepta = _mm256_packs_epi16(_mm256_packs_epi32(a0, a1), _mm256_packs_epi32(a2, a3));
+        acepta = _mm256_permutevar8x32_epi32(acepta, reordenar);
+        acepta = _mm256_or_si256(acepta, _mm256_cmpgt_epi8(_mm256_set1_epi8(1), x));
+
+        // Negación condicional: (s ^ -1) - (-1) = -s
+        _mm256_store_si256((__m256i *)(f.propia + k), _mm256_sub_epi8(_mm256_xor_si256(s, acepta), acepta));
+        acumulado_e = sumarBytesAvx2(acumulado_e, _mm256_and_si256(x, acepta));
+        acumulado_m = sumarBytesAvx2(acumulado_m, _mm256_and_si256(s, acepta));
+    }
+
+    *delta_energia += 2 * sumaHorizontalAvx2(acumulado_e);
+    *delta_magnetizacion -= 2 * sumaHorizontalAvx2(acumulado_m);
+    filaEscalar(f, azar, umbral, k, mitad, delta_energia, delta_magnetizacion);
+}
+
+__attribute__((target("avx2")))
+static long sumaEnlacesAvx2(FilaSimd f, int mitad) {
+    __m256i acumulado = _mm256_setzero_si256();
+    int k;
+    for (k = 0; k + 32 <= mitad; k += 32) {
+        __m256i s;
+        acumulado = sumarBytesAvx2(acumulado, energiaLocalAvx2(f, k, &s));
+    }
+    return sumaHorizontalAvx2(acumulado) + sumaEnlacesEscalar(f, k, mitad);
+}
+
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+
+TARGET_AVX512
+static inline __m512i sumarBytesAvx512(__m512i acumulado, __m512i v) {
+    __m512i pares = _mm512_maddubs_epi16(_mm512_set1_epi8(1), v);
+    return _mm512_add_epi32(acumulado, _mm512_madd_epi16(pares, _mm512_set1_epi16(1)));
+}
+
+// Igual que en AVX2 pero con 64 espines y máscaras de bits: el final de la
+// fila se trata con cargas y escrituras enmascaradas en lugar de en escalar
+TARGET_AVX512
+static inline __m512i energiaLocalAvx512(FilaSimd f, int k, __mmask64 validos, __m512i *s) {
+    *s = _mm512_maskz_loadu_epi8(validos, f.propia + k);
+    __m512i suma = _mm512_add_epi8(
+        _mm512_add_epi8(_mm512_maskz_loadu_epi8(validos, f.arriba + k),
+                        _mm512_maskz_loadu_epi8(validos, f.abajo + k)),
+        _mm512_add_epi8(_mm512_maskz_loadu_epi8(validos, f.izquierda + k),
+                        _mm512_maskz_loadu_epi8(validos, f.izquierda + k + 1)));
+    // No hay vpsignb en AVX-512: se niega la suma donde s < 0
+    return _mm512_mask_sub_epi8(suma, _mm512_movepi8_mask(*s), _mm512_setzero_si512(), suma);
+}
+
+static inline __mmask64 mascaraTramo(int restantes) {
+    return (restantes >= 64) ? ~0ULL : (1ULL << restantes) - 1;
+}
+
+// Umbral de aceptación de 16 espines, como aceptaOchoAvx2 (AVX-512 ya compara sin signo)
+TARGET_AVX512
+static inline __mmask16 aceptaDieciseisAvx512(__m128i x8, const uint32_t *azar, __mmask64 validos, __m512i tabla) {
+    __m512i x = _mm512_cvtepi8_epi32(x8);
+    __m512i indice = _mm512_srai_epi32(_mm512_add_epi32(x, _mm512_set1_epi32(4)), 1);
+    __m512i limite = _mm512_permutexvar_epi32(indice, tabla);
+    __m512i u = _mm512_maskz_loadu_epi32((__mmask16)validos, azar);
+    return _mm512_cmplt_epu32_mask(u, limite);
+}
+
+TARGET_AVX512
+static void filaAvx512(FilaSimd f, const uint32_t *azar, const uint32_t umbral[5], int mitad,
+                       long *delta_energia, long *delta_magnetizacion) {
+    const __m512i tabla = _mm512_setr_epi32((int)umbral[0], (int)umbral[1], (int)umbral[2],
+                                            (int)umbral[3], (int)umbral[4], 0, 0, 0,
+                                            0, 0, 0, 0, 0, 0, 0, 0);
+    const __m512i cero = _mm512_setzero_si512();
+    __m512i acumulado_e = cero, acumulado_m = cero;
+    int k;
+
+    for (k = 0; k < mitad; k += 64) {
+        __mmask64 validos = mascaraTramo(mitad - k);
+        __m512i s;
+        __m512i x = energiaLocalAvx512(f, k, validos, &s);
+        __mmask64 acepta = _mm512_cmple_epi8_mask(x, cero);
+
+        // El índice de vextracti32x4 tiene que ser una constante
+        acepta |= (__mmask64)aceptaDieciseisAvx512(_mm512_extracti32x4_epi32(x, 0), azar + k, validos, tabla);
+        acepta |= (__mmask64)aceptaDieciseisAvx512(_mm512_extracti32x4_epi32(x, 1), azar + k + 16,
+                                                   validos >> 16, tabla) << 16;
+        acepta |= (__mmask64)aceptaDieciseisAvx512(_mm512_extracti32x4_epi32(x, 2), azar + k + 32,
+                                                   validos >> 32, tabla) << 32;
+        acepta |= (__mmask64)aceptaDieciseisAvx512(_mm512_extracti32x4_epi32(x, 3), azar + k + 48,
+                                                   validos >> 48, tabla) << 48;
+        acepta &= validos;
+
+        _mm512_mask_storeu_epi8(f.propia + k, acepta, _mm512_sub_epi8(cero, s));
+        acumulado_e = sumarBytesAvx512(acumulado_e, _mm512_maskz_mov_epi8(acepta, x));
+        acumulado_m = sumarBytesAvx512(acumulado_m, _mm512_maskz_mov_epi8(acepta, s));
+    }
+
+    *delta_energia += 2 * (long)_mm512_reduce_add_epi32(acumulado_e);
+    *delta_magnetizacion -= 2 * (long)_mm512_reduce_add_epi32(acumulado_m);
+}
+
+TARGET_AVX512
+static long sumaEnlacesAvx512(FilaSimd f, int mitad) {
+    __m512i acumulado = _mm512_setzero_si512();
+    int k;
+    for (k = 0; k < mitad; k += 64) {
+        __m512i s;
+        acumulado = sumarBytesAvx512(acumulado, energiaLocalAvx512(f, k, mascaraTramo(mitad - k), &s));
+    }
+    return _mm512_reduce_add_epi32(acumulado);
+}
+
+#endif
+
+static int rutaDisponible(RutaSimd ruta) {
+#if ISING_SIMD_X86
+    __builtin_cpu_init();
+    if (ruta == RUTA_AVX512) {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+    if (ruta == RUTA_AVX2) {
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+    return ruta == RUTA_ESCALAR;
+}
+
+RutaSimd rutaSimd(void) {
+    return rutaDisponible(RUTA_AVX512) ? RUTA_AVX512
+         : rutaDisponible(RUTA_AVX2)   ? RUTA_AVX2
+                                       : RUTA_ESCALAR;
+}
+
+const char *nombreRutaSimd(RutaSimd ruta) {
+    switch (ruta) {
+    case RUTA_AVX512: return "AVX-512BW";
+    case RUTA_AVX2: return "AVX2";
+    default: return "escalar";
+    }
+}
+
+// Un tramo de fila completo con la ruta indicada
+static void actualizarFila(RutaSimd ruta, FilaSimd f, const uint32_t *azar, const uint32_t umbral[5],
+                           int mitad, long *delta_energia, long *delta_magnetizacion) {
+#if ISING_SIMD_X86
+    if (ruta == RUTA_AVX512) {
+        filaAvx512(f, azar, umbral, mitad, delta_energia, delta_magnetizacion);
+        return;
+    }
+    if (ruta == RUTA_AVX2) {
+        filaAvx2(f, azar, umbral, mitad, delta_energia, delta_magnetizacion);
+        return;
+    }
+#endif
+    filaEscalar(f, azar, umbral, 0, mitad, delta_energia, delta_magnetizacion);
+}
+
+void barridoSimd(RedSimd *r, double beta, GeneradorHilo generadores[],
+                 double *energia, long *magnetizacion) {
+    uint32_t umbral[5];
+    long delta_energia = 0, delta_magnetizacion = 0;
+    int sin_memoria = 0;
+    int color, k;
+
+    // Probabilidad de aceptación en punto fijo de 32 bits (las entradas con
+    // x <= 0 no se consultan: esos espines se invierten siempre)
+    for (k = 0; k < 5; k++) {
+        double p = (k <= 2) ? 1.0 : exp(-beta * 2 * (2 * k - 4));
+        umbral[k] = (p >= 1.0) ? UINT32_MAX : (uint32_t)ldexp(p, 32);
+    }
+
+    for (color = 0; color < 2; color++) {
+        // Mismo reparto de filas que barridoTablero: con el mismo número de
+        // hilos cada ruta usa los mismos números para los mismos espines
+        #pragma omp parallel reduction(+:delta_energia, delta_magnetizacion)
+        {
+            GeneradorHilo *g = &generadores[omp_get_thread_num()];
+            uint32_t *azar = aligned_alloc(ALINEACION, (size_t)r->paso * sizeof(uint32_t));
+            int i;
+
+            if (azar == NULL) {
+                #pragma omp atomic write
+                sin_memoria = 1;
+            }
+            // Todos los hilos ven si alguno se ha quedado sin memoria antes de
+            // tocar la red, así que el barrido se abandona sin cambios a medias
+            #pragma omp barrier
+            if (!sin_memoria) {
+                #pragma omp for schedule(static)
+                for (i = 0; i < r->n; i++) {
+                    rellenarAleatorios32(g, azar, r->mitad);
+                    actualizarFila(r->ruta, filaSimd(r, color, i), azar, umbral, r->mitad,
+                                   &delta_energia, &delta_magnetizacion);
+                }
+            }
+            free(azar);
+        }
+        if (sin_memoria) {
+            fprintf(stderr, "Error al reservar memoria para los números aleatorios del barrido SIMD.\n");
+            exit(1);
+        }
+        actualizarFantasmas(r, color);
+    }
+
+    *energia += delta_energia;
+    *magnetizacion += delta_magnetizacion;
+}
+
+// Cada enlace une una casilla negra con una blanca, así que basta sumar
+// s * (suma de vecinos) sobre las negras, con la misma ruta que el barrido
+double energiaSimd(const RedSimd *r) {
+    long suma = 0;
+    int i;
+
+    #pragma omp parallel for reduction(+:suma)
+    for (i = 0; i < r->n; i++) {
+        FilaSimd f = filaSimd(r, 0, i);
+#if ISING_SIMD_X86
+        if (r->ruta == RUTA_AVX512) {
+            suma += sumaEnlacesAvx512(f, r->mitad);
+            continue;
+        }
+        if (r->ruta == RUTA_AVX2) {
+            suma += sumaEnlacesAvx2(f, r->mitad);
+            continue;
+        }
+#endif
+        suma += sumaEnlacesEscalar(f, 0, r->mitad);
+    }
+    return -(double)suma;
+}
+
+long magnetizacionSimd(const RedSimd *r) {
+    long magnetizacion = 0;
+    int color, i, k;
+    #pragma omp parallel for collapse(2) reduction(+:magnetizacion) private(k)
+    for (color = 0; color < 2; color++) {
+        for (i = 0; i < r->n; i++) {
+            const int8_t *fila = r->subred[color] + (size_t)i * r->paso;
+            int suma = 0; // El compilador vectoriza este bucle
+            for (k = 0; k < r->mitad; k++) {
+                suma += fila[k];
+            }
+            magnetizacion += suma;
+        }
+    }
+    return magnetizacion;
+}
@@ -0,0 +1,55 @@
+#ifndef ISING_SIMD_H
+#define ISING_SIMD_H
+
+#include <stdint.h>
+#include "aleatorio.h"
+#include "red_ising.h"
+
+// Implementaciones del barrido, de la más lenta a la más rápida
+typedef enum {
+    RUTA_ESCALAR,
+    RUTA_AVX2,    // 32 espines por instrucción
+    RUTA_AVX512   // 64 espines por instrucción (AVX-512BW)
+} RutaSimd;
+
+// Red de Ising con un espín por byte (+1/-1 en int8_t), separada en las dos
+// subredes del tablero de ajedrez. La fila i de la subred c guarda, en orden,
+// las columnas j con (i + j) % 2 == c: el elemento k es la columna
+// 2k + (i + c) % 2. Los cuatro vecinos de un espín son elementos de la otra
+// subred con el mismo k (arriba y abajo) o contiguos (izquierda y derecha),
+// así que una fila entera se procesa con cargas vectoriales normales.
+// Cada fila empieza alineada a 64 bytes y tiene una columna fantasma a cada
+// lado con la copia periódica del extremo opuesto.
+typedef struct {
+    int n;                 // Tamaño de la red (n x n), n par
+    int mitad;             // Espines de cada color por fila (n / 2)
+    int paso;              // Bytes entre el comienzo de dos filas consecutivas
+    int8_t *memoria;       // Bloque reservado para las dos subredes
+    int8_t *subred[2];     // subred[c] + i * paso: primer espín de la fila i del color c
+    RutaSimd ruta;         // Implementación del barrido, elegida al crear la red
+} RedSimd;
+
+// Reserva una red de n x n espines (n debe ser par). Devuelve 0 si todo va bien.
+int crearRedSimd(RedSimd *r, int n);
+void liberarRedSimd(RedSimd *r);
+
+// Conversión desde/hacia la red de un byte por espín (del mismo tamaño)
+void empaquetarRedSimd(RedSimd *r, const RedIsing *red);
+void desempaquetarRedSimd(const RedSimd *r, RedIsing *red);
+
+// La ruta más rápida que admite la CPU. crearRedSimd la guarda en la red
+// (fuera de cualquier región paralela) y barridoSimd solo la lee.
+RutaSimd rutaSimd(void);
+const char *nombreRutaSimd(RutaSimd ruta);
+
+// Un paso Monte Carlo (tablero de ajedrez). energia y magnetizacion se
+// actualizan con las inversiones aceptadas. Todas las rutas consumen los
+// mismos números aleatorios, así que con la misma semilla dan la misma red.
+void barridoSimd(RedSimd *r, double beta, GeneradorHilo generadores[],
+                 double *energia, long *magnetizacion);
+
+// Energía y magnetización de la red, con la misma ruta vectorial que el barrido
+double energiaSimd(const RedSimd *r);
+long magnetizacionSimd(const RedSimd *r);
+
+#endif
@@ -0,0 +1,212 @@
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "ising_templado.h"
+
+int algoritmoTempladoValido(int algoritmo) {
+    return algoritmo == ALGORITMO_ALEATORIO || algoritmo == ALGORITMO_TABLERO ||
+           algoritmo == ALGORITMO_MULTIESPIN || algoritmo == ALGORITMO_SIMD;
+}
+
+int crearTempladoParalelo(TempladoParalelo *tp, int n, int replicas, double t_min, double t_max, int algoritmo,
+                          uint64_t semilla) {
+    int r, h;
+
+    if (n < 2 || replicas < 2 || t_min <= 0 || t_max <= t_min || !algoritmoTempladoValido(algoritmo)) {
+        return 1;
+    }
+    tp->n = n;
+    tp->replicas = replicas;
+    tp->algoritmo = algoritmo;
+    tp->hilos = omp_get_max_threads();
+    tp->creadas = 0;
+    tp->beta = malloc(replicas * sizeof(double));
+    tp->red = malloc(replicas * sizeof(RedIsing));
+    tp->motores = malloc(replicas * sizeof(MotorIsing));
+    tp->energia = malloc(replicas * sizeof(double));
+    tp->magnetizacion = malloc(replicas * sizeof(long));
+    tp->replica_en = malloc(replicas * sizeof(int));
+    tp->temperatura_de = malloc(replicas * sizeof(int));
+    tp->intentos = calloc(replicas, sizeof(long));
+    tp->aceptados = calloc(replicas, sizeof(long));
+    tp->acumuladores = malloc(replicas * sizeof(AcumuladorObservables));
+    tp->generadores = malloc((size_t)replicas * tp->hilos * sizeof(GeneradorHilo));
+    if (tp->beta == NULL || tp->red == NULL || tp->motores == NULL || tp->energia == NULL ||
+        tp->magnetizacion == NULL || tp->replica_en == NULL || tp->temperatura_de == NULL ||
+        tp->intentos == NULL || tp->aceptados == NULL || tp->acumuladores == NULL || tp->generadores == NULL) {
+        liberarTempladoParalelo(tp);
+        return 1;
+    }
+
+    // Flujos (semilla, h, r) para los barridos de la réplica r,
+    // (semilla, FLUJO_INICIALIZACION, r) para su red inicial y
+    // (semilla, FLUJO_INICIALIZACION, R) para los intercambios
+    inicializarGeneradorFlujo(&tp->generador_intercambios, semilla, FLUJO_INICIALIZACION, (uint32_t)replicas);
+    for (r = 0; r < replicas; r++) {
+        // Progresión geométrica: más temperaturas donde T es baja
+        double temperatura = t_min * pow(t_max / t_min, (double)r / (replicas - 1));
+        GeneradorHilo generador_inicial;
+        tp->beta[r] = 1.0 / temperatura;
+        tp->replica_en[r] = r;
+        tp->temperatura_de[r] = r;
+        iniciarAcumulador(&tp->acumuladores[r]);
+        for (h = 0; h < tp->hilos; h++) {
+            inicializarGeneradorFlujo(&tp->generadores[(size_t)r * tp->hilos + h], semilla, (uint32_t)h, (uint32_t)r);
+        }
+
+        if (crearRedIsing(&tp->red[r], n) != 0) {
+            liberarTempladoParalelo(tp);
+            return 1;
+        }
+        inicializarGeneradorFlujo(&generador_inicial, semilla, FLUJO_INICIALIZACION, (uint32_t)r);
+        inicializarRed(&tp->red[r], 50, &generador_inicial);
+        if (crearMotorIsing(&tp->motores[r], algoritmo, &tp->red[r], tp->beta[r]) != 0) {
+            liberarRedIsing(&tp->red[r]);
+            liberarTempladoParalelo(tp);
+            return 1;
+        }
+        tp->creadas++;
+
+        // Energía y magnetización iniciales; después se siguen con cada inversión
+        medirMotor(&tp->motores[r], &tp->red[r], &tp->energia[r], &tp->magnetizacion[r]);
+    }
+    return 0;
+}
+
+void liberarTempladoParalelo(TempladoParalelo *tp) {
+    int r;
+    for (r = 0; r < tp->creadas; r++) {
+        liberarMotorIsing(&tp->motores[r]);
+        liberarRedIsing(&tp->red[r]);
+    }
+    tp->creadas = 0;
+    free(tp->beta);
+    free(tp->red);
+    free(tp->motores);
+    free(tp->energia);
+    free(tp->magnetizacion);
+    free(tp->replica_en);
+    free(tp->temperatura_de);
+    free(tp->intentos);
+    free(tp->aceptados);
+    free(tp->acumuladores);
+    free(tp->generadores);
+    tp->red = NULL;
+    tp->motores = NULL;
+}
+
+// Paso Monte Carlo de una réplica con el barrido compartido, a la
+// temperatura que tiene ahora. Dentro de barridoTempladoParalelo las
+// regiones paralelas del barrido tienen un solo hilo y usan el primer
+// generador de la réplica.
+static void barridoReplica(TempladoParalelo *tp, int r) {
+    MotorIsing *motor = &tp->motores[r];
+    motor->beta = tp->beta[tp->temperatura_de[r]];
+    pasoMonteCarlo(motor, &tp->red[r], &tp->generadores[(size_t)r * tp->hilos],
+                   &tp->energia[r], &tp->magnetizacion[r]);
+}
+
+void barridoTempladoParalelo(TempladoParalelo *tp) {
+    int r;
+    // Una o varias réplicas por hilo; cada réplica usa su propio generador
+    #pragma omp parallel for schedule(dynamic)
+    for (r = 0; r < tp->replicas; r++) {
+        barridoReplica(tp, r);
+    }
+}
+
+void intercambiarTemperaturas(TempladoParalelo *tp, int paridad) {
+    int t;
+    for (t = paridad; t < tp->replicas - 1; t += 2) {
+        int a = tp->replica_en[t], b = tp->replica_en[t + 1];
+        // P = min(1, exp((beta_t - beta_{t+1}) (E_a - E_b)))
+        double exponente = (tp->beta[t] - tp->beta[t + 1]) * (tp->energia[a] - tp->energia[b]);
+
+        tp->intentos[t]++;
+        if (exponente >= 0 || aleatorioUniforme(&tp->generador_intercambios) < exp(exponente)) {
+            tp->replica_en[t] = b;
+            tp->replica_en[t + 1] = a;
+            tp->temperatura_de[a] = t + 1;
+            tp->temperatura_de[b] = t;
+            tp->aceptados[t]++;
+        }
+    }
+}
+
+void ajustarEscalera(TempladoParalelo *tp) {
+    int R = tp->replicas, t;
+    double *separacion = malloc((R - 1) * sizeof(double));
+    double total = 0, nuevo_total = 0;
+
+    if (separacion == NULL) {
+        return;
+    }
+
+    // La aceptación de una pareja es aproximadamente exp(-c * dbeta^2), así que
+    // dividir cada separación entre sqrt(-ln A) tiende a igualar las aceptaciones.
+    // A se limita a [0.01, 0.95] para que una pareja sin intercambios no rompa la escalera.
+    for (t = 0; t < R - 1; t++) {
+        double aceptacion = (tp->intentos[t] > 0) ? (double)tp->aceptados[t] / tp->intentos[t] : 0;
+        if (aceptacion < 0.01) {
+            aceptacion = 0.01;
+        } else if (aceptacion > 0.95) {
+            aceptacion = 0.95;
+        }
+        separacion[t] = (tp->beta[t] - tp->beta[t + 1]) / sqrt(-log(aceptacion));
+        total += tp->beta[t] - tp->beta[t + 1];
+        nuevo_total += separacion[t];
+    }
+
+    // Se conserva el intervalo total de beta
+    for (t = 0; t < R - 2; t++) {
+        tp->beta[t + 1] = tp->beta[t] - separacion[t] * total / nuevo_total;
+    }
+
+    for (t = 0; t < R - 1; t++) {
+        tp->intentos[t] = 0;
+        tp->aceptados[t] = 0;
+    }
+    free(separacion);
+}
+
+void ejecutarTempladoParalelo(TempladoParalelo *tp, int pasos_ajuste, int intervalo_ajuste,
+                              int pasos_medida, int intervalo_intercambio) {
+    int paso, t, paridad = 0;
+
+    for (paso = 0; paso < pasos_ajuste + pasos_medida; paso++) {
+        barridoTempladoParalelo(tp);
+
+        if ((paso + 1) % intervalo_intercambio == 0) {
+            intercambiarTemperaturas(tp, paridad);
+            paridad = 1 - paridad;
+        }
+
+        if (paso < pasos_ajuste) {
+            if ((paso + 1) % intervalo_ajuste == 0) {
+                ajustarEscalera(tp);
+            }
+            continue;
+        }
+
+        // Las medidas se guardan por temperatura, sea cual sea la réplica que está en ella
+        for (t = 0; t < tp->replicas; t++) {
+            int r = tp->replica_en[t];
+            acumularMuestra(&tp->acumuladores[t], tp->energia[r], tp->magnetizacion[r], tp->n * tp->n);
+        }
+    }
+}
+
+void escribirTempladoParalelo(FILE *archivo, const TempladoParalelo *tp) {
+    int t;
+    fprintf(archivo, "# T <e> <e^2> <|m|> <m^2> <m^4> C chi U aceptacion(T,T+1)\n");
+    // De menor a mayor temperatura
+    for (t = 0; t < tp->replicas; t++) {
+        ResultadosObservables r;
+        double aceptacion = (t < tp->replicas - 1 && tp->intentos[t] > 0)
+                            ? (double)tp->aceptados[t] / tp->intentos[t] : 0;
+        calcularResultados(&tp->acumuladores[t], tp->beta[t], tp->n * tp->n, &r);
+        fprintf(archivo, "%.6f %.8f %.8f %.8f %.8f %.8f %.8f %.8f %.8f %.4f\n",
+                1.0 / tp->beta[t], r.energia, r.energia2, r.magnetizacion_abs, r.magnetizacion2,
+                r.magnetizacion4, r.calor_especifico, r.susceptibilidad, r.binder, aceptacion);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef ISING_TEMPLADO_H
+#define ISING_TEMPLADO_H
+
+#include <stdio.h>
+#include "aleatorio.h"
+#include "observables.h"
+#include "red_ising.h"
+#include "simulacion_ising.h"
+
+// Templado paralelo (intercambio de réplicas): R redes n x n simuladas a la
+// vez, cada una a una temperatura de la escalera. Cada cierto número de pasos
+// se proponen intercambios entre temperaturas vecinas con el criterio de
+// Metropolis. Se intercambian las etiquetas de temperatura, no las redes.
+// Cada réplica es una RedIsing con su MotorIsing, así que se barre con el
+// mismo código que el resto del programa (tablero, multiespín o SIMD).
+typedef struct {
+    int n;                    // Tamaño de cada red (n x n)
+    int replicas;             // Número de réplicas (= número de temperaturas)
+    int algoritmo;            // ALGORITMO_* de los barridos (ver algoritmoTempladoValido)
+    int hilos;                // Generadores de cada réplica
+    double *beta;             // beta de cada temperatura, de menor a mayor T
+    RedIsing *red;            // Red de cada réplica
+    MotorIsing *motores;      // Motor de cada réplica (su beta cambia con los intercambios)
+    int creadas;              // Réplicas con la red y el motor reservados
+    double *energia;          // Energía de cada réplica
+    long *magnetizacion;      // Magnetización de cada réplica
+    int *replica_en;          // replica_en[t]: réplica que está a la temperatura t
+    int *temperatura_de;      // temperatura_de[r]: temperatura de la réplica r
+    long *intentos;           // Intercambios propuestos entre t y t + 1
+    long *aceptados;          // Intercambios aceptados entre t y t + 1
+    AcumuladorObservables *acumuladores; // Observables de cada temperatura
+    GeneradorHilo *generadores; // hilos flujos por réplica, (semilla, hilo, r): reproducible con cualquier número de hilos
+    GeneradorHilo generador_intercambios;
+} TempladoParalelo;
+
+// 1 si el algoritmo sirve para las réplicas: uno de Metropolis que lee beta
+// en cada barrido (aleatorio, tablero, multiespín o SIMD). Los de cluster y
+// el n-fold way fijan la temperatura al crear el motor.
+int algoritmoTempladoValido(int algoritmo);
+
+// Reserva R réplicas con temperaturas en progresión geométrica entre
+// t_min y t_max, redes aleatorias y el algoritmo dado. Devuelve 0 si todo va
+// bien (falla sin memoria, con un algoritmo no válido o si necesita n par y no lo es).
+int crearTempladoParalelo(TempladoParalelo *tp, int n, int replicas, double t_min, double t_max, int algoritmo,
+                          uint64_t semilla);
+void liberarTempladoParalelo(TempladoParalelo *tp);
+
+// Un paso Monte Carlo de todas las réplicas (repartidas entre los hilos; el
+// barrido de cada réplica, dentro de la región paralela, usa un solo hilo)
+void barridoTempladoParalelo(TempladoParalelo *tp);
+
+// Propone intercambios entre las parejas (t, t + 1) con t de la paridad dada
+void intercambiarTemperaturas(TempladoParalelo *tp, int paridad);
+
+// Redistribuye las temperaturas intermedias para igualar la aceptación de
+// los intercambios entre parejas (los extremos no se mueven) y reinicia las estadísticas
+void ajustarEscalera(TempladoParalelo *tp);
+
+// Simulación completa: pasos_ajuste pasos adaptando la escalera cada
+// intervalo_ajuste pasos, y después pasos_medida pasos acumulando observables.
+// Se proponen intercambios cada intervalo_intercambio pasos.
+void ejecutarTempladoParalelo(TempladoParalelo *tp, int pasos_ajuste, int intervalo_ajuste,
+                              int pasos_medida, int intervalo_intercambio);
+
+// Una línea por temperatura: T, observables y aceptación del intercambio con la siguiente
+void escribirTempladoParalelo(FILE *archivo, const TempladoParalelo *tp);
+
+#endif
@@ -0,0 +1,450 @@
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "ising_wang_landau.h"
+
+#define MAXIMO_PASOS_ENTRADA 100000 // Pasos para llevar un caminante a su ventana antes de rendirse
+#define ANCHO_MINIMO_VENTANA 8      // Bins por ventana como mínimo
+
+// Energía de la red (cada enlace una vez, con el borde fantasma)
+static long energiaRed(const RedIsing *red) {
+    long energia = 0;
+    int i, j;
+    for (i = 0; i < red->n; i++) {
+        const int8_t *fila = filaRed(red, i);
+        const int8_t *abajo = filaRed(red, i + 1);
+        for (j = 0; j < red->n; j++) {
+            energia -= fila[j] * (abajo[j] + fila[j + 1]);
+        }
+    }
+    return energia;
+}
+
+// Bin global de la energía actual del caminante
+static inline int binCaminante(const CaminanteWangLandau *c, int num_espines) {
+    return (int)((c->energia + 2L * num_espines) / 4);
+}
+
+// Distancia en bins de 'bin' a la ventana del caminante (0 si está dentro)
+static inline int distanciaVentana(const CaminanteWangLandau *c, int bin) {
+    if (bin < c->bin_minimo) {
+        return c->bin_minimo - bin;
+    }
+    return (bin > c->bin_maximo) ? bin - c->bin_maximo : 0;
+}
+
+// Inversiones al azar que nunca alejan la energía de la ventana, hasta entrar
+// en ella. Devuelve 0 si lo consigue.
+static int llevarAVentana(CaminanteWangLandau *c, int num_espines) {
+    int n = c->red.n, bin = binCaminante(c, num_espines);
+    long intento, maximo = (long)MAXIMO_PASOS_ENTRADA * num_espines;
+
+    for (intento = 0; intento < maximo && distanciaVentana(c, bin) > 0; intento++) {
+        int i = aleatorioEntero(&c->generador, n);
+        int j = aleatorioEntero(&c->generador, n);
+        int8_t *fila = filaRed(&c->red, i);
+        int suma_vecinos = filaRed(&c->red, i - 1)[j] + filaRed(&c->red, i + 1)[j] + fila[j - 1] + fila[j + 1];
+        int delta_energia = 2 * fila[j] * suma_vecinos;
+        if (distanciaVentana(c, bin + delta_energia / 4) <= distanciaVentana(c, bin)) {
+            fijarEspin(&c->red, i, j, -fila[j]);
+            c->energia += delta_energia;
+            bin += delta_energia / 4;
+        }
+    }
+    return distanciaVentana(c, bin) > 0;
+}
+
+int crearWangLandau(WangLandau *wl, int n, int ventanas, double log_f_final, uint64_t semilla) {
+    int w, i, j;
+
+    wl->n = n;
+    wl->num_espines = n * n;
+    wl->num_bins = n * n + 1;
+    wl->ventanas = ventanas;
+    wl->log_f_final = log_f_final;
+    wl->caminantes = NULL;
+    wl->intentos = NULL;
+    wl->aceptados = NULL;
+    if (n < 2 || ventanas < 1 || log_f_final <= 0) {
+        return 1;
+    }
+
+    // Ventanas del mismo ancho; cada una empieza (1 - SOLAPE) anchos después de la anterior
+    double avance = 1.0 - SOLAPE_VENTANAS;
+    int ancho = (int)ceil(wl->num_bins / (1.0 + (ventanas - 1) * avance));
+    if (ancho < ANCHO_MINIMO_VENTANA) {
+        return 1;
+    }
+
+    wl->caminantes = calloc(ventanas, sizeof(CaminanteWangLandau));
+    wl->intentos = calloc(ventanas, sizeof(long));
+    wl->aceptados = calloc(ventanas, sizeof(long));
+    if (wl->caminantes == NULL || wl->intentos == NULL || wl->aceptados == NULL) {
+        liberarWangLandau(wl);
+        return 1;
+    }
+
+    // Flujos (semilla, 0, w) para los caminantes y (semilla, 1, 0) para los intercambios
+    inicializarGeneradorFlujo(&wl->generador_intercambios, semilla, 1, 0);
+    for (w = 0; w < ventanas; w++) {
+        CaminanteWangLandau *c = &wl->caminantes[w];
+        c->bin_minimo = (int)lround(w * ancho * avance);
+        c->bin_maximo = (w == ventanas - 1) ? wl->num_bins - 1 : c->bin_minimo + ancho - 1;
+        c->log_f = LOG_F_INICIAL;
+        inicializarGeneradorFlujo(&c->generador, semilla, 0, (uint32_t)w);
+
+        int bins = c->bin_maximo - c->bin_minimo + 1;
+        c->log_densidad = calloc(bins, sizeof(double));
+        c->histograma = calloc(bins, sizeof(long));
+        if (c->log_densidad == NULL || c->histograma == NULL || crearRedIsing(&c->red, n) != 0) {
+            liberarWangLandau(wl);
+            return 1;
+        }
+
+        // Se parte del extremo más cercano (la red ordenada o el tablero de
+        // ajedrez, de energía mínima y máxima), desde el que se llega a
+        // cualquier ventana invirtiendo espines al azar
+        int arriba = c->bin_minimo + c->bin_maximo > wl->num_bins - 1;
+        for (i = 0; i < n; i++) {
+            int8_t *fila = filaRed(&c->red, i);
+            for (j = 0; j < n; j++) {
+                fila[j] = (arriba && (i + j) % 2 != 0) ? -1 : 1;
+            }
+        }
+        actualizarBordes(&c->red);
+        c->energia = energiaRed(&c->red);
+        if (llevarAVentana(c, wl->num_espines) != 0) {
+            liberarWangLandau(wl);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void liberarWangLandau(WangLandau *wl) {
+    int w;
+    if (wl->caminantes != NULL) {
+        for (w = 0; w < wl->ventanas; w++) {
+            free(wl->caminantes[w].log_densidad);
+            free(wl->caminantes[w].histograma);
+            liberarRedIsing(&wl->caminantes[w].red);
+        }
+    }
+    free(wl->caminantes);
+    free(wl->intentos);
+    free(wl->aceptados);
+    wl->caminantes = NULL;
+    wl->intentos = NULL;
+    wl->aceptados = NULL;
+}
+
+// Un paso Monte Carlo (n*n intentos en posiciones aleatorias) dentro de la
+// ventana. Si actualizar es 0, g(E) no cambia (el caminante ya ha terminado
+// y solo sigue moviéndose para los intercambios).
+static void barridoCaminante(CaminanteWangLandau *c, int actualizar) {
+    int n = c->red.n, ancho = c->bin_maximo - c->bin_minimo + 1;
+    int bin = binCaminante(c, n * n) - c->bin_minimo;
+    long total = (long)n * n, k;
+    double *log_densidad = c->log_densidad;
+
+    for (k = 0; k < total; k++) {
+        int i = aleatorioEntero(&c->generador, n);
+        int j = aleatorioEntero(&c->generador, n);
+        int8_t *fila = filaRed(&c->red, i);
+        int suma_vecinos = filaRed(&c->red, i - 1)[j] + filaRed(&c->red, i + 1)[j] + fila[j - 1] + fila[j + 1];
+        int delta_energia = 2 * fila[j] * suma_vecinos;
+        int nuevo = bin + delta_energia / 4;
+
+        // P = min(1, g(E) / g(E')), sin salir de la ventana
+        if (nuevo >= 0 && nuevo < ancho &&
+            (log_densidad[nuevo] <= log_densidad[bin] ||
+             aleatorioUniforme(&c->generador) < exp(log_densidad[bin] - log_densidad[nuevo]))) {
+            fijarEspin(&c->red, i, j, -fila[j]);
+            c->energia += delta_energia;
+            bin = nuevo;
+        }
+        if (actualizar) {
+            log_densidad[bin] += c->log_f;
+            c->histograma[bin]++;
+        }
+    }
+    c->pasos++;
+}
+
+// Reduce f si el histograma de las energías visitadas alguna vez es plano, y
+// pasa a ln f = 1/t cuando f baja de 1/t
+static void comprobarPlanitud(CaminanteWangLandau *c) {
+    int ancho = c->bin_maximo - c->bin_minimo + 1, k, visitados = 0;
+    long minimo = -1, suma = 0;
+    double t = (double)c->pasos * c->red.n * c->red.n / ancho; // Intentos por bin
+
+    if (c->fase_1_t) {
+        c->log_f = 1.0 / t;
+        return;
+    }
+    for (k = 0; k < ancho; k++) {
+        if (c->log_densidad[k] > 0) {
+            visitados++;
+            suma += c->histograma[k];
+            if (minimo < 0 || c->histograma[k] < minimo) {
+                minimo = c->histograma[k];
+            }
+        }
+    }
+    if (visitados == 0 || minimo < PLANITUD_WANG_LANDAU * suma / visitados) {
+        return;
+    }
+
+    c->log_f *= 0.5;
+    c->reducciones++;
+    for (k = 0; k < ancho; k++) {
+        c->histograma[k] = 0;
+    }
+    if (c->log_f < 1.0 / t) {
+        c->fase_1_t = 1;
+        c->log_f = 1.0 / t;
+    }
+}
+
+// ln g del caminante en el bin global 'bin'
+static inline double logDensidadEn(const CaminanteWangLandau *c, int bin) {
+    return c->log_densidad[bin - c->bin_minimo];
+}
+
+// Intercambio de configuraciones entre las ventanas w y w + 1 (con w de la
+// paridad dada) si cada energía cae en la ventana del otro
+static void intercambiarVentanas(WangLandau *wl, int paridad) {
+    int w;
+    for (w = paridad; w < wl->ventanas - 1; w += 2) {
+        CaminanteWangLandau *a = &wl->caminantes[w], *b = &wl->caminantes[w + 1];
+        int bin_a = binCaminante(a, wl->num_espines), bin_b = binCaminante(b, wl->num_espines);
+        if (distanciaVentana(a, bin_b) > 0 || distanciaVentana(b, bin_a) > 0) {
+            continue;
+        }
+
+        // P = min(1, g_a(E_a) g_b(E_b) / (g_a(E_b) g_b(E_a)))
+        double exponente = logDensidadEn(a, bin_a) - logDensidadEn(a, bin_b) +
+                           logDensidadEn(b, bin_b) - logDensidadEn(b, bin_a);
+        wl->intentos[w]++;
+        if (exponente >= 0 || aleatorioUniforme(&wl->generador_intercambios) < exp(exponente)) {
+            RedIsing red = a->red;
+            long energia = a->energia;
+            a->red = b->red;
+            a->energia = b->energia;
+            b->red = red;
+            b->energia = energia;
+            wl->aceptados[w]++;
+        }
+    }
+}
+
+void ejecutarWangLandau(WangLandau *wl, int intervalo, FILE *progreso) {
+    int w, paridad = 0, terminado = 0;
+    double ultimo = 2.0 * LOG_F_INICIAL;
+
+    while (!terminado) {
+        // Cada caminante usa su propio generador: el resultado no depende de los hilos
+        #pragma omp parallel for schedule(dynamic)
+        for (w = 0; w < wl->ventanas; w++) {
+            CaminanteWangLandau *c = &wl->caminantes[w];
+            int paso, actualizar = c->log_f >= wl->log_f_final;
+            for (paso = 0; paso < intervalo; paso++) {
+                barridoCaminante(c, actualizar);
+            }
+            if (actualizar) {
+                comprobarPlanitud(c);
+            }
+        }
+
+        intercambiarVentanas(wl, paridad);
+        paridad = 1 - paridad;
+
+        double mayor = 0.0;
+        for (w = 0; w < wl->ventanas; w++) {
+            mayor = fmax(mayor, wl->caminantes[w].log_f);
+        }
+        terminado = mayor < wl->log_f_final;
+        if (progreso != NULL && (mayor <= 0.5 * ultimo || terminado)) {
+            fprintf(progreso, "ln f = %.3g en la ventana más lenta, %ld pasos por caminante\n", mayor,
+                    wl->caminantes[0].pasos);
+            fflush(progreso);
+            ultimo = mayor;
+        }
+    }
+}
+
+// ln(sum_k e^(x_k)) sin desbordamientos (los -INFINITY no suman)
+static double sumaLogaritmica(const double *x, int num) {
+    double maximo = -INFINITY, suma = 0.0;
+    int k;
+    for (k = 0; k < num; k++) {
+        maximo = fmax(maximo, x[k]);
+    }
+    if (maximo == -INFINITY) {
+        return -INFINITY;
+    }
+    for (k = 0; k < num; k++) {
+        suma += exp(x[k] - maximo);
+    }
+    return maximo + log(suma);
+}
+
+int unirVentanas(const WangLandau *wl, DensidadEstados *d) {
+    int w, k;
+
+    d->lado = wl->n;
+    d->num_espines = wl->num_espines;
+    d->energia_minima = -2L * wl->num_espines;
+    d->paso_energia = 4;
+    d->num_bins = wl->num_bins;
+    d->log_densidad = malloc(d->num_bins * sizeof(double));
+    if (d->log_densidad == NULL) {
+        return 1;
+    }
+    for (k = 0; k < d->num_bins; k++) {
+        d->log_densidad[k] = -INFINITY;
+    }
+
+    // La primera ventana tal cual; cada una de las siguientes se desplaza para
+    // coincidir con la anterior en el bin del solape donde las pendientes de
+    // ln g se parecen más, y sustituye a la anterior desde ese bin
+    const CaminanteWangLandau *primera = &wl->caminantes[0];
+    for (k = primera->bin_minimo; k <= primera->bin_maximo; k++) {
+        if (logDensidadEn(primera, k) > 0) {
+            d->log_densidad[k] = logDensidadEn(primera, k);
+        }
+    }
+    for (w = 1; w < wl->ventanas; w++) {
+        const CaminanteWangLandau *c = &wl->caminantes[w];
+        int union_bin = -1;
+        double mejor = INFINITY;
+        for (k = c->bin_minimo; k < wl->caminantes[w - 1].bin_maximo; k++) {
+            if (d->log_densidad[k] == -INFINITY || d->log_densidad[k + 1] == -INFINITY ||
+                logDensidadEn(c, k) <= 0 || logDensidadEn(c, k + 1) <= 0) {
+                continue;
+            }
+            double diferencia = fabs((d->log_densidad[k + 1] - d->log_densidad[k]) -
+                                     (logDensidadEn(c, k + 1) - logDensidadEn(c, k)));
+            if (diferencia < mejor) {
+                mejor = diferencia;
+                union_bin = k;
+            }
+        }
+        if (union_bin < 0) {
+            liberarDensidadEstados(d);
+            return 1;
+        }
+        double desplazamiento = d->log_densidad[union_bin] - logDensidadEn(c, union_bin);
+        for (k = union_bin; k <= c->bin_maximo; k++) {
+            d->log_densidad[k] = (logDensidadEn(c, k) > 0) ? logDensidadEn(c, k) + desplazamiento : -INFINITY;
+        }
+    }
+
+    // sum_E g(E) = 2^N
+    double desplazamiento = wl->num_espines * log(2.0) - sumaLogaritmica(d->log_densidad, d->num_bins);
+    for (k = 0; k < d->num_bins; k++) {
+        d->log_densidad[k] += desplazamiento;
+    }
+    return 0;
+}
+
+int guardarDensidadEstados(const char *ruta, const DensidadEstados *d) {
+    int k;
+    FILE *archivo = fopen(ruta, "w");
+    if (archivo == NULL) {
+        return 1;
+    }
+    fprintf(archivo, "lado %d\nnum_espines %d\npaso_energia %d\n", d->lado, d->num_espines, d->paso_energia);
+    fprintf(archivo, "# E ln_g(E)  (normalizada a sum_E g(E) = 2^N; solo las energías visitadas)\n");
+    for (k = 0; k < d->num_bins; k++) {
+        if (d->log_densidad[k] != -INFINITY) {
+            fprintf(archivo, "%ld %.12f\n", d->energia_minima + (long)k * d->paso_energia, d->log_densidad[k]);
+        }
+    }
+    return fclose(archivo) != 0;
+}
+
+int leerDensidadEstados(const char *ruta, DensidadEstados *d) {
+    char linea[256];
+    long e;
+    double log_g;
+    int k, leidas = 0;
+    FILE *archivo = fopen(ruta, "r");
+    if (archivo == NULL) {
+        return 1;
+    }
+    d->lado = d->num_espines = d->num_bins = 0;
+    d->paso_energia = 4;
+    d->log_densidad = NULL;
+    while (fgets(linea, sizeof(linea), archivo) != NULL) {
+        if (linea[0] == '#' || sscanf(linea, "lado %d", &d->lado) == 1 ||
+            sscanf(linea, "paso_energia %d", &d->paso_energia) == 1) {
+            continue;
+        }
+        if (sscanf(linea, "num_espines %d", &d->num_espines) == 1) {
+            // Todas las energías posibles, E = -2N ... 2N
+            d->energia_minima = -2L * d->num_espines;
+            d->num_bins = (int)(4L * d->num_espines / d->paso_energia) + 1;
+            free(d->log_densidad);
+            d->log_densidad = malloc(d->num_bins * sizeof(double));
+            if (d->log_densidad == NULL) {
+                break;
+            }
+            for (k = 0; k < d->num_bins; k++) {
+                d->log_densidad[k] = -INFINITY;
+            }
+            continue;
+        }
+        if (sscanf(linea, "%ld %lf", &e, &log_g) != 2 || d->log_densidad == NULL) {
+            break;
+        }
+        long bin = (e - d->energia_minima) / d->paso_energia;
+        if (bin < 0 || bin >= d->num_bins) {
+            break;
+        }
+        d->log_densidad[bin] = log_g;
+        leidas++;
+    }
+    fclose(archivo);
+    if (leidas == 0) {
+        liberarDensidadEstados(d);
+        return 1;
+    }
+    return 0;
+}
+
+void liberarDensidadEstados(DensidadEstados *d) {
+    free(d->log_densidad);
+    d->log_densidad = NULL;
+}
+
+void calcularTermodinamica(const DensidadEstados *d, double t, Termodinamica *res) {
+    double beta = 1.0 / t, maximo = -INFINITY, z = 0.0, energia = 0.0, varianza = 0.0;
+    double n = d->num_espines;
+    int k;
+
+    // Pesos e^(ln g(E) - beta E) relativos al mayor, para que no desborden
+    for (k = 0; k < d->num_bins; k++) {
+        maximo = fmax(maximo, d->log_densidad[k] - beta * (double)(d->energia_minima + (long)k * d->paso_energia));
+    }
+    for (k = 0; k < d->num_bins; k++) {
+        double e = (double)(d->energia_minima + (long)k * d->paso_energia);
+        double peso = exp(d->log_densidad[k] - beta * e - maximo);
+        z += peso;
+        energia += peso * e;
+    }
+    energia /= z;
+    for (k = 0; k < d->num_bins; k++) {
+        double e = (double)(d->energia_minima + (long)k * d->paso_energia);
+        double peso = exp(d->log_densidad[k] - beta * e - maximo);
+        varianza += peso * (e - energia) * (e - energia);
+    }
+    varianza /= z;
+
+    // ln Z = maximo + ln z;  F = -T ln Z;  S = (U - F) / T
+    double energia_libre = -t * (maximo + log(z));
+    res->energia_libre = energia_libre / n;
+    res->energia = energia / n;
+    res->calor_especifico = beta * beta * varianza / n;
+    res->entropia = (energia - energia_libre) / (t * n);
+}
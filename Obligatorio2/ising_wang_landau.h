@@ -0,0 +1,86 @@
+#ifndef ISING_WANG_LANDAU_H
+#define ISING_WANG_LANDAU_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "aleatorio.h"
+#include "red_ising.h"
+
+// Densidad de estados g(E) de la red cuadrada n x n (contorno periódico) con
+// el algoritmo de Wang y Landau: un paseo aleatorio en energía que acepta
+// cada inversión con min(1, g(E) / g(E')) y suma ln f a ln g(E) en cada
+// paso. Cuando el histograma de visitas es plano, f se reduce; al final,
+// ln g(E) es la densidad de estados salvo una constante. Con g(E) se obtiene
+// cualquier magnitud térmica (F, U, C, S) a cualquier T sin más simulaciones.
+//
+// El intervalo de energías se parte en ventanas que se solapan, cada una con
+// su caminante (repartidos entre los hilos con OpenMP). Los caminantes de
+// ventanas vecinas intercambian configuraciones de vez en cuando, y al final
+// las ventanas se unen por el punto del solape en que mejor coinciden las
+// pendientes de ln g. Cuando f baja de 1/t (t en pasos por bin) se sigue con
+// ln f = 1/t (Belardinelli y Pereyra), que evita que el error se estanque.
+//
+// Las energías son E = -2 N + 4 k (N = n^2): el bin k es (E + 2 N) / 4.
+
+#define SOLAPE_VENTANAS 0.75     // Fracción de cada ventana compartida con la siguiente
+#define PLANITUD_WANG_LANDAU 0.8 // Histograma plano: mínimo >= 0.8 * media
+#define LOG_F_INICIAL 1.0
+
+typedef struct {
+    RedIsing red;
+    long energia;
+    int bin_minimo, bin_maximo;  // Ventana de energías (bins globales, incluidos)
+    double *log_densidad;        // ln g de cada bin de la ventana (0 si nunca visitado)
+    long *histograma;            // Visitas desde la última reducción de f
+    double log_f;
+    int reducciones;             // Veces que se ha reducido f
+    int fase_1_t;                // 1 si ya sigue ln f = 1/t
+    long pasos;                  // Pasos Monte Carlo (n*n intentos) hechos
+    GeneradorHilo generador;
+} CaminanteWangLandau;
+
+typedef struct {
+    int n, num_espines;
+    int num_bins;                // N + 1 (bins de E = -2N a E = 2N)
+    int ventanas;
+    double log_f_final;
+    CaminanteWangLandau *caminantes;
+    long *intentos, *aceptados;  // Intercambios entre las ventanas w y w + 1
+    GeneradorHilo generador_intercambios;
+} WangLandau;
+
+// Densidad de estados normalizada (sum_E g(E) = 2^N), la que se guarda y se lee
+typedef struct {
+    int lado, num_espines;
+    long energia_minima;         // E del bin 0
+    int paso_energia;            // Separación entre energías consecutivas (4)
+    int num_bins;
+    double *log_densidad;        // ln g(E); -INFINITY en las energías no visitadas
+} DensidadEstados;
+
+// Magnitudes por espín a temperatura T
+typedef struct {
+    double energia_libre, energia, calor_especifico, entropia;
+} Termodinamica;
+
+// Reparte las energías en 'ventanas' ventanas y lleva cada caminante a la
+// suya desde una red aleatoria. Devuelve 0 si todo va bien.
+int crearWangLandau(WangLandau *wl, int n, int ventanas, double log_f_final, uint64_t semilla);
+void liberarWangLandau(WangLandau *wl);
+
+// Hasta que todas las ventanas bajan de log_f_final: intervalo pasos de cada
+// caminante, comprobación de planitud e intercambios entre ventanas vecinas.
+// Si progreso no es NULL, escribe una línea cada vez que baja el mayor ln f.
+void ejecutarWangLandau(WangLandau *wl, int intervalo, FILE *progreso);
+
+// Une las ventanas y normaliza. Devuelve 0 si todo va bien.
+int unirVentanas(const WangLandau *wl, DensidadEstados *d);
+
+int guardarDensidadEstados(const char *ruta, const DensidadEstados *d);
+int leerDensidadEstados(const char *ruta, DensidadEstados *d);
+void liberarDensidadEstados(DensidadEstados *d);
+
+// F, U, C y S por espín a temperatura t (k_B = 1)
+void calcularTermodinamica(const DensidadEstados *d, double t, Termodinamica *res);
+
+#endif
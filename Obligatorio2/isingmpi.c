@@ -0,0 +1,393 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <mpi.h>
+#include <omp.h>
+#include "aleatorio.h"
+#include "observables.h"
+#include "trayectoria.h"
+#include "parametros_ising.h"
+
+// Modelo de Ising con la red repartida en franjas de filas entre procesos MPI.
+// Cada proceso actualiza su franja con el tablero de ajedrez de ising.c y en
+// cada medio barrido solo intercambia con sus vecinos una fila fantasma por
+// lado; mientras llegan se actualizan las filas interiores.
+//
+// Compilación: mpicc -O3 -march=native -fopenmp isingmpi.c observables.c trayectoria.c -o isingmpi -lm
+// Ejecución:   mpirun -np 4 ./isingmpi [n] [T] [semilla]
+//
+// Los números aleatorios de cada fila salen del flujo Philox (semilla, fila,
+// 2 * paso + color), que no depende de cómo se reparta la red: con la misma
+// semilla el resultado es idéntico con cualquier número de procesos o hilos,
+// y con -np 1 sirve de referencia secuencial.
+
+// N, T, K_BOLTZMANN, pasosmontecarlo y errorobjetivo son los de ising.c (parametros_ising.h)
+
+// Alineación de cada fila
+#define ALINEACION 64
+
+// Etiquetas de los mensajes de las filas fantasma
+#define ETIQUETA_HACIA_ARRIBA 1
+#define ETIQUETA_HACIA_ABAJO 2
+
+// Franja de filas [inicio, inicio + filas) de una red n x n. Igual que
+// RedIsing (red_ising.h), con un borde fantasma alrededor: las columnas -1
+// y n son copias periódicas de la propia fila, y las filas -1 y 'filas' son
+// las últimas/primeras filas de los procesos vecinos.
+typedef struct {
+    int n;
+    int filas;
+    int inicio;
+    ptrdiff_t paso;
+    int8_t *memoria;
+    int8_t *espines;
+} FranjaIsing;
+
+static inline int8_t *filaFranja(const FranjaIsing *f, int i) {
+    return f->espines + i * f->paso;
+}
+
+// Reparte n filas entre 'procesos' lo más igualado posible
+static int crearFranja(FranjaIsing *f, int n, int proceso, int procesos) {
+    f->n = n;
+    f->inicio = (int)((long)proceso * n / procesos);
+    f->filas = (int)((long)(proceso + 1) * n / procesos) - f->inicio;
+    f->paso = (n + 2 + ALINEACION - 1) / ALINEACION * ALINEACION;
+    size_t bytes = ALINEACION + (size_t)(f->filas + 2) * f->paso;
+    f->memoria = aligned_alloc(ALINEACION, bytes);
+    if (f->memoria == NULL) {
+        return 1;
+    }
+    memset(f->memoria, 1, bytes);
+    f->espines = f->memoria + ALINEACION + f->paso;
+    return 0;
+}
+
+static void liberarFranja(FranjaIsing *f) {
+    free(f->memoria);
+    f->memoria = NULL;
+}
+
+// Columnas fantasma de las filas propias
+static void actualizarColumnas(FranjaIsing *f) {
+    int i;
+    for (i = 0; i < f->filas; i++) {
+        int8_t *fila = filaFranja(f, i);
+        fila[-1] = fila[f->n - 1];
+        fila[f->n] = fila[0];
+    }
+}
+
+// Red aleatoria: cada fila global tiene su propio flujo de inicialización
+static void inicializarFranja(FranjaIsing *f, uint64_t semilla) {
+    int i, j;
+    for (i = 0; i < f->filas; i++) {
+        GeneradorHilo g;
+        int8_t *fila = filaFranja(f, i);
+        inicializarGeneradorFlujo(&g, semilla, (uint32_t)(f->inicio + i), FLUJO_INICIALIZACION);
+        for (j = 0; j < f->n; j++) {
+            fila[j] = (aleatorioEntero(&g, 100) < 50) ? 1 : -1;
+        }
+    }
+    actualizarColumnas(f);
+}
+
+// Intercambio de filas fantasma con los procesos de arriba y de abajo
+// (periódico: el primero y el último son vecinos). Se inicia sin esperar.
+static void iniciarIntercambio(FranjaIsing *f, int proceso, int procesos, MPI_Request peticiones[4]) {
+    int arriba = (proceso + procesos - 1) % procesos;
+    int abajo = (proceso + 1) % procesos;
+    MPI_Irecv(filaFranja(f, -1), f->n, MPI_INT8_T, arriba, ETIQUETA_HACIA_ABAJO, MPI_COMM_WORLD, &peticiones[0]);
+    MPI_Irecv(filaFranja(f, f->filas), f->n, MPI_INT8_T, abajo, ETIQUETA_HACIA_ARRIBA, MPI_COMM_WORLD, &peticiones[1]);
+    MPI_Isend(filaFranja(f, 0), f->n, MPI_INT8_T, arriba, ETIQUETA_HACIA_ARRIBA, MPI_COMM_WORLD, &peticiones[2]);
+    MPI_Isend(filaFranja(f, f->filas - 1), f->n, MPI_INT8_T, abajo, ETIQUETA_HACIA_ABAJO, MPI_COMM_WORLD, &peticiones[3]);
+}
+
+// Actualiza los espines de un color en una fila local, con el flujo de esa fila
+static void actualizarFila(FranjaIsing *f, int i, int color, const double tabla[5], uint64_t semilla,
+                           long paso_mc, long *delta_energia, long *delta_magnetizacion) {
+    int global = f->inicio + i;
+    int8_t *fila = filaFranja(f, i);
+    const int8_t *arriba = filaFranja(f, i - 1);
+    const int8_t *abajo = filaFranja(f, i + 1);
+    GeneradorHilo g;
+    int m;
+
+    inicializarGeneradorFlujo(&g, semilla, (uint32_t)global, (uint32_t)(2 * paso_mc + color));
+    for (m = (global + color) % 2; m < f->n; m += 2) {
+        int suma_vecinos = arriba[m] + abajo[m] + fila[m - 1] + fila[m + 1];
+        int acepta = aleatorioUniforme(&g) < tabla[(fila[m] * suma_vecinos + 4) / 2];
+        *delta_energia += acepta * 2 * fila[m] * suma_vecinos;
+        *delta_magnetizacion -= acepta * 2 * fila[m];
+        fila[m] = (int8_t)(fila[m] * (1 - 2 * acepta));
+    }
+}
+
+// Un paso Monte Carlo de la franja. En cada medio barrido se piden las filas
+// fantasma (con el otro color ya actualizado), se actualizan las filas que
+// no las necesitan y después la primera y la última.
+static void barridoFranja(FranjaIsing *f, int proceso, int procesos, const double tabla[5],
+                          uint64_t semilla, long paso_mc, long *delta_energia, long *delta_magnetizacion) {
+    int color;
+    long de = 0, dm = 0;
+
+    for (color = 0; color < 2; color++) {
+        MPI_Request peticiones[4];
+        int i;
+
+        iniciarIntercambio(f, proceso, procesos, peticiones);
+
+        #pragma omp parallel for reduction(+:de, dm) schedule(static)
+        for (i = 1; i < f->filas - 1; i++) {
+            actualizarFila(f, i, color, tabla, semilla, paso_mc, &de, &dm);
+        }
+
+        MPI_Waitall(4, peticiones, MPI_STATUSES_IGNORE);
+        actualizarFila(f, 0, color, tabla, semilla, paso_mc, &de, &dm);
+        if (f->filas > 1) {
+            actualizarFila(f, f->filas - 1, color, tabla, semilla, paso_mc, &de, &dm);
+        }
+        actualizarColumnas(f);
+    }
+
+    *delta_energia = de;
+    *delta_magnetizacion = dm;
+}
+
+// Energía y magnetización de toda la red con la misma definición que
+// calcularEnergia de ising.c (enlaces con el vecino de abajo y el de la derecha)
+static void energiaGlobal(FranjaIsing *f, int proceso, int procesos, double *energia, long *magnetizacion) {
+    MPI_Request peticiones[4];
+    long locales[2] = {0, 0}, globales[2];
+    int i, j;
+
+    iniciarIntercambio(f, proceso, procesos, peticiones);
+    MPI_Waitall(4, peticiones, MPI_STATUSES_IGNORE);
+
+    for (i = 0; i < f->filas; i++) {
+        const int8_t *fila = filaFranja(f, i);
+        const int8_t *abajo = filaFranja(f, i + 1);
+        for (j = 0; j < f->n; j++) {
+            locales[0] -= fila[j] * (abajo[j] + fila[j + 1]);
+            locales[1] += fila[j];
+        }
+    }
+    MPI_Allreduce(locales, globales, 2, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    *energia = (double)globales[0];
+    *magnetizacion = globales[1];
+}
+
+// Reúne la red completa en el proceso 0 y la guarda como un fotograma
+static void guardarRedFinal(FranjaIsing *f, int proceso, int procesos, const char *ruta, double temperatura,
+                            uint64_t semilla) {
+    int n = f->n, i;
+    int8_t *propia = malloc((size_t)f->filas * n);
+    int8_t *completa = NULL;
+    int *cuentas = NULL, *desplazamientos = NULL;
+
+    for (i = 0; i < f->filas; i++) {
+        memcpy(propia + (size_t)i * n, filaFranja(f, i), n);
+    }
+    if (proceso == 0) {
+        completa = malloc((size_t)n * n);
+        cuentas = malloc(procesos * sizeof(int));
+        desplazamientos = malloc(procesos * sizeof(int));
+        for (i = 0; i < procesos; i++) {
+            int inicio = (int)((long)i * n / procesos);
+            int fin = (int)((long)(i + 1) * n / procesos);
+            cuentas[i] = (fin - inicio) * n;
+            desplazamientos[i] = inicio * n;
+        }
+    }
+    MPI_Gatherv(propia, f->filas * n, MPI_INT8_T, completa, cuentas, desplazamientos, MPI_INT8_T, 0, MPI_COMM_WORLD);
+
+    if (proceso == 0) {
+        EscritorTrayectoria trayectoria;
+        if (abrirTrayectoriaEscritura(&trayectoria, ruta, n, temperatura, semilla) != 0 ||
+            escribirFotogramaFilas(&trayectoria, completa, n) != 0 ||
+            cerrarTrayectoriaEscritura(&trayectoria) != 0) {
+            fprintf(stderr, "Error al guardar la red en %s.\n", ruta);
+        }
+    }
+    free(propia);
+    free(completa);
+    free(cuentas);
+    free(desplazamientos);
+}
+
+// Lee [n] [T] [semilla] de la línea de órdenes (solo el proceso 0).
+// Devuelve 0 si todo va bien; si no, explica el error en stderr.
+static int leerArgumentos(int argc, char *argv[], int *n, double *temperatura, uint64_t *semilla) {
+    char *fin;
+    if (argc > 1) {
+        errno = 0;
+        long leido = strtol(argv[1], &fin, 10);
+        if (errno != 0 || fin == argv[1] || *fin != '\0' || leido < 2 || leido > INT_MAX) {
+            fprintf(stderr, "Tamaño de red no válido: '%s'.\n", argv[1]);
+            return 1;
+        }
+        *n = (int)leido;
+    }
+    if (argc > 2) {
+        errno = 0;
+        *temperatura = strtod(argv[2], &fin);
+        if (errno != 0 || fin == argv[2] || *fin != '\0' || !isfinite(*temperatura) || *temperatura <= 0) {
+            fprintf(stderr, "Temperatura no válida: '%s' (tiene que ser un número positivo).\n", argv[2]);
+            return 1;
+        }
+    }
+    if (argc > 3) {
+        // strtoull aceptaría un signo menos
+        errno = 0;
+        unsigned long long leida = strtoull(argv[3], &fin, 10);
+        if (argv[3][0] < '0' || argv[3][0] > '9' || errno != 0 || *fin != '\0') {
+            fprintf(stderr, "Semilla no válida: '%s' (tiene que ser un entero sin signo).\n", argv[3]);
+            return 1;
+        }
+        *semilla = (uint64_t)leida;
+    }
+    if (argc > 4) {
+        fprintf(stderr, "Uso: %s [n] [T] [semilla]\n", argv[0]);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int proceso, procesos, k;
+    long i;
+
+    // Los hilos de OpenMP no llaman a MPI: todas las llamadas las hace el hilo principal
+    int nivel_hilos;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &nivel_hilos);
+    MPI_Comm_rank(MPI_COMM_WORLD, &proceso);
+    MPI_Comm_size(MPI_COMM_WORLD, &procesos);
+    if (nivel_hilos < MPI_THREAD_FUNNELED) {
+        if (proceso == 0) {
+            fprintf(stderr, "La biblioteca MPI no admite hilos (MPI_THREAD_FUNNELED).\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // El proceso 0 lee los argumentos y los reparte: todos usan sus valores
+    int n = N, error = 0;
+    double temperatura = T;
+    uint64_t semilla = (uint64_t)time(NULL);
+    if (proceso == 0) {
+        error = leerArgumentos(argc, argv, &n, &temperatura, &semilla);
+    }
+    MPI_Bcast(&error, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (error) {
+        MPI_Finalize();
+        return 1;
+    }
+    MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&temperatura, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&semilla, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    double beta = 1.0 / (K_BOLTZMANN * temperatura);
+
+    // El tablero de ajedrez necesita n par; cada proceso necesita al menos una fila
+    if (n < 2 || n % 2 != 0 || procesos > n) {
+        if (proceso == 0) {
+            fprintf(stderr, "Hace falta n par y al menos tantas filas como procesos (n = %d, %d procesos).\n",
+                    n, procesos);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    FranjaIsing franja;
+    if (crearFranja(&franja, n, proceso, procesos) != 0) {
+        fprintf(stderr, "Proceso %d: error al reservar la franja.\n", proceso);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    inicializarFranja(&franja, semilla);
+
+    double tabla[5];
+    for (k = 0; k < 5; k++) {
+        double deltaE = 2 * (2 * k - 4);
+        tabla[k] = (deltaE <= 0) ? 1.0 : exp(-beta * deltaE);
+    }
+
+    double energia_actual;
+    long magnetizacion_actual;
+    energiaGlobal(&franja, proceso, procesos, &energia_actual, &magnetizacion_actual);
+
+    // El análisis (termalización, medias y errores) lo hace el proceso 0
+    static AnalisisSimulacion analisis;
+    FILE *archivo_energias = NULL;
+    if (proceso == 0) {
+        printf("Red %d x %d en %d procesos (%d hilos cada uno), T = %.4f, semilla %llu\n",
+               n, n, procesos, omp_get_max_threads(), temperatura, (unsigned long long)semilla);
+        if (iniciarAnalisis(&analisis) != 0) {
+            fprintf(stderr, "Error al reservar las series de la termalización.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        archivo_energias = fopen("energias_mpi.txt", "w");
+        if (archivo_energias == NULL) {
+            fprintf(stderr, "Error al abrir el archivo para guardar las energías.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    long pasos = 0;
+    double inicio = MPI_Wtime();
+    for (i = 0; i < pasosmontecarlo; i++) {
+        long locales[2], globales[2];
+        barridoFranja(&franja, proceso, procesos, tabla, semilla, i, &locales[0], &locales[1]);
+        MPI_Allreduce(locales, globales, 2, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+        energia_actual += globales[0];
+        magnetizacion_actual += globales[1];
+        pasos++;
+
+        int parar = 0;
+        if (proceso == 0) {
+            int termalizado = analisis.termalizado;
+            anadirMedida(&analisis, energia_actual, magnetizacion_actual, n * n);
+            if (!termalizado && analisis.termalizado) {
+                printf("Termalización detectada en el paso %ld (MSER descarta los %ld primeros).\n",
+                       i, analisis.corte);
+            }
+            fprintf(archivo_energias, "%ld %.6f\n", i, energia_actual);
+            parar = errorObjetivoAlcanzado(&analisis, errorobjetivo);
+        }
+        MPI_Bcast(&parar, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (parar) {
+            if (proceso == 0) {
+                printf("Error objetivo %.1e alcanzado en el paso montecarlo %ld.\n", errorobjetivo, i);
+            }
+            break;
+        }
+    }
+    double tiempo = MPI_Wtime() - inicio;
+
+    // Comprobación del seguimiento incremental con un recálculo global
+    double energia_final;
+    long magnetizacion_final;
+    energiaGlobal(&franja, proceso, procesos, &energia_final, &magnetizacion_final);
+    guardarRedFinal(&franja, proceso, procesos, "matriz_red_mpi.bin", temperatura, semilla);
+
+    if (proceso == 0) {
+        ResultadosObservables resultados;
+        fclose(archivo_energias);
+        printf("Seguimiento incremental: E = %.1f (recalculada %.1f), M = %ld (recalculada %ld)\n",
+               energia_actual, energia_final, magnetizacion_actual, magnetizacion_final);
+        calcularResultados(&analisis.acumulador, beta, n * n, &resultados);
+        printf("Observables por espín (T = %.4f, %ld medidas tras descartar %ld):\n",
+               temperatura, resultados.muestras, analisis.corte);
+        escribirResultados(stdout, &resultados);
+        printf("error_e %.8f\nerror_m %.8f\n", errorBloques(&analisis.bloques_e), errorBloques(&analisis.bloques_m));
+        printf("Tiempo: %.2f s (%.2f ns por espín y paso)\n", tiempo, tiempo * 1e9 / ((double)n * n * pasos));
+        liberarAnalisis(&analisis);
+    }
+
+    liberarFranja(&franja);
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,652 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include "aleatorio.h"
+#include "red_ising.h"
+#include "simulacion_ising.h"
+#include "geometria.h"
+#include "observables.h"
+#include "trayectoria.h"
+
+// Barridos de parámetros del modelo de Ising sin preguntas: lee un fichero
+// de trabajos, ejecuta todas las combinaciones de parámetros a la vez en
+// los núcleos del ordenador y escribe una tabla resumen.
+//
+// Compilación: gcc -O3 -march=native -fopenmp lotes_ising.c simulacion_ising.c geometria.c ising_nfold.c ising_multiespin.c ising_cluster.c ising_simd.c observables.c red_ising.c trayectoria.c -o lotes_ising -lm
+// Uso: ./lotes_ising trabajos.txt
+//
+// Formato del fichero de trabajos (ver trabajos_ejemplo.txt): una clave por
+// línea seguida de uno o varios valores; '#' empieza un comentario. Los
+// valores numéricos se pueden dar como lista o como rango inicio:fin:paso.
+//   n            32 64              Tamaños de la red
+//   temperatura  2.0:2.6:0.05       Temperaturas
+//   sesgo        50                 % de espines +1 al empezar (100: red ordenada)
+//   semilla      1 2 3              Semillas enteras (una simulación independiente por semilla)
+//   algoritmo    tablero wolff      aleatorio, tablero, multiespin, wolff, swendsen-wang, simd, vecinos, nfold
+//   geometria    cuadrada cubica    cuadrada, triangular, panal, cubica (n es el lado)
+//   contorno     periodico          periodico, abierto
+//   pasos        20000              Máximo de pasos Monte Carlo de cada trabajo
+//   error        1e-3               Error objetivo de <e> y <|m|> (0: hacer todos los pasos)
+//   salida       barrido            Directorio de resultados
+//   hilos        0                  Trabajos simultáneos (0: uno por núcleo)
+// Se ejecuta el producto de todas las listas, salvo las combinaciones de
+// otra geometría o contorno con un algoritmo que no sea "vecinos" (los demás
+// solo simulan la red cuadrada periódica). Cada trabajo escribe en su
+// subdirectorio energias.txt, observables.txt, histograma.txt (para
+// reponderar con ./reponderar) y red_final.bin, y al final
+// se escribe salida/resumen.txt con una línea por trabajo.
+
+#define K_BOLTZMANN 1.0
+#define MAXIMO_VALORES 4096     // Valores como máximo en cada lista del fichero
+#define LONGITUD_RUTA 512
+
+// Parámetros y resultados de una simulación
+typedef struct {
+    // Parámetros
+    int n;
+    double temperatura;
+    int sesgo;
+    uint64_t semilla;
+    uint64_t clave;           // Clave de los generadores: semilla mezclada con los parámetros (claveTrabajo)
+    int algoritmo;
+    TipoGeometria geometria;
+    TipoContorno contorno;
+    long pasos_maximos;
+    double error_objetivo;
+    char directorio[LONGITUD_RUTA];
+
+    // Resultados
+    int error;                // 0 si el trabajo ha terminado bien
+    long pasos;               // Pasos hechos (menos que pasos_maximos si se alcanza el error)
+    long corte;               // Pasos descartados como termalización
+    ResultadosObservables resultados;
+    double error_e, error_m;  // Errores por bloques de <e> y <|m|>
+    double tau_e, tau_m;
+    double tiempo;            // Segundos
+} TrabajoIsing;
+
+// Lista de valores de una clave del fichero
+typedef struct {
+    int num;
+    double valores[MAXIMO_VALORES];
+} ListaValores;
+
+// Las semillas son enteros de 64 bits: en un double se perderían las grandes
+typedef struct {
+    int num;
+    uint64_t valores[MAXIMO_VALORES];
+} ListaSemillas;
+
+// Configuración leída del fichero de trabajos
+typedef struct {
+    ListaValores n, temperatura, sesgo;
+    ListaSemillas semilla;
+    int num_algoritmos;
+    int algoritmos[16];
+    int num_geometrias, num_contornos;
+    TipoGeometria geometrias[4];
+    TipoContorno contornos[2];
+    long pasos;
+    double error;
+    int hilos;
+    char salida[LONGITUD_RUTA];
+} ConfiguracionLotes;
+
+// Añade a la lista un valor o un rango inicio:fin:paso. Devuelve 0 si todo va bien.
+static int anadirValores(ListaValores *lista, const char *texto) {
+    double inicio, fin, paso;
+    char resto;
+    if (sscanf(texto, "%lf:%lf:%lf%c", &inicio, &fin, &paso, &resto) == 3) {
+        if (paso <= 0 || fin < inicio) {
+            return 1;
+        }
+        // El último valor se incluye aunque la suma de pasos se quede un poco corta
+        long k, total = (long)floor((fin - inicio) / paso + 1e-9) + 1;
+        for (k = 0; k < total; k++) {
+            if (lista->num == MAXIMO_VALORES) {
+                return 1;
+            }
+            lista->valores[lista->num++] = inicio + k * paso;
+        }
+        return 0;
+    }
+    if (sscanf(texto, "%lf%c", &inicio, &resto) != 1 || lista->num == MAXIMO_VALORES) {
+        return 1;
+    }
+    lista->valores[lista->num++] = inicio;
+    return 0;
+}
+
+// Lee un entero sin signo de 64 bits al principio del texto; *fin apunta a
+// lo que sigue. Devuelve 0 si todo va bien.
+static int leerEnteroSinSigno(const char *texto, char **fin, uint64_t *valor) {
+    // strtoull acepta un signo menos (y devuelve el valor negado)
+    if (*texto < '0' || *texto > '9') {
+        return 1;
+    }
+    errno = 0;
+    unsigned long long leido = strtoull(texto, fin, 10);
+    if (errno != 0 || *fin == texto) {
+        return 1;
+    }
+    *valor = (uint64_t)leido;
+    return 0;
+}
+
+// Añade a la lista una semilla o un rango inicio:fin:paso de semillas. Devuelve 0 si todo va bien.
+static int anadirSemillas(ListaSemillas *lista, const char *texto) {
+    uint64_t inicio, fin, paso, semilla;
+    char *resto;
+
+    if (leerEnteroSinSigno(texto, &resto, &inicio) != 0) {
+        return 1;
+    }
+    if (*resto == '\0') {
+        if (lista->num == MAXIMO_VALORES) {
+            return 1;
+        }
+        lista->valores[lista->num++] = inicio;
+        return 0;
+    }
+    if (*resto != ':' || leerEnteroSinSigno(resto + 1, &resto, &fin) != 0 ||
+        *resto != ':' || leerEnteroSinSigno(resto + 1, &resto, &paso) != 0 ||
+        *resto != '\0' || paso == 0 || fin < inicio) {
+        return 1;
+    }
+    for (semilla = inicio;; semilla += paso) {
+        if (lista->num == MAXIMO_VALORES) {
+            return 1;
+        }
+        lista->valores[lista->num++] = semilla;
+        if (fin - semilla < paso) {
+            return 0;
+        }
+    }
+}
+
+static int leerConfiguracion(const char *ruta, ConfiguracionLotes *c) {
+    char linea[4096];
+    int numero_linea = 0;
+    FILE *archivo = fopen(ruta, "r");
+    if (archivo == NULL) {
+        fprintf(stderr, "No se puede abrir el fichero de trabajos %s.\n", ruta);
+        return 1;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->pasos = 10000;
+    c->error = 0;
+    strcpy(c->salida, "resultados_lotes");
+
+    while (fgets(linea, sizeof(linea), archivo) != NULL) {
+        char *comentario = strchr(linea, '#');
+        char *clave, *valor;
+        int error = 0;
+
+        numero_linea++;
+        if (comentario != NULL) {
+            *comentario = '\0';
+        }
+        clave = strtok(linea, " \t\r\n");
+        if (clave == NULL) {
+            continue;
+        }
+        valor = strtok(NULL, " \t\r\n");
+        if (valor == NULL) {
+            error = 1;
+        }
+        for (; valor != NULL && !error; valor = strtok(NULL, " \t\r\n")) {
+            if (strcmp(clave, "n") == 0) {
+                error = anadirValores(&c->n, valor);
+            } else if (strcmp(clave, "temperatura") == 0) {
+                error = anadirValores(&c->temperatura, valor);
+            } else if (strcmp(clave, "sesgo") == 0) {
+                error = anadirValores(&c->sesgo, valor);
+            } else if (strcmp(clave, "semilla") == 0) {
+                error = anadirSemillas(&c->semilla, valor);
+            } else if (strcmp(clave, "algoritmo") == 0) {
+                int algoritmo = algoritmoPorNombre(valor);
+                if (algoritmo < 0 || c->num_algoritmos == 16) {
+                    error = 1;
+                } else {
+                    c->algoritmos[c->num_algoritmos++] = algoritmo;
+                }
+            } else if (strcmp(clave, "geometria") == 0) {
+                int geometria = geometriaPorNombre(valor);
+                if (geometria < 0 || c->num_geometrias == 4) {
+                    error = 1;
+                } else {
+                    c->geometrias[c->num_geometrias++] = geometria;
+                }
+            } else if (strcmp(clave, "contorno") == 0) {
+                int contorno = contornoPorNombre(valor);
+                if (contorno < 0 || c->num_contornos == 2) {
+                    error = 1;
+                } else {
+                    c->contornos[c->num_contornos++] = contorno;
+                }
+            } else if (strcmp(clave, "pasos") == 0) {
+                error = sscanf(valor, "%ld", &c->pasos) != 1 || c->pasos < 1;
+            } else if (strcmp(clave, "error") == 0) {
+                error = sscanf(valor, "%lf", &c->error) != 1 || c->error < 0;
+            } else if (strcmp(clave, "hilos") == 0) {
+                error = sscanf(valor, "%d", &c->hilos) != 1 || c->hilos < 0;
+            } else if (strcmp(clave, "salida") == 0) {
+                error = strlen(valor) >= sizeof(c->salida) / 2;
+                if (!error) {
+                    strcpy(c->salida, valor);
+                }
+            } else {
+                error = 1;
+            }
+        }
+        if (error) {
+            fprintf(stderr, "%s:%d: línea no válida (clave '%s').\n", ruta, numero_linea, clave);
+            fclose(archivo);
+            return 1;
+        }
+    }
+    fclose(archivo);
+
+    // Valores por defecto de las listas que no aparecen
+    if (c->n.num == 0) {
+        anadirValores(&c->n, "64");
+    }
+    if (c->temperatura.num == 0) {
+        anadirValores(&c->temperatura, "2.269");
+    }
+    if (c->sesgo.num == 0) {
+        anadirValores(&c->sesgo, "50");
+    }
+    if (c->semilla.num == 0) {
+        anadirSemillas(&c->semilla, "1");
+    }
+    if (c->num_algoritmos == 0) {
+        c->algoritmos[c->num_algoritmos++] = ALGORITMO_TABLERO;
+    }
+    if (c->num_geometrias == 0) {
+        c->geometrias[c->num_geometrias++] = GEOMETRIA_CUADRADA;
+    }
+    if (c->num_contornos == 0) {
+        c->contornos[c->num_contornos++] = CONTORNO_PERIODICO;
+    }
+    return 0;
+}
+
+// Crea un directorio (no es un error que ya exista)
+static int crearDirectorio(const char *ruta) {
+    return mkdir(ruta, 0755) != 0 && errno != EEXIST;
+}
+
+// Clave de los generadores de un trabajo: la semilla mezclada con todos sus
+// parámetros, para que dos trabajos con la misma semilla (distinta T, n,
+// algoritmo...) no usen los mismos números aleatorios ni la misma red inicial
+static uint64_t claveTrabajo(const TrabajoIsing *t) {
+    uint64_t bits_temperatura, clave = splitmix64(t->semilla);
+    memcpy(&bits_temperatura, &t->temperatura, sizeof(bits_temperatura));
+    clave = splitmix64(clave ^ (uint64_t)t->n);
+    clave = splitmix64(clave ^ bits_temperatura);
+    clave = splitmix64(clave ^ (uint64_t)t->sesgo);
+    clave = splitmix64(clave ^ (uint64_t)t->algoritmo);
+    clave = splitmix64(clave ^ (uint64_t)t->geometria);
+    return splitmix64(clave ^ (uint64_t)t->contorno);
+}
+
+// Construye la lista de trabajos: todas las combinaciones de parámetros
+// (las de otra geometría solo con el algoritmo de la tabla de vecinos)
+static TrabajoIsing *crearTrabajos(const ConfiguracionLotes *c, int *num_trabajos) {
+    long total = (long)c->n.num * c->temperatura.num * c->sesgo.num * c->semilla.num *
+                 c->num_algoritmos * c->num_geometrias * c->num_contornos;
+    TrabajoIsing *trabajos = calloc(total, sizeof(TrabajoIsing));
+    int a, b, d, e, f, gi, ci, k = 0;
+    if (trabajos == NULL) {
+        return NULL;
+    }
+    for (a = 0; a < c->n.num; a++) {
+        for (b = 0; b < c->temperatura.num; b++) {
+            for (d = 0; d < c->sesgo.num; d++) {
+                for (e = 0; e < c->semilla.num; e++) {
+                    for (gi = 0; gi < c->num_geometrias; gi++) {
+                        for (ci = 0; ci < c->num_contornos; ci++) {
+                            for (f = 0; f < c->num_algoritmos; f++) {
+                                int cuadrada_periodica = c->geometrias[gi] == GEOMETRIA_CUADRADA &&
+                                                         c->contornos[ci] == CONTORNO_PERIODICO;
+                                if (c->algoritmos[f] != ALGORITMO_VECINOS && !cuadrada_periodica) {
+                                    continue;
+                                }
+                                TrabajoIsing *t = &trabajos[k++];
+                                t->n = (int)c->n.valores[a];
+                                t->temperatura = c->temperatura.valores[b];
+                                t->sesgo = (int)c->sesgo.valores[d];
+                                t->semilla = c->semilla.valores[e];
+                                t->algoritmo = c->algoritmos[f];
+                                t->geometria = c->geometrias[gi];
+                                t->contorno = c->contornos[ci];
+                                t->pasos_maximos = c->pasos;
+                                t->error_objetivo = c->error;
+                                t->clave = claveTrabajo(t);
+                                snprintf(t->directorio, sizeof(t->directorio),
+                                         "%s/n%d_T%.4f_s%d_semilla%llu_%s_%s_%s",
+                                         c->salida, t->n, t->temperatura, t->sesgo,
+                                         (unsigned long long)t->semilla, nombreAlgoritmo(t->algoritmo),
+                                         nombreGeometria(t->geometria), nombreContorno(t->contorno));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    *num_trabajos = k;
+    return trabajos;
+}
+
+// Abre un fichero dentro del directorio del trabajo
+static FILE *abrirEnDirectorio(const TrabajoIsing *t, const char *nombre, const char *modo) {
+    char ruta[2 * LONGITUD_RUTA];
+    snprintf(ruta, sizeof(ruta), "%s/%s", t->directorio, nombre);
+    return fopen(ruta, modo);
+}
+
+// Lo que se simula en un trabajo: la red cuadrada periódica con uno de los
+// motores de simulacion_ising.h o, con el algoritmo "vecinos", cualquier
+// geometría con la tabla de vecinos de geometria.h
+typedef struct {
+    int usa_geometria;
+    RedIsing red;
+    MotorIsing motor;
+    Geometria geometria;
+    int8_t *espines;
+    int num_espines;
+} SistemaTrabajo;
+
+// Reserva e inicializa el sistema. Devuelve 0 si todo va bien.
+static int prepararSistema(SistemaTrabajo *s, const TrabajoIsing *t, double beta,
+                           double *energia, long *magnetizacion) {
+    GeneradorHilo generador_inicial;
+    inicializarGeneradorFlujo(&generador_inicial, t->clave, 0, FLUJO_INICIALIZACION);
+    s->usa_geometria = t->algoritmo == ALGORITMO_VECINOS;
+
+    if (s->usa_geometria) {
+        if (crearGeometria(&s->geometria, t->geometria, t->contorno, t->n) != 0) {
+            return 1;
+        }
+        s->espines = crearEspinesGeometria(&s->geometria);
+        if (s->espines == NULL) {
+            liberarGeometria(&s->geometria);
+            return 1;
+        }
+        inicializarEspinesGeometria(&s->geometria, s->espines, t->sesgo, &generador_inicial);
+        s->num_espines = s->geometria.num_sitios;
+        *energia = energiaGeometria(&s->geometria, s->espines);
+        *magnetizacion = magnetizacionGeometria(&s->geometria, s->espines);
+        return 0;
+    }
+
+    if (crearRedIsing(&s->red, t->n) != 0) {
+        return 1;
+    }
+    inicializarRed(&s->red, t->sesgo, &generador_inicial);
+    if (crearMotorIsing(&s->motor, t->algoritmo, &s->red, beta) != 0) {
+        liberarRedIsing(&s->red);
+        return 1;
+    }
+    s->num_espines = t->n * t->n;
+    medirMotor(&s->motor, &s->red, energia, magnetizacion);
+    return 0;
+}
+
+static void pasoSistema(SistemaTrabajo *s, double beta, GeneradorHilo generadores[],
+                        double *energia, long *magnetizacion) {
+    if (s->usa_geometria) {
+        barridoGeometria(&s->geometria, s->espines, beta, generadores, energia, magnetizacion);
+    } else {
+        pasoMonteCarlo(&s->motor, &s->red, generadores, energia, magnetizacion);
+    }
+}
+
+// Configuración final como trayectoria (animacion.py la lee): un fotograma
+// en 2D y, en la red cúbica, un fotograma por cada plano x = constante
+static int guardarConfiguracionFinal(const SistemaTrabajo *s, const TrabajoIsing *t) {
+    char ruta[2 * LONGITUD_RUTA];
+    EscritorTrayectoria trayectoria;
+    int x, error;
+
+    snprintf(ruta, sizeof(ruta), "%s/red_final.bin", t->directorio);
+    if (abrirTrayectoriaEscritura(&trayectoria, ruta, t->n, t->temperatura, t->semilla) != 0) {
+        return 1;
+    }
+    if (!s->usa_geometria) {
+        error = escribirFotogramaFilas(&trayectoria, s->red.espines, s->red.paso) != 0;
+    } else {
+        int planos = (s->geometria.dimension == 3) ? t->n : 1;
+        error = 0;
+        for (x = 0; x < planos && !error; x++) {
+            error = escribirFotogramaFilas(&trayectoria, s->espines + (size_t)x * t->n * t->n, t->n) != 0;
+        }
+    }
+    return cerrarTrayectoriaEscritura(&trayectoria) != 0 || error;
+}
+
+static void liberarSistema(SistemaTrabajo *s) {
+    if (s->usa_geometria) {
+        free(s->espines);
+        liberarGeometria(&s->geometria);
+    } else {
+        liberarMotorIsing(&s->motor);
+        liberarRedIsing(&s->red);
+    }
+}
+
+// Ejecuta una simulación completa. Solo usa un hilo: el paralelismo está en
+// ejecutar muchos trabajos a la vez. El resultado depende solo de los
+// parámetros del trabajo, no de cuántos se ejecuten a la vez.
+static void ejecutarTrabajo(TrabajoIsing *t) {
+    double beta = 1.0 / (K_BOLTZMANN * t->temperatura);
+    double inicio = omp_get_wtime();
+    double energia;
+    long i, magnetizacion;
+    SistemaTrabajo sistema;
+    HistogramaEnergia histograma;
+    AnalisisSimulacion *analisis = malloc(sizeof(AnalisisSimulacion));
+
+    t->error = 1;
+    if (analisis == NULL || crearDirectorio(t->directorio) != 0) {
+        free(analisis);
+        return;
+    }
+    if (prepararSistema(&sistema, t, beta, &energia, &magnetizacion) != 0) {
+        free(analisis);
+        return;
+    }
+    if (iniciarAnalisis(analisis) != 0) {
+        liberarSistema(&sistema);
+        free(analisis);
+        return;
+    }
+    // Histograma de las medidas termalizadas para reponderar (ver reponderar.c)
+    char sistema_red[64];
+    snprintf(sistema_red, sizeof(sistema_red), "%s-%s", nombreGeometria(t->geometria), nombreContorno(t->contorno));
+    iniciarHistograma(&histograma, beta, t->n, sistema.num_espines, sistema_red);
+    analisis->histograma = &histograma;
+
+    GeneradorHilo *generadores = crearGeneradores(t->clave);
+    FILE *archivo_energias = abrirEnDirectorio(t, "energias.txt", "w");
+
+    for (i = 0; i < t->pasos_maximos; i++) {
+        pasoSistema(&sistema, beta, generadores, &energia, &magnetizacion);
+        anadirMedida(analisis, energia, magnetizacion, sistema.num_espines);
+        if (archivo_energias != NULL) {
+            fprintf(archivo_energias, "%ld %.6f %ld\n", i, energia, magnetizacion);
+        }
+        if (t->error_objetivo > 0 && errorObjetivoAlcanzado(analisis, t->error_objetivo)) {
+            i++;
+            break;
+        }
+    }
+    t->pasos = i;
+
+    // Resultados (sin termalización no hay medidas: se deja constancia con corte = -1)
+    t->corte = analisis->termalizado ? analisis->corte : -1;
+    calcularResultados(&analisis->acumulador, beta, sistema.num_espines, &t->resultados);
+    t->error_e = errorBloques(&analisis->bloques_e);
+    t->error_m = errorBloques(&analisis->bloques_m);
+    t->tau_e = tiempoAutocorrelacion(&analisis->autocorrelacion_e);
+    t->tau_m = tiempoAutocorrelacion(&analisis->autocorrelacion_m);
+
+    FILE *archivo_observables = abrirEnDirectorio(t, "observables.txt", "w");
+    if (archivo_observables != NULL) {
+        escribirResultados(archivo_observables, &t->resultados);
+        fprintf(archivo_observables, "error_e %.8f\n", t->error_e);
+        fprintf(archivo_observables, "error_m %.8f\n", t->error_m);
+        fprintf(archivo_observables, "termalizacion %ld\n", t->corte);
+        fclose(archivo_observables);
+    }
+
+    char ruta_histograma[2 * LONGITUD_RUTA];
+    snprintf(ruta_histograma, sizeof(ruta_histograma), "%s/histograma.txt", t->directorio);
+    histograma.tau_e = t->tau_e;
+    // Sin medidas termalizadas no hay histograma, y no es un error del trabajo
+    int error_histograma = histograma.muestras > 0 && guardarHistograma(ruta_histograma, &histograma) != 0;
+
+    if (!sistema.usa_geometria) {
+        sincronizarRed(&sistema.motor, &sistema.red); // Solo aquí hace falta la red
+    }
+    int error_red = guardarConfiguracionFinal(&sistema, t);
+    t->error = archivo_energias == NULL || archivo_observables == NULL || error_red || error_histograma;
+    if (archivo_energias != NULL) {
+        fclose(archivo_energias);
+    }
+    liberarAnalisis(analisis);
+    liberarHistograma(&histograma);
+    free(analisis);
+    free(generadores);
+    liberarSistema(&sistema);
+    t->tiempo = omp_get_wtime() - inicio;
+}
+
+// Orden de ejecución: primero los trabajos más largos, para que los últimos
+// en empezar sean cortos y ningún hilo se quede solo al final
+static const TrabajoIsing *trabajos_orden;
+
+static int compararCoste(const void *a, const void *b) {
+    const TrabajoIsing *x = &trabajos_orden[*(const int *)a];
+    const TrabajoIsing *y = &trabajos_orden[*(const int *)b];
+    double coste_x = (double)x->n * x->n * (x->geometria == GEOMETRIA_CUBICA ? x->n : 1) * x->pasos_maximos;
+    double coste_y = (double)y->n * y->n * (y->geometria == GEOMETRIA_CUBICA ? y->n : 1) * y->pasos_maximos;
+    return (coste_x < coste_y) - (coste_x > coste_y);
+}
+
+static void escribirResumen(FILE *archivo, const TrabajoIsing *trabajos, int num_trabajos) {
+    int k;
+    fprintf(archivo, "# n T sesgo semilla algoritmo geometria contorno pasos termalizacion e error_e "
+                     "|m| error_m C chi U tau_e tau_m tiempo(s)\n");
+    for (k = 0; k < num_trabajos; k++) {
+        const TrabajoIsing *t = &trabajos[k];
+        if (t->error) {
+            fprintf(archivo, "# %d %.6f %d %llu %s %s %s: error\n", t->n, t->temperatura, t->sesgo,
+                    (unsigned long long)t->semilla, nombreAlgoritmo(t->algoritmo),
+                    nombreGeometria(t->geometria), nombreContorno(t->contorno));
+            continue;
+        }
+        fprintf(archivo, "%d %.6f %d %llu %s %s %s %ld %ld %.8f %.8f %.8f %.8f %.6f %.6f %.6f %.2f %.2f %.2f\n",
+                t->n, t->temperatura, t->sesgo, (unsigned long long)t->semilla,
+                nombreAlgoritmo(t->algoritmo), nombreGeometria(t->geometria), nombreContorno(t->contorno),
+                t->pasos, t->corte,
+                t->resultados.energia, t->error_e, t->resultados.magnetizacion_abs, t->error_m,
+                t->resultados.calor_especifico, t->resultados.susceptibilidad, t->resultados.binder,
+                t->tau_e, t->tau_m, t->tiempo);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ConfiguracionLotes *c = malloc(sizeof(ConfiguracionLotes));
+    int k, num_trabajos, terminados = 0;
+
+    if (argc != 2) {
+        fprintf(stderr, "Uso: %s trabajos.txt\n", argv[0]);
+        return 1;
+    }
+    if (c == NULL || leerConfiguracion(argv[1], c) != 0) {
+        return 1;
+    }
+    TrabajoIsing *trabajos = crearTrabajos(c, &num_trabajos);
+    int *orden = malloc(num_trabajos * sizeof(int));
+    if (trabajos == NULL || orden == NULL) {
+        fprintf(stderr, "Error al reservar la lista de trabajos.\n");
+        return 1;
+    }
+    for (k = 0; k < num_trabajos; k++) {
+        TrabajoIsing *t = &trabajos[k];
+        int colores = (t->geometria == GEOMETRIA_TRIANGULAR) ? 3 : 2;
+        int lado_valido = t->algoritmo == ALGORITMO_VECINOS
+            ? (t->contorno == CONTORNO_ABIERTO || t->n % colores == 0)
+            : (!algoritmoNecesitaNPar(t->algoritmo) || t->n % 2 == 0);
+        if (t->n < 2 || t->temperatura <= 0 || !lado_valido) {
+            fprintf(stderr, "Trabajo no válido: n = %d, T = %g, algoritmo %s, red %s %s (el coloreado "
+                    "periódico necesita n par, o múltiplo de 3 en la triangular).\n",
+                    t->n, t->temperatura, nombreAlgoritmo(t->algoritmo),
+                    nombreGeometria(t->geometria), nombreContorno(t->contorno));
+            return 1;
+        }
+        orden[k] = k;
+    }
+    if (crearDirectorio(c->salida) != 0) {
+        fprintf(stderr, "No se puede crear el directorio %s.\n", c->salida);
+        return 1;
+    }
+
+    trabajos_orden = trabajos;
+    qsort(orden, num_trabajos, sizeof(int), compararCoste);
+
+    // Cada hilo toma el siguiente trabajo libre en cuanto acaba el suyo
+    // (schedule(dynamic, 1)). Los bucles paralelos de dentro de cada trabajo
+    // se ejecutan con un solo hilo.
+    int hilos = (c->hilos > 0) ? c->hilos : omp_get_max_threads();
+    omp_set_max_active_levels(1);
+    printf("%d trabajos en %d hilos. Resultados en %s/\n", num_trabajos, hilos, c->salida);
+    double inicio = omp_get_wtime();
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(hilos)
+    for (k = 0; k < num_trabajos; k++) {
+        TrabajoIsing *t = &trabajos[orden[k]];
+        ejecutarTrabajo(t);
+        #pragma omp critical
+        {
+            terminados++;
+            printf("[%d/%d] n = %d, T = %.4f, sesgo = %d, semilla = %llu, %s (%s %s): %s (%ld pasos, %.1f s)\n",
+                   terminados, num_trabajos, t->n, t->temperatura, t->sesgo, (unsigned long long)t->semilla,
+                   nombreAlgoritmo(t->algoritmo), nombreGeometria(t->geometria), nombreContorno(t->contorno),
+                   t->error ? "ERROR" : "listo", t->pasos, t->tiempo);
+            fflush(stdout);
+        }
+    }
+
+    // Tabla resumen en el orden del fichero de trabajos
+    char ruta[2 * LONGITUD_RUTA];
+    snprintf(ruta, sizeof(ruta), "%s/resumen.txt", c->salida);
+    FILE *archivo = fopen(ruta, "w");
+    if (archivo == NULL) {
+        fprintf(stderr, "Error al abrir %s.\n", ruta);
+    } else {
+        escribirResumen(archivo, trabajos, num_trabajos);
+        fclose(archivo);
+    }
+    printf("\n");
+    escribirResumen(stdout, trabajos, num_trabajos);
+    printf("\nTiempo total: %.2f segundos.\n", omp_get_wtime() - inicio);
+
+    int errores = 0;
+    for (k = 0; k < num_trabajos; k++) {
+        errores += trabajos[k].error;
+    }
+    free(orden);
+    free(trabajos);
+    free(c);
+    return errores != 0;
+}
@@ -0,0 +1,99 @@
+#ifndef NUCLEO_ISING_HPP
+#define NUCLEO_ISING_HPP
+
+#include <cmath>
+
+// Tipo de condiciones de contorno de la red
+enum class Contorno { Periodico, Abierto };
+
+// Núcleo de Metropolis especializado en tiempo de compilación para una red
+// L x L con un contorno dado. La probabilidad de aceptación solo depende de
+// s * (suma de vecinos), que toma valores enteros entre -4 y 4, así que se
+// tabula una vez por temperatura y el bucle no llama nunca a exp().
+// El interior se recorre con índices directos; el contorno va aparte.
+template <int L, Contorno C>
+class NucleoIsing {
+    static_assert(L >= 3, "La red debe tener al menos 3 x 3 espines");
+
+public:
+    explicit NucleoIsing(double beta) {
+        for (int k = 0; k < L; k++) {
+            // Índices de los vecinos anterior y siguiente en una fila o columna.
+            // Con contorno abierto el vecino que falta tiene peso 0.
+            anterior_[k] = (k == 0) ? L - 1 : k - 1;
+            siguiente_[k] = (k == L - 1) ? 0 : k + 1;
+            peso_anterior_[k] = (C == Contorno::Abierto && k == 0) ? 0 : 1;
+            peso_siguiente_[k] = (C == Contorno::Abierto && k == L - 1) ? 0 : 1;
+        }
+        fijarBeta(beta);
+    }
+
+    // Recalcula la tabla de aceptación para una nueva temperatura
+    void fijarBeta(double beta) {
+        for (int k = 0; k < 9; k++) {
+            int s_suma = k - 4; // deltaE = 2 * s * suma
+            double p = std::exp(-beta * 2.0 * s_suma);
+            aceptacion_[k] = (p > 1.0) ? 1.0 : p;
+        }
+    }
+
+    // Un paso Monte Carlo completo (L * L intentos) en orden de tablero de
+    // ajedrez. Después de cada intento se llama a observar(sitio, aceptado),
+    // con sitio = n * L + m, para guardar la red o la inversión.
+    template <class Uniforme, class Observador>
+    void barrido(int red[L][L], Uniforme &uniforme, Observador &&observar) {
+        for (int color = 0; color < 2; color++) {
+            // Interior: los cuatro vecinos existen siempre
+            for (int n = 1; n < L - 1; n++) {
+                for (int m = 1 + (n + 1 + color) % 2; m < L - 1; m += 2) {
+                    int suma = red[n - 1][m] + red[n + 1][m] + red[n][m - 1] + red[n][m + 1];
+                    observar(n * L + m, intentar(red, n, m, suma, uniforme));
+                }
+            }
+
+            // Contorno: primera y última fila, primera y última columna
+            for (int m = color; m < L; m += 2) {
+                observar(m, intentar(red, 0, m, sumaContorno(red, 0, m), uniforme));
+            }
+            for (int m = (L - 1 + color) % 2; m < L; m += 2) {
+                observar((L - 1) * L + m, intentar(red, L - 1, m, sumaContorno(red, L - 1, m), uniforme));
+            }
+            for (int n = 1; n < L - 1; n++) {
+                if ((n + color) % 2 == 0) {
+                    observar(n * L, intentar(red, n, 0, sumaContorno(red, n, 0), uniforme));
+                }
+                if ((n + L - 1 + color) % 2 == 0) {
+                    observar(n * L + L - 1, intentar(red, n, L - 1, sumaContorno(red, n, L - 1), uniforme));
+                }
+            }
+        }
+    }
+
+    template <class Uniforme>
+    void barrido(int red[L][L], Uniforme &uniforme) {
+        barrido(red, uniforme, [](int, bool) {});
+    }
+
+private:
+    // Suma de vecinos con los índices y pesos precalculados (sin ramas)
+    int sumaContorno(int red[L][L], int n, int m) const {
+        return peso_anterior_[n] * red[anterior_[n]][m] + peso_siguiente_[n] * red[siguiente_[n]][m] +
+               peso_anterior_[m] * red[n][anterior_[m]] + peso_siguiente_[m] * red[n][siguiente_[m]];
+    }
+
+    // Acepta o rechaza la inversión sin saltos condicionales: la comparación
+    // da 0 o 1 y el espín se multiplica por 1 o -1
+    template <class Uniforme>
+    bool intentar(int red[L][L], int n, int m, int suma, Uniforme &uniforme) {
+        int &s = red[n][m];
+        int acepta = uniforme() < aceptacion_[s * suma + 4];
+        s *= 1 - 2 * acepta;
+        return acepta;
+    }
+
+    double aceptacion_[9];
+    int anterior_[L], siguiente_[L];
+    int peso_anterior_[L], peso_siguiente_[L];
+};
+
+#endif
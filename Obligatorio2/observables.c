@@ -0,0 +1,584 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "observables.h"
+
+void iniciarAcumulador(AcumuladorObservables *a) {
+    a->muestras = 0;
+    a->media_e = a->m2_e = 0;
+    a->media_m_abs = a->m2_m_abs = 0;
+    a->media_m2 = a->media_m4 = 0;
+}
+
+void acumularMuestra(AcumuladorObservables *a, double energia, double magnetizacion, int num_espines) {
+    double e = energia / num_espines;
+    double m = fabs(magnetizacion) / num_espines;
+    double m2 = m * m;
+    double delta;
+
+    a->muestras++;
+
+    // Algoritmo de Welford: evita restar dos números grandes y casi iguales
+    // al calcular <e^2> - <e>^2 en series largas
+    delta = e - a->media_e;
+    a->media_e += delta / a->muestras;
+    a->m2_e += delta * (e - a->media_e);
+
+    delta = m - a->media_m_abs;
+    a->media_m_abs += delta / a->muestras;
+    a->m2_m_abs += delta * (m - a->media_m_abs);
+
+    a->media_m2 += (m2 - a->media_m2) / a->muestras;
+    a->media_m4 += (m2 * m2 - a->media_m4) / a->muestras;
+}
+
+void calcularResultados(const AcumuladorObservables *a, double beta, int num_espines, ResultadosObservables *r) {
+    double varianza_e = 0, varianza_m = 0;
+    if (a->muestras > 0) {
+        varianza_e = a->m2_e / a->muestras;
+        varianza_m = a->m2_m_abs / a->muestras;
+    }
+
+    r->muestras = a->muestras;
+    r->energia = a->media_e;
+    r->energia2 = varianza_e + a->media_e * a->media_e;
+    r->magnetizacion_abs = a->media_m_abs;
+    r->magnetizacion2 = a->media_m2;
+    r->magnetizacion4 = a->media_m4;
+    r->calor_especifico = beta * beta * num_espines * varianza_e;
+    // <m^2> - <|m|>^2 es la varianza de |m|
+    r->susceptibilidad = beta * num_espines * varianza_m;
+    r->binder = (a->media_m2 > 0) ? 1.0 - a->media_m4 / (3.0 * a->media_m2 * a->media_m2) : 0.0;
+}
+
+void escribirResultados(FILE *archivo, const ResultadosObservables *r) {
+    fprintf(archivo, "muestras %ld\n", r->muestras);
+    fprintf(archivo, "<e> %.8f\n", r->energia);
+    fprintf(archivo, "<e^2> %.8f\n", r->energia2);
+    fprintf(archivo, "<|m|> %.8f\n", r->magnetizacion_abs);
+    fprintf(archivo, "<m^2> %.8f\n", r->magnetizacion2);
+    fprintf(archivo, "<m^4> %.8f\n", r->magnetizacion4);
+    fprintf(archivo, "calor_especifico %.8f\n", r->calor_especifico);
+    fprintf(archivo, "susceptibilidad %.8f\n", r->susceptibilidad);
+    fprintf(archivo, "binder %.8f\n", r->binder);
+}
+
+void iniciarAutocorrelacion(Autocorrelacion *a) {
+    int k;
+    a->muestras = 0;
+    a->referencia = 0;
+    a->suma = 0;
+    for (k = 0; k <= MAXIMO_RETARDO; k++) {
+        a->suma_productos[k] = 0;
+    }
+}
+
+void acumularAutocorrelacion(Autocorrelacion *a, double x) {
+    long t = a->muestras;
+    int k;
+
+    if (t == 0) {
+        a->referencia = x;
+    }
+    x -= a->referencia;
+
+    // Productos con los valores anteriores guardados en el anillo
+    a->suma_productos[0] += x * x;
+    for (k = 1; k <= MAXIMO_RETARDO && k <= t; k++) {
+        a->suma_productos[k] += x * a->historial[(t - k) % MAXIMO_RETARDO];
+    }
+
+    a->historial[t % MAXIMO_RETARDO] = x;
+    a->suma += x;
+    a->muestras++;
+}
+
+double tiempoAutocorrelacion(const Autocorrelacion *a) {
+    double media, c0, tau = 0.5;
+    int k;
+
+    if (a->muestras < 2) {
+        return 0.5;
+    }
+    media = a->suma / a->muestras;
+    c0 = a->suma_productos[0] / a->muestras - media * media;
+    if (c0 <= 0) {
+        return 0.5;
+    }
+    for (k = 1; k <= MAXIMO_RETARDO && k < a->muestras / 2; k++) {
+        double ck = a->suma_productos[k] / (a->muestras - k) - media * media;
+        tau += ck / c0;
+        if (k >= 6 * tau) {
+            break;
+        }
+    }
+    return tau;
+}
+
+void iniciarBloques(AnalisisBloques *b) {
+    int l;
+    b->muestras = 0;
+    b->referencia = 0;
+    for (l = 0; l < NIVELES_BLOQUES; l++) {
+        b->hay_pendiente[l] = 0;
+        b->bloques[l] = 0;
+        b->suma[l] = b->suma2[l] = 0;
+    }
+}
+
+void acumularBloques(AnalisisBloques *b, double x) {
+    int l;
+
+    if (b->muestras == 0) {
+        b->referencia = x;
+    }
+    b->muestras++;
+    x -= b->referencia;
+
+    // Cada muestra completa un bloque del nivel 0; cada dos bloques de un
+    // nivel forman uno del siguiente
+    for (l = 0; l < NIVELES_BLOQUES; l++) {
+        b->bloques[l]++;
+        b->suma[l] += x;
+        b->suma2[l] += x * x;
+        if (!b->hay_pendiente[l]) {
+            b->pendiente[l] = x;
+            b->hay_pendiente[l] = 1;
+            break;
+        }
+        x = 0.5 * (b->pendiente[l] + x);
+        b->hay_pendiente[l] = 0;
+    }
+}
+
+double errorBloques(const AnalisisBloques *b) {
+    double error = 0;
+    int l;
+    for (l = 0; l < NIVELES_BLOQUES && b->bloques[l] >= 32; l++) {
+        double media = b->suma[l] / b->bloques[l];
+        double varianza = b->suma2[l] / b->bloques[l] - media * media;
+        double error_nivel = sqrt(fmax(varianza, 0) / (b->bloques[l] - 1));
+        if (error_nivel > error) {
+            error = error_nivel;
+        }
+    }
+    return error;
+}
+
+long truncamientoMSER(const double *serie, long n) {
+    const int lote = 5;
+    long lotes = n / lote, d, mejor = -1;
+    double suma = 0, suma2 = 0, mejor_estadistico = 0;
+
+    if (lotes < 10) {
+        return -1;
+    }
+
+    // Se recorre desde el final para tener las sumas del resto en O(1)
+    for (d = lotes - 1; d >= 0; d--) {
+        double z = 0;
+        long k;
+        for (k = 0; k < lote; k++) {
+            z += serie[d * lote + k];
+        }
+        z /= lote;
+        suma += z;
+        suma2 += z * z;
+
+        long resto = lotes - d;
+        if (resto < 2) {
+            continue;
+        }
+        double media = suma / resto;
+        double estadistico = fmax(suma2 / resto - media * media, 0) / resto;
+        if (mejor < 0 || estadistico <= mejor_estadistico) {
+            mejor = d;
+            mejor_estadistico = estadistico;
+        }
+    }
+
+    return (mejor <= lotes / 2) ? mejor * lote : -1;
+}
+
+int iniciarSerie(SerieTemporal *s) {
+    s->muestras = 0;
+    s->capacidad = 1024;
+    s->valores = malloc(s->capacidad * sizeof(double));
+    return s->valores == NULL;
+}
+
+int anadirSerie(SerieTemporal *s, double x) {
+    if (s->muestras == s->capacidad) {
+        double *nuevos = realloc(s->valores, 2 * s->capacidad * sizeof(double));
+        if (nuevos == NULL) {
+            return 1;
+        }
+        s->valores = nuevos;
+        s->capacidad *= 2;
+    }
+    s->valores[s->muestras++] = x;
+    return 0;
+}
+
+void liberarSerie(SerieTemporal *s) {
+    free(s->valores);
+    s->valores = NULL;
+}
+
+void iniciarHistograma(HistogramaEnergia *h, double beta, int lado, int num_espines, const char *sistema) {
+    memset(h, 0, sizeof(*h));
+    h->beta = beta;
+    h->lado = lado;
+    h->num_espines = num_espines;
+    strncpy(h->sistema, sistema, sizeof(h->sistema) - 1);
+}
+
+void liberarHistograma(HistogramaEnergia *h) {
+    free(h->cuentas);
+    free(h->suma_m_abs);
+    free(h->suma_m2);
+    free(h->suma_m4);
+    h->cuentas = NULL;
+    h->suma_m_abs = h->suma_m2 = h->suma_m4 = NULL;
+    h->num_bins = 0;
+}
+
+// Pasa el histograma a num_bins bins desde energia_minima (que contienen a los actuales)
+static int ampliarHistograma(HistogramaEnergia *h, long energia_minima, int num_bins) {
+    HistogramaEnergia nuevo = *h;
+    int desplazamiento = (int)(h->energia_minima - energia_minima);
+    nuevo.energia_minima = energia_minima;
+    nuevo.num_bins = num_bins;
+    nuevo.cuentas = calloc(num_bins, sizeof(long));
+    nuevo.suma_m_abs = calloc(num_bins, sizeof(double));
+    nuevo.suma_m2 = calloc(num_bins, sizeof(double));
+    nuevo.suma_m4 = calloc(num_bins, sizeof(double));
+    if (nuevo.cuentas == NULL || nuevo.suma_m_abs == NULL || nuevo.suma_m2 == NULL || nuevo.suma_m4 == NULL) {
+        liberarHistograma(&nuevo);
+        return 1;
+    }
+    if (h->num_bins > 0) {
+        memcpy(nuevo.cuentas + desplazamiento, h->cuentas, h->num_bins * sizeof(long));
+        memcpy(nuevo.suma_m_abs + desplazamiento, h->suma_m_abs, h->num_bins * sizeof(double));
+        memcpy(nuevo.suma_m2 + desplazamiento, h->suma_m2, h->num_bins * sizeof(double));
+        memcpy(nuevo.suma_m4 + desplazamiento, h->suma_m4, h->num_bins * sizeof(double));
+    }
+    liberarHistograma(h);
+    *h = nuevo;
+    return 0;
+}
+
+void acumularHistograma(HistogramaEnergia *h, double energia, double magnetizacion) {
+    long e = lround(energia);
+    double m = fabs(magnetizacion) / h->num_espines;
+
+    // Fuera del rango actual: se amplía con margen por los dos lados para
+    // que la deriva lenta de la energía no obligue a copiar en cada medida
+    if (h->num_bins == 0 || e < h->energia_minima || e >= h->energia_minima + h->num_bins) {
+        long minimo = (h->num_bins == 0) ? e : ((e < h->energia_minima) ? e : h->energia_minima);
+        long maximo = (h->num_bins == 0) ? e : ((e >= h->energia_minima + h->num_bins) ? e : h->energia_minima + h->num_bins - 1);
+        long margen = (maximo - minimo) / 2 + 64;
+        if (ampliarHistograma(h, minimo - margen, (int)(maximo - minimo + 2 * margen + 1)) != 0) {
+            h->error = 1;
+            return;
+        }
+    }
+
+    int bin = (int)(e - h->energia_minima);
+    h->muestras++;
+    h->cuentas[bin]++;
+    h->suma_m_abs[bin] += m;
+    h->suma_m2[bin] += m * m;
+    h->suma_m4[bin] += m * m * m * m;
+}
+
+int guardarHistograma(const char *ruta, const HistogramaEnergia *h) {
+    int k;
+    FILE *archivo = fopen(ruta, "w");
+    if (archivo == NULL || h->error) {
+        if (archivo != NULL) {
+            fclose(archivo);
+        }
+        return 1;
+    }
+    fprintf(archivo, "beta %.17g\n", h->beta);
+    fprintf(archivo, "lado %d\n", h->lado);
+    fprintf(archivo, "num_espines %d\n", h->num_espines);
+    fprintf(archivo, "sistema %s\n", h->sistema);
+    fprintf(archivo, "tau_e %.6f\n", h->tau_e);
+    fprintf(archivo, "muestras %ld\n", h->muestras);
+    fprintf(archivo, "# E cuentas suma_|m| suma_m2 suma_m4\n");
+    for (k = 0; k < h->num_bins; k++) {
+        if (h->cuentas[k] > 0) {
+            fprintf(archivo, "%ld %ld %.17g %.17g %.17g\n", h->energia_minima + k, h->cuentas[k],
+                    h->suma_m_abs[k], h->suma_m2[k], h->suma_m4[k]);
+        }
+    }
+    return fclose(archivo) != 0;
+}
+
+int leerHistograma(const char *ruta, HistogramaEnergia *h) {
+    char linea[256];
+    long e, cuentas, muestras = 0, leidas = 0;
+    double m, m2, m4;
+    FILE *archivo = fopen(ruta, "r");
+    if (archivo == NULL) {
+        return 1;
+    }
+    iniciarHistograma(h, 0.0, 0, 0, "");
+    while (fgets(linea, sizeof(linea), archivo) != NULL) {
+        if (linea[0] == '#' || sscanf(linea, "beta %lf", &h->beta) == 1 || sscanf(linea, "lado %d", &h->lado) == 1 ||
+            sscanf(linea, "num_espines %d", &h->num_espines) == 1 || sscanf(linea, "sistema %63s", h->sistema) == 1 ||
+            sscanf(linea, "tau_e %lf", &h->tau_e) == 1 || sscanf(linea, "muestras %ld", &muestras) == 1) {
+            continue;
+        }
+        if (sscanf(linea, "%ld %ld %lf %lf %lf", &e, &cuentas, &m, &m2, &m4) != 5 || h->num_espines <= 0) {
+            break;
+        }
+        // Las energías vienen en orden creciente: se amplía hasta la última
+        if (h->num_bins == 0 || e >= h->energia_minima + h->num_bins) {
+            long minimo = (h->num_bins == 0) ? e : h->energia_minima;
+            int num_bins = (h->num_bins == 0) ? 64 : 2 * (int)(e - minimo + 1);
+            if (ampliarHistograma(h, minimo, num_bins) != 0) {
+                break;
+            }
+        }
+        if (e < h->energia_minima) {
+            break;
+        }
+        int bin = (int)(e - h->energia_minima);
+        h->cuentas[bin] = cuentas;
+        h->suma_m_abs[bin] = m;
+        h->suma_m2[bin] = m2;
+        h->suma_m4[bin] = m4;
+        leidas += cuentas;
+    }
+    fclose(archivo);
+    h->muestras = leidas;
+    if (leidas == 0 || leidas != muestras) {
+        liberarHistograma(h);
+        return 1;
+    }
+    return 0;
+}
+
+int iniciarAnalisis(AnalisisSimulacion *a) {
+    a->termalizado = 0;
+    a->histograma = NULL;
+    a->medidas = 0;
+    a->corte = 0;
+    iniciarAcumulador(&a->acumulador);
+    iniciarAutocorrelacion(&a->autocorrelacion_e);
+    iniciarAutocorrelacion(&a->autocorrelacion_m);
+    iniciarBloques(&a->bloques_e);
+    iniciarBloques(&a->bloques_m);
+    if (iniciarSerie(&a->serie_e) != 0) {
+        return 1;
+    }
+    if (iniciarSerie(&a->serie_m) != 0) {
+        liberarSerie(&a->serie_e);
+        return 1;
+    }
+    return 0;
+}
+
+void liberarAnalisis(AnalisisSimulacion *a) {
+    liberarSerie(&a->serie_e);
+    liberarSerie(&a->serie_m);
+}
+
+// Medida ya termalizada (valores por espín)
+static void acumularMedidaTermalizada(AnalisisSimulacion *a, double e, double m, int num_espines) {
+    acumularMuestra(&a->acumulador, e * num_espines, m * num_espines, num_espines);
+    acumularAutocorrelacion(&a->autocorrelacion_e, e);
+    acumularAutocorrelacion(&a->autocorrelacion_m, m);
+    acumularBloques(&a->bloques_e, e);
+    acumularBloques(&a->bloques_m, m);
+    if (a->histograma != NULL) {
+        acumularHistograma(a->histograma, e * num_espines, m * num_espines);
+    }
+}
+
+void anadirMedida(AnalisisSimulacion *a, double energia, double magnetizacion, int num_espines) {
+    double e = energia / num_espines;
+    double m = fabs(magnetizacion) / num_espines;
+
+    a->medidas++;
+    if (a->termalizado) {
+        acumularMedidaTermalizada(a, e, m, num_espines);
+        return;
+    }
+
+    if (anadirSerie(&a->serie_e, e) != 0 || anadirSerie(&a->serie_m, m) != 0) {
+        // Sin memoria para seguir guardando: se da por termalizado aquí
+        a->corte = a->medidas;
+        a->termalizado = 1;
+        liberarAnalisis(a);
+        return;
+    }
+    if (a->medidas % INTERVALO_MSER != 0) {
+        return;
+    }
+
+    // Tienen que haber terminado la deriva de la energía y la de la magnetización
+    long corte_e = truncamientoMSER(a->serie_e.valores, a->serie_e.muestras);
+    long corte_m = truncamientoMSER(a->serie_m.valores, a->serie_m.muestras);
+    if (corte_e < 0 || corte_m < 0) {
+        return;
+    }
+
+    long k;
+    a->corte = (corte_e > corte_m) ? corte_e : corte_m;
+    a->termalizado = 1;
+    for (k = a->corte; k < a->serie_e.muestras; k++) {
+        acumularMedidaTermalizada(a, a->serie_e.valores[k], a->serie_m.valores[k], num_espines);
+    }
+    liberarAnalisis(a);
+}
+
+int errorObjetivoAlcanzado(const AnalisisSimulacion *a, double objetivo) {
+    if (!a->termalizado) {
+        return 0;
+    }
+    double tau_e = tiempoAutocorrelacion(&a->autocorrelacion_e);
+    double tau_m = tiempoAutocorrelacion(&a->autocorrelacion_m);
+    double tau = (tau_e > tau_m) ? tau_e : tau_m;
+    if (a->acumulador.muestras < 32 * 2 * ceil(2 * tau)) {
+        return 0;
+    }
+    return errorBloques(&a->bloques_e) < objetivo && errorBloques(&a->bloques_m) < objetivo;
+}
+
+// Los campos se escriben uno a uno (nunca la estructura entera, que tiene
+// punteros y relleno). Cada vector va precedido de su número de elementos.
+static int escribirVector(FILE *archivo, const void *datos, size_t tamano, long elementos) {
+    return fwrite(&elementos, sizeof(elementos), 1, archivo) != 1 ||
+           fwrite(datos, tamano, elementos, archivo) != (size_t)elementos;
+}
+
+// Lee un vector de escribirVector, que tiene que tener 'elementos' elementos
+static int leerVector(FILE *archivo, void *datos, size_t tamano, long elementos) {
+    long guardados;
+    return fread(&guardados, sizeof(guardados), 1, archivo) != 1 || guardados != elementos ||
+           fread(datos, tamano, elementos, archivo) != (size_t)elementos;
+}
+
+static int escribirAcumulador(FILE *archivo, const AcumuladorObservables *a) {
+    double sumas[6] = {a->media_e, a->m2_e, a->media_m_abs, a->m2_m_abs, a->media_m2, a->media_m4};
+    return fwrite(&a->muestras, sizeof(a->muestras), 1, archivo) != 1 ||
+           escribirVector(archivo, sumas, sizeof(double), 6);
+}
+
+static int leerAcumulador(FILE *archivo, AcumuladorObservables *a) {
+    double sumas[6];
+    if (fread(&a->muestras, sizeof(a->muestras), 1, archivo) != 1 ||
+        leerVector(archivo, sumas, sizeof(double), 6)) {
+        return 1;
+    }
+    a->media_e = sumas[0];
+    a->m2_e = sumas[1];
+    a->media_m_abs = sumas[2];
+    a->m2_m_abs = sumas[3];
+    a->media_m2 = sumas[4];
+    a->media_m4 = sumas[5];
+    return 0;
+}
+
+static int escribirAutocorrelacion(FILE *archivo, const Autocorrelacion *a) {
+    return fwrite(&a->muestras, sizeof(a->muestras), 1, archivo) != 1 ||
+           fwrite(&a->referencia, sizeof(a->referencia), 1, archivo) != 1 ||
+           fwrite(&a->suma, sizeof(a->suma), 1, archivo) != 1 ||
+           escribirVector(archivo, a->historial, sizeof(double), MAXIMO_RETARDO) ||
+           escribirVector(archivo, a->suma_productos, sizeof(double), MAXIMO_RETARDO + 1);
+}
+
+static int leerAutocorrelacion(FILE *archivo, Autocorrelacion *a) {
+    return fread(&a->muestras, sizeof(a->muestras), 1, archivo) != 1 ||
+           fread(&a->referencia, sizeof(a->referencia), 1, archivo) != 1 ||
+           fread(&a->suma, sizeof(a->suma), 1, archivo) != 1 ||
+           leerVector(archivo, a->historial, sizeof(double), MAXIMO_RETARDO) ||
+           leerVector(archivo, a->suma_productos, sizeof(double), MAXIMO_RETARDO + 1);
+}
+
+static int escribirBloques(FILE *archivo, const AnalisisBloques *b) {
+    return fwrite(&b->muestras, sizeof(b->muestras), 1, archivo) != 1 ||
+           fwrite(&b->referencia, sizeof(b->referencia), 1, archivo) != 1 ||
+           escribirVector(archivo, b->pendiente, sizeof(double), NIVELES_BLOQUES) ||
+           escribirVector(archivo, b->hay_pendiente, sizeof(int), NIVELES_BLOQUES) ||
+           escribirVector(archivo, b->bloques, sizeof(long), NIVELES_BLOQUES) ||
+           escribirVector(archivo, b->suma, sizeof(double), NIVELES_BLOQUES) ||
+           escribirVector(archivo, b->suma2, sizeof(double), NIVELES_BLOQUES);
+}
+
+static int leerBloques(FILE *archivo, AnalisisBloques *b) {
+    return fread(&b->muestras, sizeof(b->muestras), 1, archivo) != 1 ||
+           fread(&b->referencia, sizeof(b->referencia), 1, archivo) != 1 ||
+           leerVector(archivo, b->pendiente, sizeof(double), NIVELES_BLOQUES) ||
+           leerVector(archivo, b->hay_pendiente, sizeof(int), NIVELES_BLOQUES) ||
+           leerVector(archivo, b->bloques, sizeof(long), NIVELES_BLOQUES) ||
+           leerVector(archivo, b->suma, sizeof(double), NIVELES_BLOQUES) ||
+           leerVector(archivo, b->suma2, sizeof(double), NIVELES_BLOQUES);
+}
+
+int guardarAnalisis(FILE *archivo, const AnalisisSimulacion *a) {
+    // El histograma no forma parte del análisis guardado: lo vuelve a enlazar quien lo use
+    if (fwrite(&a->termalizado, sizeof(a->termalizado), 1, archivo) != 1 ||
+        fwrite(&a->medidas, sizeof(a->medidas), 1, archivo) != 1 ||
+        fwrite(&a->corte, sizeof(a->corte), 1, archivo) != 1 ||
+        escribirAcumulador(archivo, &a->acumulador) ||
+        escribirAutocorrelacion(archivo, &a->autocorrelacion_e) ||
+        escribirAutocorrelacion(archivo, &a->autocorrelacion_m) ||
+        escribirBloques(archivo, &a->bloques_e) ||
+        escribirBloques(archivo, &a->bloques_m)) {
+        return 1;
+    }
+    if (a->termalizado) {
+        return 0;
+    }
+    return escribirVector(archivo, a->serie_e.valores, sizeof(double), a->serie_e.muestras) ||
+           escribirVector(archivo, a->serie_m.valores, sizeof(double), a->serie_m.muestras);
+}
+
+// Lee el número de valores de la serie, la reserva con sitio para ellos y los lee
+static int leerSerie(FILE *archivo, SerieTemporal *s) {
+    long muestras;
+    if (fread(&muestras, sizeof(muestras), 1, archivo) != 1 || muestras < 0) {
+        return 1;
+    }
+    s->muestras = muestras;
+    s->capacidad = 1024;
+    while (s->capacidad < muestras) {
+        s->capacidad *= 2;
+    }
+    s->valores = malloc(s->capacidad * sizeof(double));
+    if (s->valores == NULL) {
+        return 1;
+    }
+    return fread(s->valores, sizeof(double), muestras, archivo) != (size_t)muestras;
+}
+
+int leerAnalisis(FILE *archivo, AnalisisSimulacion *a) {
+    a->serie_e.valores = NULL;
+    a->serie_m.valores = NULL;
+    a->serie_e.muestras = a->serie_m.muestras = 0;
+    a->serie_e.capacidad = a->serie_m.capacidad = 0;
+    a->histograma = NULL;
+    if (fread(&a->termalizado, sizeof(a->termalizado), 1, archivo) != 1 ||
+        fread(&a->medidas, sizeof(a->medidas), 1, archivo) != 1 ||
+        fread(&a->corte, sizeof(a->corte), 1, archivo) != 1 ||
+        leerAcumulador(archivo, &a->acumulador) ||
+        leerAutocorrelacion(archivo, &a->autocorrelacion_e) ||
+        leerAutocorrelacion(archivo, &a->autocorrelacion_m) ||
+        leerBloques(archivo, &a->bloques_e) ||
+        leerBloques(archivo, &a->bloques_m)) {
+        return 1;
+    }
+    if (a->termalizado) {
+        return 0;
+    }
+    if (leerSerie(archivo, &a->serie_e) != 0 || leerSerie(archivo, &a->serie_m) != 0) {
+        liberarAnalisis(a);
+        return 1;
+    }
+    return 0;
+}
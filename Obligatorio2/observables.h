@@ -0,0 +1,160 @@
+#ifndef OBSERVABLES_H
+#define OBSERVABLES_H
+
+#include <stdio.h>
+
+// Acumulador en línea de los observables del modelo de Ising: guarda solo
+// sumas (medias de Welford para e y |m|), no la serie temporal completa.
+// e = E / num_espines y m = M / num_espines son valores por espín.
+typedef struct {
+    long muestras;
+    double media_e, m2_e;           // Media y suma de cuadrados de desviaciones de e
+    double media_m_abs, m2_m_abs;   // Lo mismo para |m|
+    double media_m2, media_m4;      // <m^2> y <m^4>
+} AcumuladorObservables;
+
+// Resultados físicos a partir del acumulador
+typedef struct {
+    long muestras;
+    double energia, energia2;  // <e>, <e^2>
+    double magnetizacion_abs;  // <|m|>
+    double magnetizacion2;     // <m^2>
+    double magnetizacion4;     // <m^4>
+    double calor_especifico;   // C = beta^2 * num_espines * (<e^2> - <e>^2)
+    double susceptibilidad;    // chi = beta * num_espines * (<m^2> - <|m|>^2)
+    double binder;             // U = 1 - <m^4> / (3 <m^2>^2)
+} ResultadosObservables;
+
+void iniciarAcumulador(AcumuladorObservables *a);
+
+// Añade una medida con la energía y magnetización totales de la red
+void acumularMuestra(AcumuladorObservables *a, double energia, double magnetizacion, int num_espines);
+
+void calcularResultados(const AcumuladorObservables *a, double beta, int num_espines, ResultadosObservables *r);
+
+// Escribe los resultados en un fichero (una línea por observable)
+void escribirResultados(FILE *archivo, const ResultadosObservables *r);
+
+// Función de autocorrelación en línea hasta un retardo máximo: guarda los
+// últimos MAXIMO_RETARDO valores y las sumas de productos x_t * x_{t-k}
+#define MAXIMO_RETARDO 1000
+
+typedef struct {
+    long muestras;
+    double referencia;                         // Primer valor, se resta para reducir cancelaciones
+    double historial[MAXIMO_RETARDO];          // Anillo con los últimos valores (ya desplazados)
+    double suma;
+    double suma_productos[MAXIMO_RETARDO + 1]; // Suma de x_t * x_{t-k}
+} Autocorrelacion;
+
+void iniciarAutocorrelacion(Autocorrelacion *a);
+void acumularAutocorrelacion(Autocorrelacion *a, double x);
+
+// Tiempo de autocorrelación integrado tau = 1/2 + sum_k rho(k), con la
+// ventana automática de Sokal (se corta en el primer W >= 6 tau(W)).
+// Las muestras independientes son aproximadamente muestras / (2 tau).
+double tiempoAutocorrelacion(const Autocorrelacion *a);
+
+// Error de la media por bloques (Flyvbjerg y Petersen) en línea: en el nivel l
+// cada muestra es la media de 2^l medidas consecutivas. Al crecer los bloques
+// dejan de estar correlacionados y el error estimado llega a una meseta.
+#define NIVELES_BLOQUES 40
+
+typedef struct {
+    long muestras;
+    double referencia;                        // Primer valor, se resta como en Autocorrelacion
+    double pendiente[NIVELES_BLOQUES];        // Mitad de un bloque esperando a su pareja
+    int hay_pendiente[NIVELES_BLOQUES];
+    long bloques[NIVELES_BLOQUES];            // Bloques completos en cada nivel
+    double suma[NIVELES_BLOQUES], suma2[NIVELES_BLOQUES];
+} AnalisisBloques;
+
+void iniciarBloques(AnalisisBloques *b);
+void acumularBloques(AnalisisBloques *b, double x);
+
+// Error de la media: el mayor de los niveles con al menos 32 bloques (la
+// meseta, o una cota por encima si todavía no se ha alcanzado)
+double errorBloques(const AnalisisBloques *b);
+
+// Detección de la termalización con MSER-5 (White, 1997): se agrupa la serie
+// en medias de 5 medidas y se elige el número de medidas iniciales a
+// descartar que minimiza la varianza de la media del resto. Si el mínimo cae
+// en la segunda mitad de la serie la deriva no ha terminado y se devuelve -1.
+long truncamientoMSER(const double *serie, long n);
+
+// Serie temporal de un observable mientras se busca la termalización
+typedef struct {
+    long muestras, capacidad;
+    double *valores;
+} SerieTemporal;
+
+int iniciarSerie(SerieTemporal *s);
+int anadirSerie(SerieTemporal *s, double x);
+void liberarSerie(SerieTemporal *s);
+
+// Histograma de la energía total de las medidas termalizadas, con la suma
+// de |m|, m^2 y m^4 de las medidas de cada energía. Para reponderar a otra
+// temperatura sin campo (reponderacion.h) no hace falta más del histograma
+// conjunto de E y M: los observables de M solo entran a través de sus medias
+// a energía fija. Las energías son enteras (J = 1) y el histograma se amplía
+// según aparecen energías nuevas.
+typedef struct {
+    double beta;
+    int lado, num_espines;
+    char sistema[64];       // Red simulada ("cuadrada-periodico"...): solo se combinan histogramas de la misma
+    double tau_e;           // Tiempo de autocorrelación de e (pesa cada simulación al combinarlas)
+    int error;              // 1 si faltó memoria y se perdieron medidas
+    long muestras;
+    long energia_minima;    // Energía del primer bin
+    int num_bins;
+    long *cuentas;
+    double *suma_m_abs, *suma_m2, *suma_m4; // Sumas de |m|, m^2 y m^4 (por espín) en cada bin
+} HistogramaEnergia;
+
+void iniciarHistograma(HistogramaEnergia *h, double beta, int lado, int num_espines, const char *sistema);
+void liberarHistograma(HistogramaEnergia *h);
+
+// Añade una medida con la energía y magnetización totales de la red
+void acumularHistograma(HistogramaEnergia *h, double energia, double magnetizacion);
+
+// Fichero de texto con una cabecera "clave valor" y una línea por energía
+// con medidas. Devuelven 0 si todo va bien (leerHistograma reserva los bins).
+int guardarHistograma(const char *ruta, const HistogramaEnergia *h);
+int leerHistograma(const char *ruta, HistogramaEnergia *h);
+
+// Todo el análisis de una simulación: hasta detectar la termalización se
+// guardan las series de e y |m|; a partir de ahí las medidas (también las
+// guardadas desde el punto de corte de MSER) van a los acumuladores.
+#define INTERVALO_MSER 50 // Medidas entre dos búsquedas del punto de termalización
+
+typedef struct {
+    int termalizado;
+    long medidas;                 // Medidas recibidas en total
+    long corte;                   // Medidas descartadas como termalización
+    SerieTemporal serie_e, serie_m;
+    AcumuladorObservables acumulador;
+    Autocorrelacion autocorrelacion_e, autocorrelacion_m;
+    AnalisisBloques bloques_e, bloques_m;
+    HistogramaEnergia *histograma; // Si no es NULL, recibe también las medidas termalizadas
+} AnalisisSimulacion;
+
+int iniciarAnalisis(AnalisisSimulacion *a);
+void liberarAnalisis(AnalisisSimulacion *a);
+
+// Añade la medida de un paso (energía y magnetización totales)
+void anadirMedida(AnalisisSimulacion *a, double energia, double magnetizacion, int num_espines);
+
+// Errores de <e> y <|m|> por bloques. Devuelve 1 cuando los dos están por
+// debajo de 'objetivo' y hay datos suficientes para fiarse de ellos: el error
+// por bloques solo es fiable cuando los bloques son más largos que 2 tau, y
+// el primer nivel con bloques así (las longitudes son potencias de 2) debe
+// tener al menos 32 bloques.
+int errorObjetivoAlcanzado(const AnalisisSimulacion *a, double objetivo);
+
+// Guarda/lee el estado completo del análisis (acumuladores y, si todavía no
+// se ha termalizado, las series) para continuar una simulación interrumpida.
+// leerAnalisis reserva las series. Devuelven 0 si todo va bien.
+int guardarAnalisis(FILE *archivo, const AnalisisSimulacion *a);
+int leerAnalisis(FILE *archivo, AnalisisSimulacion *a);
+
+#endif
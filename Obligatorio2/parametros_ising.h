@@ -0,0 +1,12 @@
+#ifndef PARAMETROS_ISING_H
+#define PARAMETROS_ISING_H
+
+// Parámetros por defecto de las simulaciones de Ising, compartidos por
+// ising.c e isingmpi.c para que las dos versiones simulen lo mismo
+#define N 200 // Tamaño de la red (N x N) si no se indica otro al ejecutar
+#define pasosmontecarlo 2000 // Máximo de pasos: la simulación para antes si se alcanza el error objetivo
+#define errorobjetivo 5e-4   // Error estadístico buscado en <e> y <|m|> (por espín)
+#define T 3.0
+#define K_BOLTZMANN 1.0 // Constante de Boltzmann (J/K)
+
+#endif
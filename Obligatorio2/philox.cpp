@@ -1,26 +1,83 @@
 #include <iostream>
+#include <iomanip>
 #include <random>
+#include <chrono>
+#include "aleatorio.h"
+
+// Comprobación y medida de velocidad del generador Philox4x32-10 de philox.h,
+// el que usan ising.c e isignencplusplus.cpp.
+// Compilación: g++ -O3 -march=native philox.cpp -o philox
+
+// Valores de referencia de Random123 (kat_vectors) para Philox4x32-10
+struct CasoPrueba {
+    uint32_t contador[4];
+    uint32_t clave[2];
+    uint32_t esperado[4];
+};
 
 int main() {
-    // Define el tipo de motor Philox
-    // Placeholder for Philox engine, replace with a custom implementation or library
-    using PhiloxEngine = std::mt19937; // Standard Mersenne Twister as an alternative
+    const CasoPrueba casos[] = {
+        {{0, 0, 0, 0}, {0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+        {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff},
+         {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+        {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0},
+         {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+    };
+
+    bool correcto = true;
+    for (const CasoPrueba &caso : casos) {
+        uint32_t salida[4];
+        philox4x32(caso.contador, caso.clave, salida);
+        for (int k = 0; k < 4; k++) {
+            correcto = correcto && salida[k] == caso.esperado[k];
+        }
+    }
+
+    // Los bloques calculados en grupo deben coincidir con los calculados de uno en uno
+    uint32_t bloques[4 * PHILOX_BLOQUES];
+    philox4x32Bloques(casos[2].contador, casos[2].clave, bloques);
+    for (int b = 0; b < PHILOX_BLOQUES; b++) {
+        uint32_t contador[4] = {casos[2].contador[0] + b, casos[2].contador[1], casos[2].contador[2],
+                                casos[2].contador[3]};
+        uint32_t salida[4];
+        philox4x32(contador, casos[2].clave, salida);
+        for (int k = 0; k < 4; k++) {
+            correcto = correcto && salida[k] == bloques[4 * b + k];
+        }
+    }
+    std::cout << "Valores de referencia de Philox4x32-10: " << (correcto ? "correctos" : "INCORRECTOS") << std::endl;
 
     // Genera una semilla usando std::random_device
     std::random_device rd;
-    std::seed_seq seed{rd(), rd(), rd(), rd()};
+    uint64_t semilla = (static_cast<uint64_t>(rd()) << 32) | rd();
+    GeneradorHilo generador;
+    inicializarGeneradorHilo(&generador, semilla, 0);
 
-    // Crea una instancia del motor Philox con la semilla
-    PhiloxEngine engine(seed);
+    // Genera un número aleatorio uniforme en [0, 1)
+    double randomNumber = aleatorioUniforme(&generador);
+    std::cout << "Número aleatorio generado con Philox: " << randomNumber << std::endl;
 
-    // Define una distribución uniforme de punto flotante entre 0.0 y 1.0
-    std::uniform_real_distribution<> distribution(0.0, 1.0);
+    // Velocidad frente a std::mt19937
+    const long cantidad = 100000000;
+    double suma = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < cantidad; i++) {
+        suma += aleatorioUniforme(&generador);
+    }
+    double segundos_philox = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
 
-    // Genera un número aleatorio utilizando la distribución y el motor
-    double randomNumber = distribution(engine);
+    std::mt19937 mersenne(static_cast<unsigned>(semilla));
+    std::uniform_real_distribution<> distribucion(0.0, 1.0);
+    inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < cantidad; i++) {
+        suma += distribucion(mersenne);
+    }
+    double segundos_mersenne = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
 
-    // Muestra el número aleatorio por pantalla
-    std::cout << "Número aleatorio generado con Philox: " << randomNumber << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "Philox:  " << cantidad / segundos_philox / 1e6 << " millones de uniformes por segundo" << std::endl
+              << "mt19937: " << cantidad / segundos_mersenne / 1e6 << " millones de uniformes por segundo" << std::endl
+              << "(media " << std::setprecision(4) << suma / (2.0 * cantidad) << ")" << std::endl;
 
-    return 0;
-}
\ No newline at end of file
+    return correcto ? 0 : 1;
+}
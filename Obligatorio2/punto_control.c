@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "punto_control.h"
+
+int guardarPuntoControl(const char *ruta, const EstadoPuntoControl *estado, const RedIsing *red,
+                        const GeneradorHilo generadores[], const AnalisisSimulacion *analisis) {
+    char ruta_temporal[4096];
+    EstadoPuntoControl cabecera = *estado;
+    int i, error = 0;
+
+    if (snprintf(ruta_temporal, sizeof(ruta_temporal), "%s.tmp", ruta) >= (int)sizeof(ruta_temporal)) {
+        return 1;
+    }
+    FILE *archivo = fopen(ruta_temporal, "wb");
+    if (archivo == NULL) {
+        return 1;
+    }
+
+    memcpy(cabecera.magia, PUNTO_CONTROL_MAGIA, 8);
+    cabecera.version = PUNTO_CONTROL_VERSION;
+    cabecera.n = red->n;
+    error |= fwrite(&cabecera, sizeof(cabecera), 1, archivo) != 1;
+    for (i = 0; i < red->n && !error; i++) {
+        error |= fwrite(filaRed(red, i), 1, red->n, archivo) != (size_t)red->n;
+    }
+    error |= fwrite(generadores, sizeof(GeneradorHilo), estado->hilos, archivo) != (size_t)estado->hilos;
+    error |= guardarAnalisis(archivo, analisis) != 0;
+
+    // Los datos tienen que estar en el disco antes de sustituir el punto de
+    // control anterior: si no, un corte justo después podría dejar el nuevo vacío
+    error |= fflush(archivo) != 0;
+    error |= fsync(fileno(archivo)) != 0;
+    error |= fclose(archivo) != 0;
+    if (error || rename(ruta_temporal, ruta) != 0) {
+        remove(ruta_temporal);
+        return 1;
+    }
+    return 0;
+}
+
+// Abre el punto de control y comprueba su cabecera
+static FILE *abrirPuntoControl(const char *ruta, EstadoPuntoControl *estado) {
+    FILE *archivo = fopen(ruta, "rb");
+    if (archivo == NULL) {
+        return NULL;
+    }
+    if (fread(estado, sizeof(*estado), 1, archivo) != 1 ||
+        memcmp(estado->magia, PUNTO_CONTROL_MAGIA, 8) != 0 ||
+        estado->version != PUNTO_CONTROL_VERSION ||
+        estado->n < 2 || estado->hilos < 1) {
+        fclose(archivo);
+        return NULL;
+    }
+    return archivo;
+}
+
+int leerEstadoPuntoControl(const char *ruta, EstadoPuntoControl *estado) {
+    FILE *archivo = abrirPuntoControl(ruta, estado);
+    if (archivo == NULL) {
+        return 1;
+    }
+    fclose(archivo);
+    return 0;
+}
+
+int leerPuntoControl(const char *ruta, EstadoPuntoControl *estado, RedIsing *red,
+                     GeneradorHilo generadores[], AnalisisSimulacion *analisis) {
+    int i, error = 0;
+    FILE *archivo = abrirPuntoControl(ruta, estado);
+    if (archivo == NULL) {
+        return 1;
+    }
+    if (estado->n != red->n) {
+        fclose(archivo);
+        return 1;
+    }
+
+    for (i = 0; i < red->n && !error; i++) {
+        error |= fread(filaRed(red, i), 1, red->n, archivo) != (size_t)red->n;
+    }
+    actualizarBordes(red);
+    error |= fread(generadores, sizeof(GeneradorHilo), estado->hilos, archivo) != (size_t)estado->hilos;
+    if (!error) {
+        error = leerAnalisis(archivo, analisis) != 0;
+    }
+    fclose(archivo);
+    return error;
+}
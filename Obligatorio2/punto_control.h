@@ -0,0 +1,53 @@
+#ifndef PUNTO_CONTROL_H
+#define PUNTO_CONTROL_H
+
+#include <stdint.h>
+#include "aleatorio.h"
+#include "observables.h"
+#include "red_ising.h"
+#include "ising_cluster.h"
+
+// Puntos de control de una simulación de Ising: con lo que guardan se
+// continúa la simulación exactamente igual que si no se hubiera
+// interrumpido (misma red, mismos números aleatorios, mismas medias).
+// Formato binario (del mismo ordenador y el mismo ejecutable):
+//   - EstadoPuntoControl
+//   - La red: n filas de n bytes (sin el borde fantasma)
+//   - Los generadores de los hilos (GeneradorHilo, uno por hilo)
+//   - El análisis (guardarAnalisis, de observables.h: campo a campo, los vectores con su longitud)
+// Se escribe en un fichero temporal que después se renombra, así que un
+// corte a mitad de escritura deja intacto el punto de control anterior.
+#define PUNTO_CONTROL_MAGIA "ISINGPCT"
+#define PUNTO_CONTROL_VERSION 4
+
+typedef struct {
+    char magia[8];            // "ISINGPCT"
+    uint32_t version;
+    int32_t n;                // Tamaño de la red (n x n)
+    int32_t algoritmo;        // Algoritmo de actualización (ALGORITMO_* de ising.c)
+    int32_t hilos;            // Generadores guardados: el barrido en paralelo solo se repite igual con los mismos hilos
+    uint64_t semilla;
+    double beta;
+    int64_t paso;             // Siguiente paso Monte Carlo que hay que hacer
+    double energia;
+    int64_t magnetizacion;
+    uint64_t fotogramas;      // Fotogramas de la trayectoria escritos hasta aquí
+    int64_t bytes_energias;   // Bytes de energias.txt escritos hasta aquí
+    int64_t bytes_texto;      // Bytes de matriz_red.txt (si se guarda)
+    AjusteWolff ajuste_wolff; // Clusters por paso de Wolff
+} EstadoPuntoControl;
+
+// Escribe el punto de control de forma atómica. Devuelve 0 si todo va bien.
+int guardarPuntoControl(const char *ruta, const EstadoPuntoControl *estado, const RedIsing *red,
+                        const GeneradorHilo generadores[], const AnalisisSimulacion *analisis);
+
+// Lee solo el estado (para saber el tamaño de la red, el algoritmo, la semilla...)
+int leerEstadoPuntoControl(const char *ruta, EstadoPuntoControl *estado);
+
+// Lee el punto de control completo. La red ya debe estar reservada con el
+// tamaño del punto de control y 'generadores' debe tener estado->hilos
+// elementos; las series del análisis se reservan aquí.
+int leerPuntoControl(const char *ruta, EstadoPuntoControl *estado, RedIsing *red,
+                     GeneradorHilo generadores[], AnalisisSimulacion *analisis);
+
+#endif
@@ -0,0 +1,47 @@
+#include <stdlib.h>
+#include <string.h>
+#include "red_ising.h"
+
+// Alineación de cada fila (una línea de caché, un registro AVX-512)
+#define ALINEACION 64
+
+int crearRedIsing(RedIsing *r, int n) {
+    if (n < 2) {
+        return 1;
+    }
+    r->n = n;
+    // n espines y la columna fantasma derecha; la izquierda de cada fila es
+    // el último byte del espacio de la fila anterior
+    r->paso = (n + 2 + ALINEACION - 1) / ALINEACION * ALINEACION;
+    // Un hueco de ALINEACION bytes para la columna -1 de la fila -1, y n + 2
+    // filas contando las dos fantasma
+    size_t bytes = ALINEACION + (size_t)(n + 2) * r->paso;
+    r->memoria = aligned_alloc(ALINEACION, bytes);
+    if (r->memoria == NULL) {
+        return 1;
+    }
+    memset(r->memoria, 1, bytes);
+    r->espines = r->memoria + ALINEACION + r->paso;
+    return 0;
+}
+
+void liberarRedIsing(RedIsing *r) {
+    free(r->memoria);
+    r->memoria = NULL;
+    r->espines = NULL;
+}
+
+void actualizarBordes(RedIsing *r) {
+    int i, n = r->n;
+    for (i = 0; i < n; i++) {
+        int8_t *fila = filaRed(r, i);
+        fila[-1] = fila[n - 1];
+        fila[n] = fila[0];
+    }
+    memcpy(filaRed(r, -1) - 1, filaRed(r, n - 1) - 1, (size_t)n + 2);
+    memcpy(filaRed(r, n) - 1, filaRed(r, 0) - 1, (size_t)n + 2);
+}
+
+void copiarRedIsing(RedIsing *destino, const RedIsing *origen) {
+    memcpy(destino->memoria, origen->memoria, ALINEACION + (size_t)(origen->n + 2) * origen->paso);
+}
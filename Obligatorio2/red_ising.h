@@ -0,0 +1,52 @@
+#ifndef RED_ISING_H
+#define RED_ISING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Red de Ising n x n con el tamaño elegido al ejecutar. Cada espín ocupa un
+// byte (int8_t, +1/-1) y las filas están rodeadas de un borde fantasma con
+// la copia periódica del lado opuesto: la fila -1 es la n - 1, la fila n es
+// la 0, y lo mismo con las columnas. Así los cuatro vecinos de cualquier
+// espín se leen sin comprobar si está en el borde.
+// Cada fila empieza alineada a 64 bytes y ocupa 'paso' bytes.
+typedef struct {
+    int n;              // Tamaño de la red (n x n)
+    ptrdiff_t paso;     // Bytes entre el comienzo de dos filas consecutivas
+    int8_t *memoria;    // Bloque reservado
+    int8_t *espines;    // Espín (i, j) en espines[i * paso + j], con i, j entre -1 y n
+} RedIsing;
+
+// Reserva la red (todos los espines a +1). Devuelve 0 si todo va bien.
+int crearRedIsing(RedIsing *r, int n);
+void liberarRedIsing(RedIsing *r);
+
+// Puntero a la fila i (i puede ser -1 o n para leer el borde fantasma)
+static inline int8_t *filaRed(const RedIsing *r, int i) {
+    return r->espines + i * r->paso;
+}
+
+// Rehace el borde fantasma a partir de la red. Hay que llamarla después de
+// modificar muchos espines a la vez (un medio barrido, un cluster...).
+void actualizarBordes(RedIsing *r);
+
+// Da valor a un espín y, si está en el borde, también a su copia fantasma
+static inline void fijarEspin(RedIsing *r, int i, int j, int valor) {
+    int n = r->n;
+    filaRed(r, i)[j] = (int8_t)valor;
+    if (i == 0) {
+        filaRed(r, n)[j] = (int8_t)valor;
+    } else if (i == n - 1) {
+        filaRed(r, -1)[j] = (int8_t)valor;
+    }
+    if (j == 0) {
+        filaRed(r, i)[n] = (int8_t)valor;
+    } else if (j == n - 1) {
+        filaRed(r, i)[-1] = (int8_t)valor;
+    }
+}
+
+// Copia los espines de otra red del mismo tamaño (con el borde)
+void copiarRedIsing(RedIsing *destino, const RedIsing *origen);
+
+#endif
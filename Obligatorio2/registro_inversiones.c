@@ -0,0 +1,285 @@
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "registro_inversiones.h"
+#include "trayectoria.h"
+
+typedef char comprobar_cabecera_registro[(sizeof(CabeceraRegistro) == 64) ? 1 : -1];
+
+// Añade el bloque actual al índice en memoria
+static int anotarBloque(EscritorRegistro *e, uint64_t paso, uint64_t desplazamiento) {
+    size_t k = (size_t)e->cabecera.bloques;
+    if (k == e->capacidad_indice) {
+        size_t capacidad = e->capacidad_indice ? 2 * e->capacidad_indice : 64;
+        uint64_t *pasos = realloc(e->indice_pasos, capacidad * sizeof(uint64_t));
+        if (pasos == NULL) {
+            return 1;
+        }
+        e->indice_pasos = pasos;
+        uint64_t *desplazamientos = realloc(e->indice_desplazamientos, capacidad * sizeof(uint64_t));
+        if (desplazamientos == NULL) {
+            return 1;
+        }
+        e->indice_desplazamientos = desplazamientos;
+        e->capacidad_indice = capacidad;
+    }
+    e->indice_pasos[k] = paso;
+    e->indice_desplazamientos[k] = desplazamiento;
+    e->cabecera.bloques++;
+    return 0;
+}
+
+// Escribe el bloque actual (red clave + inversiones) con tres fwrite
+static int volcarBloque(EscritorRegistro *e) {
+    uint64_t cabecera_bloque[2] = {e->inicio_bloque, e->num_inversiones};
+    long desplazamiento = ftell(e->archivo);
+
+    if (desplazamiento < 0 || anotarBloque(e, e->inicio_bloque, (uint64_t)desplazamiento) != 0) {
+        return 1;
+    }
+    if (fwrite(cabecera_bloque, sizeof(cabecera_bloque), 1, e->archivo) != 1 ||
+        fwrite(e->clave, bytesFotograma((int)e->cabecera.n), 1, e->archivo) != 1 ||
+        fwrite(e->inversiones, sizeof(Inversion), e->num_inversiones, e->archivo) != e->num_inversiones) {
+        return 1;
+    }
+    e->num_inversiones = 0;
+    return 0;
+}
+
+int abrirRegistroEscritura(EscritorRegistro *e, const char *ruta, int n, const int *red,
+                           uint64_t intervalo_claves, double temperatura, uint64_t semilla) {
+    memset(e, 0, sizeof(*e));
+    memcpy(e->cabecera.magia, REGISTRO_MAGIA, 8);
+    e->cabecera.version = REGISTRO_VERSION;
+    e->cabecera.n = (uint32_t)n;
+    // El paso relativo se guarda en 32 bits
+    e->cabecera.intervalo_claves = (intervalo_claves == 0 || intervalo_claves > UINT32_MAX) ? UINT32_MAX : intervalo_claves;
+    e->cabecera.temperatura = temperatura;
+    e->cabecera.semilla = semilla;
+
+    e->capacidad = 4096;
+    e->clave = malloc(bytesFotograma(n));
+    e->inversiones = malloc(e->capacidad * sizeof(Inversion));
+    e->archivo = fopen(ruta, "wb");
+    if (e->clave == NULL || e->inversiones == NULL || e->archivo == NULL) {
+        free(e->clave);
+        free(e->inversiones);
+        if (e->archivo != NULL) {
+            fclose(e->archivo);
+        }
+        return 1;
+    }
+    setvbuf(e->archivo, NULL, _IOFBF, 1 << 20);
+    empaquetarFotograma(red, n, e->clave);
+    return fwrite(&e->cabecera, sizeof(e->cabecera), 1, e->archivo) != 1;
+}
+
+int registrarPaso(EscritorRegistro *e, int sitio, const int *red) {
+    uint64_t paso = e->cabecera.pasos;
+
+    if (sitio >= 0) {
+        if (e->num_inversiones == e->capacidad) {
+            Inversion *mayor = realloc(e->inversiones, 2 * e->capacidad * sizeof(Inversion));
+            if (mayor == NULL) {
+                return 1;
+            }
+            e->inversiones = mayor;
+            e->capacidad *= 2;
+        }
+        e->inversiones[e->num_inversiones].paso_relativo = (uint32_t)(paso - e->inicio_bloque);
+        e->inversiones[e->num_inversiones].sitio = (uint32_t)sitio;
+        e->num_inversiones++;
+    }
+    e->cabecera.pasos++;
+
+    // Al completar el intervalo se escribe el bloque y la red actual pasa a ser la nueva clave
+    if (e->cabecera.pasos - e->inicio_bloque == e->cabecera.intervalo_claves) {
+        if (volcarBloque(e) != 0) {
+            return 1;
+        }
+        e->inicio_bloque = e->cabecera.pasos;
+        empaquetarFotograma(red, (int)e->cabecera.n, e->clave);
+    }
+    return 0;
+}
+
+int cerrarRegistroEscritura(EscritorRegistro *e) {
+    int error = 0;
+    long desplazamiento;
+    size_t bloques;
+
+    // El último bloque se escribe aunque esté incompleto (o vacío si el
+    // registro acaba justo en una clave, para conservar la red final)
+    error |= volcarBloque(e);
+
+    desplazamiento = ftell(e->archivo);
+    bloques = (size_t)e->cabecera.bloques;
+    if (desplazamiento < 0 ||
+        fwrite(e->indice_pasos, sizeof(uint64_t), bloques, e->archivo) != bloques ||
+        fwrite(e->indice_desplazamientos, sizeof(uint64_t), bloques, e->archivo) != bloques) {
+        error = 1;
+    } else {
+        e->cabecera.desplazamiento_indice = (uint64_t)desplazamiento;
+    }
+    if (fseek(e->archivo, 0, SEEK_SET) != 0 ||
+        fwrite(&e->cabecera, sizeof(e->cabecera), 1, e->archivo) != 1) {
+        error = 1;
+    }
+    if (fclose(e->archivo) != 0) {
+        error = 1;
+    }
+    free(e->clave);
+    free(e->inversiones);
+    free(e->indice_pasos);
+    free(e->indice_desplazamientos);
+    memset(e, 0, sizeof(*e));
+    return error;
+}
+
+// Recorre los bloques completos de un registro que no se cerró
+static int reconstruirIndice(LectorRegistro *l) {
+    uint64_t bytes_clave = bytesFotograma((int)l->cabecera.n);
+    size_t posicion = sizeof(CabeceraRegistro), capacidad = 0, bloques = 0;
+
+    l->cabecera.pasos = 0;
+    while (posicion + 16 + bytes_clave <= l->bytes) {
+        uint64_t cabecera_bloque[2];
+        memcpy(cabecera_bloque, l->datos + posicion, sizeof(cabecera_bloque));
+        size_t fin = posicion + 16 + bytes_clave + cabecera_bloque[1] * sizeof(Inversion);
+        if (fin > l->bytes) {
+            break;
+        }
+        if (bloques == capacidad) {
+            capacidad = capacidad ? 2 * capacidad : 64;
+            uint64_t *pasos = realloc(l->indice_pasos, capacidad * sizeof(uint64_t));
+            if (pasos == NULL) {
+                return 1;
+            }
+            l->indice_pasos = pasos;
+            uint64_t *desplazamientos = realloc(l->indice_desplazamientos, capacidad * sizeof(uint64_t));
+            if (desplazamientos == NULL) {
+                return 1;
+            }
+            l->indice_desplazamientos = desplazamientos;
+        }
+        l->indice_pasos[bloques] = cabecera_bloque[0];
+        l->indice_desplazamientos[bloques] = posicion;
+        bloques++;
+        // Sin el total no se sabe si hubo intentos rechazados al final del
+        // último bloque; se llega hasta la última inversión registrada
+        l->cabecera.pasos = cabecera_bloque[0];
+        if (cabecera_bloque[1] > 0) {
+            Inversion ultima;
+            memcpy(&ultima, l->datos + fin - sizeof(Inversion), sizeof(ultima));
+            l->cabecera.pasos += ultima.paso_relativo + 1;
+        }
+        posicion = fin;
+    }
+    l->cabecera.bloques = bloques;
+    return bloques == 0;
+}
+
+int abrirRegistroLectura(LectorRegistro *l, const char *ruta) {
+    struct stat info;
+    int fd = open(ruta, O_RDONLY);
+    void *datos;
+
+    memset(l, 0, sizeof(*l));
+    if (fd < 0) {
+        return 1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CabeceraRegistro)) {
+        close(fd);
+        return 1;
+    }
+    datos = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (datos == MAP_FAILED) {
+        return 1;
+    }
+    l->datos = datos;
+    l->bytes = (size_t)info.st_size;
+    memcpy(&l->cabecera, l->datos, sizeof(l->cabecera));
+    if (memcmp(l->cabecera.magia, REGISTRO_MAGIA, 8) != 0 || l->cabecera.version != REGISTRO_VERSION) {
+        cerrarRegistroLectura(l);
+        return 1;
+    }
+
+    if (l->cabecera.desplazamiento_indice == 0) {
+        if (reconstruirIndice(l) != 0) {
+            cerrarRegistroLectura(l);
+            return 1;
+        }
+        return 0;
+    }
+
+    size_t bloques = (size_t)l->cabecera.bloques;
+    if (l->cabecera.desplazamiento_indice + 2 * bloques * sizeof(uint64_t) > l->bytes) {
+        cerrarRegistroLectura(l);
+        return 1;
+    }
+    l->indice_pasos = malloc(bloques * sizeof(uint64_t));
+    l->indice_desplazamientos = malloc(bloques * sizeof(uint64_t));
+    if (l->indice_pasos == NULL || l->indice_desplazamientos == NULL) {
+        cerrarRegistroLectura(l);
+        return 1;
+    }
+    memcpy(l->indice_pasos, l->datos + l->cabecera.desplazamiento_indice, bloques * sizeof(uint64_t));
+    memcpy(l->indice_desplazamientos, l->datos + l->cabecera.desplazamiento_indice + bloques * sizeof(uint64_t),
+           bloques * sizeof(uint64_t));
+    return 0;
+}
+
+int reconstruirPaso(const LectorRegistro *l, uint64_t paso, int *red) {
+    size_t izquierda = 0, derecha, k;
+    uint64_t cabecera_bloque[2];
+    const uint8_t *bloque, *clave;
+    int n = (int)l->cabecera.n;
+
+    if (paso > l->cabecera.pasos || l->cabecera.bloques == 0) {
+        return 1;
+    }
+
+    // Búsqueda binaria del último bloque que empieza en o antes de 'paso'
+    derecha = (size_t)l->cabecera.bloques;
+    while (derecha - izquierda > 1) {
+        size_t medio = (izquierda + derecha) / 2;
+        if (l->indice_pasos[medio] <= paso) {
+            izquierda = medio;
+        } else {
+            derecha = medio;
+        }
+    }
+
+    bloque = l->datos + l->indice_desplazamientos[izquierda];
+    memcpy(cabecera_bloque, bloque, sizeof(cabecera_bloque));
+    clave = bloque + sizeof(cabecera_bloque);
+    for (k = 0; k < (size_t)n * n; k++) {
+        red[k] = ((clave[k / 8] >> (k % 8)) & 1) ? 1 : -1;
+    }
+
+    // Aplicar las inversiones hechas antes de 'paso'
+    const uint8_t *inversiones = clave + bytesFotograma(n);
+    uint64_t limite = paso - cabecera_bloque[0];
+    for (k = 0; k < cabecera_bloque[1]; k++) {
+        Inversion inv;
+        memcpy(&inv, inversiones + k * sizeof(Inversion), sizeof(inv));
+        if (inv.paso_relativo >= limite) {
+            break;
+        }
+        red[inv.sitio] = -red[inv.sitio];
+    }
+    return 0;
+}
+
+void cerrarRegistroLectura(LectorRegistro *l) {
+    if (l->datos != NULL) {
+        munmap((void *)l->datos, l->bytes);
+    }
+    free(l->indice_pasos);
+    free(l->indice_desplazamientos);
+    memset(l, 0, sizeof(*l));
+}
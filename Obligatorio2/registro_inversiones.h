@@ -0,0 +1,87 @@
+#ifndef REGISTRO_INVERSIONES_H
+#define REGISTRO_INVERSIONES_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Registro de inversiones: en lugar de guardar la red completa tras cada
+// intento, se guarda una red clave y después solo las inversiones aceptadas
+// (paso y posición). Cada intervalo_claves pasos se empieza un bloque nuevo
+// con otra red clave, para poder saltar a cualquier paso sin reproducir
+// todo el registro desde el principio.
+//
+// Formato (little-endian):
+//   - Cabecera de 64 bytes (CabeceraRegistro).
+//   - Bloques, uno por red clave:
+//       uint64 paso inicial del bloque, uint64 número de inversiones,
+//       red clave con un bit por espín (mismo empaquetado que trayectoria.h),
+//       inversiones {uint32 paso relativo al inicio del bloque, uint32 sitio i * n + j}.
+//   - Índice final con el paso inicial y el desplazamiento de cada bloque.
+// El paso p se refiere a la red tras p intentos (el paso 0 es la red inicial).
+#define REGISTRO_MAGIA "ISINGLOG"
+#define REGISTRO_VERSION 1
+
+typedef struct {
+    char magia[8];             // "ISINGLOG"
+    uint32_t version;
+    uint32_t n;                // Tamaño de la red (n x n)
+    uint64_t pasos;            // Número total de intentos registrados
+    uint64_t intervalo_claves; // Pasos entre redes clave
+    uint64_t bloques;          // Número de bloques (se completa al cerrar)
+    uint64_t desplazamiento_indice; // Posición del índice (0 si no se cerró)
+    double temperatura;
+    uint64_t semilla;
+} CabeceraRegistro;
+
+typedef struct {
+    uint32_t paso_relativo;
+    uint32_t sitio;
+} Inversion;
+
+typedef struct {
+    FILE *archivo;
+    CabeceraRegistro cabecera;
+    uint64_t inicio_bloque;    // Paso en que empezó el bloque actual
+    uint8_t *clave;            // Red clave del bloque actual, empaquetada
+    Inversion *inversiones;    // Inversiones del bloque actual, pendientes de escribir
+    size_t num_inversiones, capacidad;
+    uint64_t *indice_pasos, *indice_desplazamientos;
+    size_t capacidad_indice;
+} EscritorRegistro;
+
+typedef struct {
+    CabeceraRegistro cabecera;
+    const uint8_t *datos;      // Fichero completo proyectado en memoria
+    size_t bytes;
+    uint64_t *indice_pasos, *indice_desplazamientos;
+} LectorRegistro;
+
+// Escritura. red es la red inicial (n x n, +1/-1, fila a fila).
+// Todas devuelven 0 si todo va bien.
+int abrirRegistroEscritura(EscritorRegistro *e, const char *ruta, int n, const int *red,
+                           uint64_t intervalo_claves, double temperatura, uint64_t semilla);
+
+// Se llama una vez por intento; sitio es la posición invertida o -1 si se
+// rechazó. red es el estado tras el intento (solo se lee al empezar un bloque).
+// Las inversiones se acumulan en memoria y se escriben de golpe al cerrar el bloque.
+int registrarPaso(EscritorRegistro *e, int sitio, const int *red);
+int cerrarRegistroEscritura(EscritorRegistro *e);
+
+// Lectura con mmap. Si el fichero no se cerró, el índice se reconstruye
+// recorriendo los bloques completos.
+int abrirRegistroLectura(LectorRegistro *l, const char *ruta);
+
+// Reconstruye la red tras 'paso' intentos (0 <= paso <= pasos): parte de la
+// red clave anterior y aplica las inversiones del bloque. Devuelve 0 si todo va bien.
+int reconstruirPaso(const LectorRegistro *l, uint64_t paso, int *red);
+void cerrarRegistroLectura(LectorRegistro *l);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,234 @@
+#include <stdlib.h>
+#include <math.h>
+#include "reponderacion.h"
+
+#define TOLERANCIA_ENERGIA_LIBRE 1e-9  // Cambio máximo de las f_r para dar por convergida la iteración
+#define MAXIMO_ITERACIONES 20000
+#define ITERACIONES_BISECCION 60
+
+// ln(sum_k e^(x_k)) sin desbordamientos (los -INFINITY no suman)
+static double sumaLogaritmica(const double *x, int num) {
+    double maximo = -INFINITY, suma = 0.0;
+    int k;
+    for (k = 0; k < num; k++) {
+        if (x[k] > maximo) {
+            maximo = x[k];
+        }
+    }
+    if (maximo == -INFINITY) {
+        return -INFINITY;
+    }
+    for (k = 0; k < num; k++) {
+        suma += exp(x[k] - maximo);
+    }
+    return maximo + log(suma);
+}
+
+// ln g(E) a partir de las energías libres f_r
+static void calcularDensidad(Reponderacion *r, const HistogramaEnergia histogramas[], const double *log_numerador,
+                             const double *log_peso, const double *f, double *terminos) {
+    int k, h;
+    for (k = 0; k < r->num_bins; k++) {
+        double energia = (double)(r->energia_minima + k);
+        if (log_numerador[k] == -INFINITY) {
+            r->log_densidad[k] = -INFINITY;
+            continue;
+        }
+        for (h = 0; h < r->num_histogramas; h++) {
+            terminos[h] = log_peso[h] + f[h] - histogramas[h].beta * energia;
+        }
+        r->log_densidad[k] = log_numerador[k] - sumaLogaritmica(terminos, r->num_histogramas);
+    }
+}
+
+int crearReponderacion(Reponderacion *r, const HistogramaEnergia histogramas[], int num) {
+    int h, k;
+    long maximo;
+
+    r->num_histogramas = num;
+    r->lado = histogramas[0].lado;
+    r->num_espines = histogramas[0].num_espines;
+    r->muestras = 0;
+    r->energia_minima = histogramas[0].energia_minima;
+    maximo = histogramas[0].energia_minima + histogramas[0].num_bins - 1;
+    r->t_minima = r->t_maxima = 1.0 / histogramas[0].beta;
+    for (h = 0; h < num; h++) {
+        const HistogramaEnergia *hist = &histogramas[h];
+        if (hist->energia_minima < r->energia_minima) {
+            r->energia_minima = hist->energia_minima;
+        }
+        if (hist->energia_minima + hist->num_bins - 1 > maximo) {
+            maximo = hist->energia_minima + hist->num_bins - 1;
+        }
+        r->t_minima = fmin(r->t_minima, 1.0 / hist->beta);
+        r->t_maxima = fmax(r->t_maxima, 1.0 / hist->beta);
+        r->muestras += hist->muestras;
+    }
+    r->num_bins = (int)(maximo - r->energia_minima + 1);
+
+    r->log_densidad = malloc(r->num_bins * sizeof(double));
+    r->media_m_abs = calloc(r->num_bins, sizeof(double));
+    r->media_m2 = calloc(r->num_bins, sizeof(double));
+    r->media_m4 = calloc(r->num_bins, sizeof(double));
+    double *log_numerador = calloc(r->num_bins, sizeof(double));
+    double *cuentas = calloc(r->num_bins, sizeof(double));
+    double *terminos = malloc((r->num_bins > num ? r->num_bins : num) * sizeof(double));
+    double *log_peso = malloc(num * sizeof(double)); // ln(n_r / (1 + 2 tau_r))
+    double *f = calloc(num, sizeof(double));         // Energías libres adimensionales beta_r F_r
+
+    // Si falla alguna reserva se liberan las que sí se hicieron (free(NULL) no hace nada)
+    if (r->log_densidad == NULL || r->media_m_abs == NULL || r->media_m2 == NULL || r->media_m4 == NULL ||
+        log_numerador == NULL || cuentas == NULL || terminos == NULL || log_peso == NULL || f == NULL) {
+        free(log_numerador);
+        free(cuentas);
+        free(terminos);
+        free(log_peso);
+        free(f);
+        liberarReponderacion(r);
+        return 1;
+    }
+
+    // Numerador de g(E), sum_r H_r(E) / (1 + 2 tau_r), y las medias de |m|,
+    // m^2 y m^4 a energía fija (no dependen de la temperatura)
+    for (h = 0; h < num; h++) {
+        const HistogramaEnergia *hist = &histogramas[h];
+        double ineficiencia = 1.0 + 2.0 * fmax(hist->tau_e, 0.0);
+        int desplazamiento = (int)(hist->energia_minima - r->energia_minima);
+        log_peso[h] = log(hist->muestras / ineficiencia);
+        for (k = 0; k < hist->num_bins; k++) {
+            int bin = k + desplazamiento;
+            log_numerador[bin] += hist->cuentas[k] / ineficiencia;
+            cuentas[bin] += hist->cuentas[k];
+            r->media_m_abs[bin] += hist->suma_m_abs[k];
+            r->media_m2[bin] += hist->suma_m2[k];
+            r->media_m4[bin] += hist->suma_m4[k];
+        }
+    }
+    for (k = 0; k < r->num_bins; k++) {
+        log_numerador[k] = (log_numerador[k] > 0) ? log(log_numerador[k]) : -INFINITY;
+        if (cuentas[k] > 0) {
+            r->media_m_abs[k] /= cuentas[k];
+            r->media_m2[k] /= cuentas[k];
+            r->media_m4[k] /= cuentas[k];
+        }
+    }
+
+    // Iteración de Ferrenberg y Swendsen hasta que las f_r no cambian:
+    //   ln g(E) = ln numerador(E) - ln sum_r n_r / (1 + 2 tau_r) e^(f_r - beta_r E)
+    //   f_r = -ln sum_E g(E) e^(-beta_r E)
+    // con f_0 = 0 para fijar la constante arbitraria de g(E)
+    for (r->iteraciones = 1; r->iteraciones <= MAXIMO_ITERACIONES; r->iteraciones++) {
+        double cambio = 0.0, referencia = 0.0;
+        calcularDensidad(r, histogramas, log_numerador, log_peso, f, terminos);
+        for (h = 0; h < num; h++) {
+            for (k = 0; k < r->num_bins; k++) {
+                terminos[k] = r->log_densidad[k] - histogramas[h].beta * (double)(r->energia_minima + k);
+            }
+            double nueva = -sumaLogaritmica(terminos, r->num_bins);
+            if (h == 0) {
+                referencia = nueva;
+            }
+            nueva -= referencia;
+            cambio = fmax(cambio, fabs(nueva - f[h]));
+            f[h] = nueva;
+        }
+        if (cambio < TOLERANCIA_ENERGIA_LIBRE) {
+            break;
+        }
+    }
+    calcularDensidad(r, histogramas, log_numerador, log_peso, f, terminos);
+
+    free(log_numerador);
+    free(cuentas);
+    free(terminos);
+    free(log_peso);
+    free(f);
+    return 0;
+}
+
+void liberarReponderacion(Reponderacion *r) {
+    free(r->log_densidad);
+    free(r->media_m_abs);
+    free(r->media_m2);
+    free(r->media_m4);
+    r->log_densidad = r->media_m_abs = r->media_m2 = r->media_m4 = NULL;
+}
+
+void observablesReponderados(const Reponderacion *r, double beta, ResultadosObservables *res) {
+    double maximo = -INFINITY, z = 0.0, energia = 0.0, varianza = 0.0;
+    double m_abs = 0.0, m2 = 0.0, m4 = 0.0;
+    double n = r->num_espines;
+    int k;
+
+    // Pesos e^(ln g(E) - beta E) relativos al mayor
+    for (k = 0; k < r->num_bins; k++) {
+        maximo = fmax(maximo, r->log_densidad[k] - beta * (double)(r->energia_minima + k));
+    }
+    for (k = 0; k < r->num_bins; k++) {
+        double peso = exp(r->log_densidad[k] - beta * (double)(r->energia_minima + k) - maximo);
+        z += peso;
+        energia += peso * (double)(r->energia_minima + k);
+        m_abs += peso * r->media_m_abs[k];
+        m2 += peso * r->media_m2[k];
+        m4 += peso * r->media_m4[k];
+    }
+    energia /= z;
+    // La varianza en una segunda pasada, respecto a la media (sin cancelaciones)
+    for (k = 0; k < r->num_bins; k++) {
+        double peso = exp(r->log_densidad[k] - beta * (double)(r->energia_minima + k) - maximo);
+        double desviacion = (double)(r->energia_minima + k) - energia;
+        varianza += peso * desviacion * desviacion;
+    }
+    varianza /= z;
+    m_abs /= z;
+    m2 /= z;
+    m4 /= z;
+
+    res->muestras = r->muestras;
+    res->energia = energia / n;
+    res->energia2 = (varianza + energia * energia) / (n * n);
+    res->magnetizacion_abs = m_abs;
+    res->magnetizacion2 = m2;
+    res->magnetizacion4 = m4;
+    res->calor_especifico = beta * beta * varianza / n;
+    res->susceptibilidad = beta * n * (m2 - m_abs * m_abs);
+    res->binder = (m2 > 0) ? 1.0 - m4 / (3.0 * m2 * m2) : 0.0;
+}
+
+// U_a - U_b a temperatura t
+static double diferenciaBinder(const Reponderacion *a, const Reponderacion *b, double t) {
+    ResultadosObservables ra, rb;
+    observablesReponderados(a, 1.0 / t, &ra);
+    observablesReponderados(b, 1.0 / t, &rb);
+    return ra.binder - rb.binder;
+}
+
+int cruceBinder(const Reponderacion *a, const Reponderacion *b, double t_min, double t_max, int puntos,
+                double *tc) {
+    int k, iteracion;
+    double t_anterior = t_min, d_anterior = diferenciaBinder(a, b, t_min);
+
+    for (k = 1; k < puntos; k++) {
+        double t = t_min + (t_max - t_min) * k / (puntos - 1);
+        double d = diferenciaBinder(a, b, t);
+        if ((d_anterior <= 0) != (d <= 0)) {
+            // Bisección en [t_anterior, t]
+            double izquierda = t_anterior, derecha = t, d_izquierda = d_anterior;
+            for (iteracion = 0; iteracion < ITERACIONES_BISECCION; iteracion++) {
+                double medio = 0.5 * (izquierda + derecha);
+                double d_medio = diferenciaBinder(a, b, medio);
+                if ((d_izquierda <= 0) == (d_medio <= 0)) {
+                    izquierda = medio;
+                    d_izquierda = d_medio;
+                } else {
+                    derecha = medio;
+                }
+            }
+            *tc = 0.5 * (izquierda + derecha);
+            return 0;
+        }
+        t_anterior = t;
+        d_anterior = d;
+    }
+    return 1;
+}
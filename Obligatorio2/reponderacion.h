@@ -0,0 +1,42 @@
+#ifndef REPONDERACION_H
+#define REPONDERACION_H
+
+#include "observables.h"
+
+// Reponderación de histogramas de energía (Ferrenberg y Swendsen): con las
+// medidas de unas pocas simulaciones a temperaturas cercanas se estima la
+// densidad de estados g(E) y con ella cualquier observable como función
+// continua de T, <A>(beta) = sum_E g(E) e^(-beta E) A(E) / Z.
+//
+// Con un solo histograma es la reponderación simple (g(E) = H(E) e^(beta0 E));
+// con varios, las ecuaciones de Ferrenberg y Swendsen se resuelven por
+// iteración. Cada simulación pesa con sus medidas efectivas n / (1 + 2 tau_e).
+// Solo son fiables las temperaturas cuyas energías típicas caen dentro de los
+// histogramas: en la práctica, entre las temperaturas simuladas y poco más allá.
+typedef struct {
+    int lado, num_espines;
+    int num_histogramas;
+    double t_minima, t_maxima;     // Temperaturas simuladas extremas
+    long muestras;                 // Medidas de todas las simulaciones
+    int iteraciones;               // Iteraciones hasta converger las energías libres
+    long energia_minima;
+    int num_bins;
+    double *log_densidad;          // ln g(E) (-INFINITY donde no hay medidas)
+    double *media_m_abs, *media_m2, *media_m4; // Medias a energía fija con todas las medidas
+} Reponderacion;
+
+// Combina histogramas de la misma red (mismos num_espines y sistema).
+// Devuelve 0 si todo va bien.
+int crearReponderacion(Reponderacion *r, const HistogramaEnergia histogramas[], int num);
+void liberarReponderacion(Reponderacion *r);
+
+// Observables por espín a temperatura 1/beta
+void observablesReponderados(const Reponderacion *r, double beta, ResultadosObservables *res);
+
+// Temperatura entre t_min y t_max a la que se cruzan los cumulantes de Binder
+// de dos tamaños: se busca el primer cambio de signo de U_a - U_b en 'puntos'
+// temperaturas y se afina por bisección. Devuelve 0 si hay cruce.
+int cruceBinder(const Reponderacion *a, const Reponderacion *b, double t_min, double t_max, int puntos,
+                double *tc);
+
+#endif
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "observables.h"
+#include "reponderacion.h"
+
+// Reponderación de los histogramas de energía que escribe lotes_ising
+// (histograma.txt en el directorio de cada trabajo): junta las simulaciones
+// de cada red y tamaño con el método de Ferrenberg y Swendsen, escribe los
+// observables como función continua de T y busca dónde se cruzan los
+// cumulantes de Binder de tamaños consecutivos, que es la estimación de Tc.
+// Unas pocas simulaciones cerca de Tc sustituyen así a una malla densa de
+// temperaturas.
+//
+// Compilación: gcc -O3 reponderar.c reponderacion.c observables.c -o reponderar -lm
+// Uso: ./reponderar [-t tmin:tmax:puntos] barrido/*/histograma.txt
+//   Sin -t se usan las temperaturas simuladas (un poco ampliadas) con 200 puntos.
+// Para cada red y tamaño escribe reponderacion_<red>_L<lado>.txt con las
+// columnas T e C |m| chi U.
+
+#define PUNTOS_POR_DEFECTO 200
+#define MARGEN_TEMPERATURA 0.02 // Fracción de T que se amplía el rango simulado por cada lado
+
+// Orden: red, y dentro de cada red de menor a mayor tamaño
+static int compararHistogramas(const void *a, const void *b) {
+    const HistogramaEnergia *x = a, *y = b;
+    int red = strcmp(x->sistema, y->sistema);
+    if (red != 0) {
+        return red;
+    }
+    return (x->num_espines > y->num_espines) - (x->num_espines < y->num_espines);
+}
+
+// Rango de temperaturas en que la reponderación es fiable
+static void rangoFiable(const Reponderacion *r, double *t_min, double *t_max) {
+    *t_min = r->t_minima * (1.0 - MARGEN_TEMPERATURA);
+    *t_max = r->t_maxima * (1.0 + MARGEN_TEMPERATURA);
+}
+
+static int escribirCurva(const char *ruta, const Reponderacion *r, double t_min, double t_max, int puntos) {
+    int k;
+    FILE *archivo = fopen(ruta, "w");
+    if (archivo == NULL) {
+        return 1;
+    }
+    fprintf(archivo, "# T e C |m| chi U (L = %d, %d simulaciones)\n", r->lado, r->num_histogramas);
+    for (k = 0; k < puntos; k++) {
+        double t = (puntos > 1) ? t_min + (t_max - t_min) * k / (puntos - 1) : t_min;
+        ResultadosObservables res;
+        observablesReponderados(r, 1.0 / t, &res);
+        fprintf(archivo, "%.6f %.8f %.6f %.8f %.6f %.6f\n", t, res.energia, res.calor_especifico,
+                res.magnetizacion_abs, res.susceptibilidad, res.binder);
+    }
+    return fclose(archivo) != 0;
+}
+
+int main(int argc, char *argv[]) {
+    double t_min = 0, t_max = 0;
+    int puntos = PUNTOS_POR_DEFECTO, rango_dado = 0;
+    int k, num = 0, error = 0;
+
+    HistogramaEnergia *histogramas = malloc((argc > 1 ? argc : 1) * sizeof(HistogramaEnergia));
+    if (histogramas == NULL) {
+        return 1;
+    }
+    for (k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "-t") == 0 && k + 1 < argc) {
+            k++;
+            if (sscanf(argv[k], "%lf:%lf:%d", &t_min, &t_max, &puntos) != 3 || t_min <= 0 || t_max <= t_min ||
+                puntos < 2) {
+                fprintf(stderr, "Rango de temperaturas no válido: %s (tmin:tmax:puntos).\n", argv[k]);
+                error = 1;
+                break;
+            }
+            rango_dado = 1;
+        } else if (leerHistograma(argv[k], &histogramas[num]) == 0) {
+            num++;
+        } else {
+            fprintf(stderr, "Aviso: no se puede leer el histograma %s; se ignora.\n", argv[k]);
+        }
+    }
+    if (!error && num == 0) {
+        fprintf(stderr, "Uso: %s [-t tmin:tmax:puntos] histograma.txt...\n", argv[0]);
+        error = 1;
+    }
+    if (error) {
+        for (k = 0; k < num; k++) {
+            liberarHistograma(&histogramas[k]);
+        }
+        free(histogramas);
+        return 1;
+    }
+    qsort(histogramas, num, sizeof(HistogramaEnergia), compararHistogramas);
+
+    // Una reponderación por red y tamaño (grupos consecutivos tras ordenar)
+    Reponderacion *grupos = malloc(num * sizeof(Reponderacion));
+    const char **sistemas = malloc(num * sizeof(char *));
+    int num_grupos = 0, inicio = 0;
+    if (grupos == NULL || sistemas == NULL) {
+        fprintf(stderr, "Sin memoria para las reponderaciones.\n");
+        error = 1;
+    }
+    for (k = 1; k <= num && !error; k++) {
+        if (k < num && compararHistogramas(&histogramas[k], &histogramas[inicio]) == 0) {
+            continue;
+        }
+        Reponderacion *r = &grupos[num_grupos];
+        if (crearReponderacion(r, histogramas + inicio, k - inicio) != 0) {
+            fprintf(stderr, "Sin memoria para la reponderación de %s, L = %d.\n",
+                    histogramas[inicio].sistema, histogramas[inicio].lado);
+            error = 1;
+            break;
+        }
+        sistemas[num_grupos++] = histogramas[inicio].sistema;
+
+        double a = t_min, b = t_max;
+        char ruta[128];
+        if (!rango_dado) {
+            rangoFiable(r, &a, &b);
+        }
+        snprintf(ruta, sizeof(ruta), "reponderacion_%s_L%d.txt", histogramas[inicio].sistema, r->lado);
+        printf("%s, L = %d: %d simulaciones entre T = %.4f y %.4f, %ld medidas, %d iteraciones -> %s\n",
+               histogramas[inicio].sistema, r->lado, r->num_histogramas, r->t_minima, r->t_maxima,
+               r->muestras, r->iteraciones, ruta);
+        if (escribirCurva(ruta, r, a, b, puntos) != 0) {
+            fprintf(stderr, "Error al escribir %s.\n", ruta);
+        }
+        inicio = k;
+    }
+
+    // Cruces de U entre tamaños consecutivos de la misma red, dentro del
+    // rango en que las dos reponderaciones son fiables
+    double tc_mayores = 0.0;
+    int hay_tc = 0;
+    for (k = 1; k < num_grupos && !error; k++) {
+        double a_min, a_max, b_min, b_max, tc;
+        if (strcmp(sistemas[k], sistemas[k - 1]) != 0) {
+            if (hay_tc) {
+                printf("Tc de %s (cruce de los dos tamaños mayores): %.5f\n", sistemas[k - 1], tc_mayores);
+            }
+            hay_tc = 0;
+            continue;
+        }
+        rangoFiable(&grupos[k - 1], &a_min, &a_max);
+        rangoFiable(&grupos[k], &b_min, &b_max);
+        a_min = fmax(a_min, b_min);
+        a_max = fmin(a_max, b_max);
+        if (rango_dado) {
+            a_min = fmax(a_min, t_min);
+            a_max = fmin(a_max, t_max);
+        }
+        if (a_max > a_min && cruceBinder(&grupos[k - 1], &grupos[k], a_min, a_max, puntos, &tc) == 0) {
+            printf("%s: U(L = %d) = U(L = %d) en T = %.5f\n", sistemas[k], grupos[k - 1].lado, grupos[k].lado, tc);
+            tc_mayores = tc;
+            hay_tc = 1;
+        } else {
+            printf("%s: U(L = %d) y U(L = %d) no se cruzan entre T = %.4f y %.4f\n", sistemas[k],
+                   grupos[k - 1].lado, grupos[k].lado, a_min, a_max);
+        }
+    }
+    if (!error && hay_tc) {
+        printf("Tc de %s (cruce de los dos tamaños mayores): %.5f\n", sistemas[num_grupos - 1], tc_mayores);
+    }
+
+    for (k = 0; k < num_grupos; k++) {
+        liberarReponderacion(&grupos[k]);
+    }
+    for (k = 0; k < num; k++) {
+        liberarHistograma(&histogramas[k]);
+    }
+    free(grupos);
+    free(sistemas);
+    free(histogramas);
+    return error;
+}
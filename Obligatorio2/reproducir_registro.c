@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "registro_inversiones.h"
+#include "trayectoria.h"
+
+// Reproduce un registro de inversiones y lo convierte en una trayectoria
+// binaria (trayectoria.h) que animacion.py puede leer, tomando un
+// fotograma cada 'cada' intentos.
+//
+// Compilación: gcc -O3 reproducir_registro.c registro_inversiones.c trayectoria.c -o reproducir_registro
+// Uso: ./reproducir_registro registro_red.bin matriz_red.bin [cada]
+int main(int argc, char *argv[]) {
+    LectorRegistro registro;
+    EscritorTrayectoria trayectoria;
+    uint64_t cada = 1, paso;
+    int n, *red, error = 0;
+
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s registro_red.bin matriz_red.bin [cada]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 3) {
+        cada = strtoull(argv[3], NULL, 10);
+        if (cada == 0) {
+            cada = 1;
+        }
+    }
+
+    if (abrirRegistroLectura(&registro, argv[1]) != 0) {
+        fprintf(stderr, "Error al abrir el registro %s.\n", argv[1]);
+        return 1;
+    }
+    n = (int)registro.cabecera.n;
+    red = malloc((size_t)n * n * sizeof(int));
+    if (red == NULL || abrirTrayectoriaEscritura(&trayectoria, argv[2], n, registro.cabecera.temperatura,
+                                                 registro.cabecera.semilla) != 0) {
+        fprintf(stderr, "Error al crear la trayectoria %s.\n", argv[2]);
+        return 1;
+    }
+
+    // Cada fotograma se reconstruye desde su red clave, así que se puede
+    // pedir cualquier paso en cualquier orden
+    for (paso = cada; paso <= registro.cabecera.pasos && !error; paso += cada) {
+        if (reconstruirPaso(&registro, paso, red) != 0) {
+            fprintf(stderr, "Error al reconstruir el intento %llu del registro %s.\n",
+                    (unsigned long long)paso, argv[1]);
+            error = 1;
+        } else if (escribirFotograma(&trayectoria, red) != 0) {
+            fprintf(stderr, "Error al escribir en la trayectoria %s.\n", argv[2]);
+            error = 1;
+        }
+    }
+
+    if (!error) {
+        printf("%llu intentos, %llu bloques, %llu fotogramas escritos.\n",
+               (unsigned long long)registro.cabecera.pasos, (unsigned long long)registro.cabecera.bloques,
+               (unsigned long long)trayectoria.cabecera.fotogramas);
+    }
+
+    // La cabecera de la trayectoria se cierra con los fotogramas escritos hasta el error
+    if (cerrarTrayectoriaEscritura(&trayectoria) != 0) {
+        fprintf(stderr, "Error al cerrar la trayectoria %s.\n", argv[2]);
+        error = 1;
+    }
+    cerrarRegistroLectura(&registro);
+    free(red);
+    return error;
+}
@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "simulacion_ising.h"
+
+// Función para inicializar la red con espines aleatorios (+1 o -1)
+void inicializarRed(RedIsing *red, int sesgo, GeneradorHilo *g) {
+    int i, j;
+    for (i = 0; i < red->n; i++) {
+        int8_t *fila = filaRed(red, i);
+        for (j = 0; j < red->n; j++) {
+            // Generar un número aleatorio entre 0 y 99 (ambos incluidos)
+            int probabilidad = aleatorioEntero(g, 100);
+            // Asignar +1 si está dentro del porcentaje de sesgo, -1 en caso contrario
+            if (probabilidad < sesgo) {
+                fila[j] = 1;
+            } else {
+                fila[j] = -1;
+            }
+        }
+    }
+    actualizarBordes(red);
+}
+
+// Función para inicializar la red de forma ordenada (+1 o -1)
+void inicializarRedOrdenada(RedIsing *red, int valor) {
+    int i, j;
+    for (i = 0; i < red->n; i++) {
+        int8_t *fila = filaRed(red, i);
+        for (j = 0; j < red->n; j++) {
+            fila[j] = (int8_t)valor; // Asigna el valor +1 o -1 a toda la red
+        }
+    }
+    actualizarBordes(red);
+}
+
+// Función para calcular la energía total del sistema. Cada enlace se cuenta
+// una vez (vecino de abajo y vecino de la derecha). Los de la última fila y
+// la última columna se leen del borde fantasma, así que el bucle interior no
+// tiene condiciones de contorno y el compilador lo vectoriza.
+double calcularEnergia(const RedIsing *red) {
+    long energia = 0;
+    int i, j;
+
+    for (i = 0; i < red->n; i++) {
+        const int8_t *fila = filaRed(red, i);
+        const int8_t *abajo = filaRed(red, i + 1);
+        int suma = 0; // Una fila no pasa de 2 * n enlaces: cabe en un int
+
+        for (j = 0; j < red->n; j++) {
+            suma += fila[j] * (abajo[j] + fila[j + 1]);
+        }
+        energia += suma;
+    }
+    return -(double)energia;
+}
+
+
+// Probabilidad de aceptación para cada valor posible de s * suma_vecinos
+// (-4, -2, 0, 2, 4), con índice (s * suma_vecinos + 4) / 2. Así exp() se
+// llama 5 veces por barrido en lugar de una vez por cada intento.
+void calcularTablaAceptacion(double beta, double tabla[5]) {
+    int k;
+    for (k = 0; k < 5; k++) {
+        double deltaE = 2 * (2 * k - 4);
+        tabla[k] = (deltaE <= 0) ? 1.0 : exp(-beta * deltaE);
+    }
+}
+
+// Magnetización total de la red
+long calcularMagnetizacion(const RedIsing *red) {
+    long magnetizacion = 0;
+    int i, j;
+    for (i = 0; i < red->n; i++) {
+        const int8_t *fila = filaRed(red, i);
+        int suma = 0;
+        for (j = 0; j < red->n; j++) {
+            suma += fila[j];
+        }
+        magnetizacion += suma;
+    }
+    return magnetizacion;
+}
+
+// Un paso Monte Carlo: n*n intentos de inversión en posiciones aleatorias.
+// energia y magnetizacion se actualizan con cada inversión aceptada.
+void barridoAleatorio(RedIsing *red, double beta, GeneradorHilo *g, double *energia, long *magnetizacion) {
+    int n, m, suma_vecinos, acepta, espin;
+    long total = (long)red->n * red->n;
+    double tabla[5], r;
+    long delta_energia = 0, delta_magnetizacion = 0;
+
+    calcularTablaAceptacion(beta, tabla);
+
+    for (long j = 0; j < total; j++) {
+        // Elegir un espín aleatorio en la red
+        n = aleatorioEntero(g, red->n);
+        m = aleatorioEntero(g, red->n);
+        int8_t *fila = filaRed(red, n);
+
+        // Vecinos con condiciones de contorno periódicas (del borde fantasma si hace falta)
+        suma_vecinos = filaRed(red, n - 1)[m] + filaRed(red, n + 1)[m] + fila[m - 1] + fila[m + 1];
+
+        // Generar un número aleatorio con probabilidad uniforme entre 0 y 1 para decidir si aceptar el cambio
+        r = aleatorioUniforme(g);
+
+        // Si se acepta el cambio, invertir el signo del espín (multiplicar por -1 o por 1)
+        espin = fila[m];
+        acepta = r < tabla[(espin * suma_vecinos + 4) / 2];
+        delta_energia += acepta * 2 * espin * suma_vecinos;
+        delta_magnetizacion -= acepta * 2 * espin;
+        fijarEspin(red, n, m, espin * (1 - 2 * acepta));
+    }
+
+    *energia += delta_energia;
+    *magnetizacion += delta_magnetizacion;
+}
+
+// Un paso Monte Carlo en tablero de ajedrez: primero todas las casillas negras
+// ((i + j) par) y después todas las blancas. Los cuatro vecinos de una casilla
+// son del otro color, así que todas las casillas de un mismo color se pueden
+// actualizar a la vez y cada medio barrido se reparte entre los hilos.
+// Requiere n par para que el tablero sea coherente con el contorno periódico.
+// Durante un medio barrido solo se leen del borde fantasma espines del otro
+// color, que no cambian; el borde se rehace al terminar cada medio barrido.
+void barridoTablero(RedIsing *red, double beta, GeneradorHilo generadores[],
+                    double *energia, long *magnetizacion) {
+    int color;
+    double tabla[5];
+    long delta_energia = 0, delta_magnetizacion = 0;
+
+    calcularTablaAceptacion(beta, tabla);
+
+    for (color = 0; color < 2; color++) {
+        // schedule(static) fija qué filas hace cada hilo, de modo que con el
+        // mismo número de hilos y la misma semilla el resultado es reproducible
+        #pragma omp parallel reduction(+:delta_energia, delta_magnetizacion)
+        {
+            GeneradorHilo *g = &generadores[omp_get_thread_num()];
+            int n, m;
+
+            #pragma omp for schedule(static)
+            for (n = 0; n < red->n; n++) {
+                int8_t *fila = filaRed(red, n);
+                const int8_t *arriba = filaRed(red, n - 1);
+                const int8_t *abajo = filaRed(red, n + 1);
+
+                for (m = (n + color) % 2; m < red->n; m += 2) {
+                    int suma_vecinos = arriba[m] + abajo[m] + fila[m - 1] + fila[m + 1];
+                    int acepta = aleatorioUniforme(g) < tabla[(fila[m] * suma_vecinos + 4) / 2];
+                    delta_energia += acepta * 2 * fila[m] * suma_vecinos;
+                    delta_magnetizacion -= acepta * 2 * fila[m];
+                    fila[m] = (int8_t)(fila[m] * (1 - 2 * acepta));
+                }
+            }
+        }
+        actualizarBordes(red);
+    }
+
+    *energia += delta_energia;
+    *magnetizacion += delta_magnetizacion;
+}
+
+// Reserva una secuencia aleatoria independiente por hilo
+GeneradorHilo *crearGeneradores(uint64_t semilla) {
+    int i, num_hilos = omp_get_max_threads();
+    GeneradorHilo *generadores = malloc(num_hilos * sizeof(GeneradorHilo));
+    if (generadores == NULL) {
+        fprintf(stderr, "Error al reservar memoria para los generadores.\n");
+        exit(1);
+    }
+    for (i = 0; i < num_hilos; i++) {
+        inicializarGeneradorHilo(&generadores[i], semilla, i);
+    }
+    return generadores;
+}
+
+
+int algoritmoNecesitaNPar(int algoritmo) {
+    return algoritmo == ALGORITMO_TABLERO || algoritmo == ALGORITMO_MULTIESPIN || algoritmo == ALGORITMO_SIMD ||
+           algoritmo == ALGORITMO_VECINOS;
+}
+
+int crearMotorIsing(MotorIsing *m, int algoritmo, const RedIsing *red, double beta) {
+    m->algoritmo = algoritmo;
+    m->beta = beta;
+    if (algoritmoNecesitaNPar(algoritmo) && red->n % 2 != 0) {
+        return 1;
+    }
+
+    // El motor multiespín trabaja sobre su propia copia empaquetada de la red
+    if (algoritmo == ALGORITMO_MULTIESPIN) {
+        if (crearRedMultiespin(&m->red_bits, red->n) != 0) {
+            return 1;
+        }
+        empaquetarRed(&m->red_bits, red);
+    }
+
+    // El motor SIMD también trabaja sobre su copia (un byte por espín, por colores)
+    if (algoritmo == ALGORITMO_SIMD) {
+        if (crearRedSimd(&m->red_simd, red->n) != 0) {
+            return 1;
+        }
+        empaquetarRedSimd(&m->red_simd, red);
+    }
+
+    // La tabla de vecinos trabaja sobre la red cuadrada periódica k = i * n + j
+    if (algoritmo == ALGORITMO_VECINOS) {
+        int i, j;
+        if (crearGeometria(&m->geometria, GEOMETRIA_CUADRADA, CONTORNO_PERIODICO, red->n) != 0) {
+            return 1;
+        }
+        m->espines_geometria = crearEspinesGeometria(&m->geometria);
+        if (m->espines_geometria == NULL) {
+            liberarGeometria(&m->geometria);
+            return 1;
+        }
+        for (i = 0; i < red->n; i++) {
+            for (j = 0; j < red->n; j++) {
+                m->espines_geometria[i * red->n + j] = filaRed(red, i)[j];
+            }
+        }
+    }
+
+    if (algoritmo == ALGORITMO_WOLFF || algoritmo == ALGORITMO_SWENDSEN_WANG) {
+        return crearMotorCluster(&m->cluster, red->n, beta);
+    }
+    if (algoritmo == ALGORITMO_NFOLD) {
+        return crearMotorNfold(&m->nfold, red, beta);
+    }
+    return 0;
+}
+
+void liberarMotorIsing(MotorIsing *m) {
+    if (m->algoritmo == ALGORITMO_MULTIESPIN) {
+        liberarRedMultiespin(&m->red_bits);
+    }
+    if (m->algoritmo == ALGORITMO_SIMD) {
+        liberarRedSimd(&m->red_simd);
+    }
+    if (m->algoritmo == ALGORITMO_WOLFF || m->algoritmo == ALGORITMO_SWENDSEN_WANG) {
+        liberarMotorCluster(&m->cluster);
+    }
+    if (m->algoritmo == ALGORITMO_VECINOS) {
+        free(m->espines_geometria);
+        liberarGeometria(&m->geometria);
+    }
+    if (m->algoritmo == ALGORITMO_NFOLD) {
+        liberarMotorNfold(&m->nfold);
+    }
+}
+
+void pasoMonteCarlo(MotorIsing *m, RedIsing *red, GeneradorHilo generadores[],
+                    double *energia, long *magnetizacion) {
+    if (m->algoritmo == ALGORITMO_MULTIESPIN) {
+        barridoMultiespin(&m->red_bits, m->beta, generadores);
+        // Con 64 espines por palabra recalcular por popcount es más barato
+        // que seguir cada inversión
+        *energia = energiaMultiespin(&m->red_bits);
+        *magnetizacion = magnetizacionMultiespin(&m->red_bits);
+    } else if (m->algoritmo == ALGORITMO_WOLFF || m->algoritmo == ALGORITMO_SWENDSEN_WANG) {
+        // E y M cambian con cada cluster, sin recorrer la red
+        if (m->algoritmo == ALGORITMO_WOLFF) {
+            barridoWolff(&m->cluster, red, &generadores[0], energia, magnetizacion);
+        } else {
+            barridoSwendsenWang(&m->cluster, red, generadores, energia, magnetizacion);
+        }
+    } else if (m->algoritmo == ALGORITMO_SIMD) {
+        barridoSimd(&m->red_simd, m->beta, generadores, energia, magnetizacion);
+    } else if (m->algoritmo == ALGORITMO_VECINOS) {
+        barridoGeometria(&m->geometria, m->espines_geometria, m->beta, generadores, energia, magnetizacion);
+    } else if (m->algoritmo == ALGORITMO_NFOLD) {
+        barridoNfold(&m->nfold, red, &generadores[0], energia, magnetizacion);
+    } else if (m->algoritmo == ALGORITMO_TABLERO) {
+        barridoTablero(red, m->beta, generadores, energia, magnetizacion);
+    } else {
+        barridoAleatorio(red, m->beta, &generadores[0], energia, magnetizacion);
+    }
+}
+
+void medirMotor(const MotorIsing *m, const RedIsing *red, double *energia, long *magnetizacion) {
+    if (m->algoritmo == ALGORITMO_SIMD) {
+        *energia = energiaSimd(&m->red_simd);
+        *magnetizacion = magnetizacionSimd(&m->red_simd);
+    } else if (m->algoritmo == ALGORITMO_MULTIESPIN) {
+        *energia = energiaMultiespin(&m->red_bits);
+        *magnetizacion = magnetizacionMultiespin(&m->red_bits);
+    } else {
+        // La tabla de vecinos empieza con una copia exacta de la red
+        *energia = calcularEnergia(red);
+        *magnetizacion = calcularMagnetizacion(red);
+    }
+}
+
+void sincronizarRed(const MotorIsing *m, RedIsing *red) {
+    if (m->algoritmo == ALGORITMO_MULTIESPIN) {
+        desempaquetarRed(&m->red_bits, red);
+    } else if (m->algoritmo == ALGORITMO_SIMD) {
+        desempaquetarRedSimd(&m->red_simd, red);
+    } else if (m->algoritmo == ALGORITMO_VECINOS) {
+        int i;
+        for (i = 0; i < red->n; i++) {
+            memcpy(filaRed(red, i), m->espines_geometria + (size_t)i * red->n, red->n);
+        }
+        actualizarBordes(red);
+    }
+}
+
+// Nombres cortos de los algoritmos, indexados por su número
+static const char *const NOMBRES_ALGORITMOS[] = {
+    [ALGORITMO_ALEATORIO] = "aleatorio",
+    [ALGORITMO_TABLERO] = "tablero",
+    [ALGORITMO_MULTIESPIN] = "multiespin",
+    [ALGORITMO_WOLFF] = "wolff",
+    [ALGORITMO_SWENDSEN_WANG] = "swendsen-wang",
+    [ALGORITMO_SIMD] = "simd",
+    [ALGORITMO_VECINOS] = "vecinos",
+    [ALGORITMO_NFOLD] = "nfold",
+};
+
+#define NUM_NOMBRES_ALGORITMOS (int)(sizeof(NOMBRES_ALGORITMOS) / sizeof(NOMBRES_ALGORITMOS[0]))
+
+const char *nombreAlgoritmo(int algoritmo) {
+    if (algoritmo < 0 || algoritmo >= NUM_NOMBRES_ALGORITMOS || NOMBRES_ALGORITMOS[algoritmo] == NULL) {
+        return "desconocido";
+    }
+    return NOMBRES_ALGORITMOS[algoritmo];
+}
+
+int algoritmoPorNombre(const char *nombre) {
+    int k;
+    for (k = 0; k < NUM_NOMBRES_ALGORITMOS; k++) {
+        if (NOMBRES_ALGORITMOS[k] != NULL && strcmp(NOMBRES_ALGORITMOS[k], nombre) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
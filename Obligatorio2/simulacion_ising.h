@@ -0,0 +1,91 @@
+#ifndef SIMULACION_ISING_H
+#define SIMULACION_ISING_H
+
+#include <stdint.h>
+#include "aleatorio.h"
+#include "red_ising.h"
+#include "ising_multiespin.h"
+#include "ising_simd.h"
+#include "ising_cluster.h"
+#include "geometria.h"
+#include "ising_nfold.h"
+
+// Núcleo de la simulación de Ising que comparten ising.c (interactivo) y
+// lotes_ising.c (barridos de parámetros sin preguntas): inicialización,
+// energía, magnetización y los algoritmos de actualización.
+
+// Algoritmos de actualización (los números son las opciones del menú de ising.c)
+#define ALGORITMO_ALEATORIO 1     // n*n espines elegidos al azar (secuencial)
+#define ALGORITMO_TABLERO 2       // Tablero de ajedrez (negras y luego blancas) con OpenMP
+#define ALGORITMO_MULTIESPIN 3    // Tablero de ajedrez con 64 espines por palabra (ising_multiespin.c)
+#define ALGORITMO_WOLFF 5         // Clusters de Wolff (ising_cluster.c)
+#define ALGORITMO_SWENDSEN_WANG 6 // Clusters de Swendsen-Wang en paralelo (ising_cluster.c)
+#define ALGORITMO_SIMD 8          // Tablero de ajedrez con un espín por byte y AVX2/AVX-512 (ising_simd.c)
+#define ALGORITMO_VECINOS 9       // Metropolis con tabla de vecinos (geometria.c), aquí sobre la red cuadrada
+#define ALGORITMO_NFOLD 10        // n-fold way sin rechazos en tiempo continuo (ising_nfold.c), para T baja
+
+// Red aleatoria con un 'sesgo' por ciento de espines +1
+void inicializarRed(RedIsing *red, int sesgo, GeneradorHilo *g);
+// Red ordenada con todos los espines a 'valor' (+1 o -1)
+void inicializarRedOrdenada(RedIsing *red, int valor);
+
+double calcularEnergia(const RedIsing *red);
+long calcularMagnetizacion(const RedIsing *red);
+void calcularTablaAceptacion(double beta, double tabla[5]);
+
+// Un paso Monte Carlo de Metropolis; energia y magnetizacion se actualizan
+// con cada inversión aceptada
+void barridoAleatorio(RedIsing *red, double beta, GeneradorHilo *g, double *energia, long *magnetizacion);
+void barridoTablero(RedIsing *red, double beta, GeneradorHilo generadores[],
+                    double *energia, long *magnetizacion);
+
+// Un generador por hilo (omp_get_max_threads()), todos de la misma semilla
+GeneradorHilo *crearGeneradores(uint64_t semilla);
+
+// Motor de actualización: el algoritmo elegido con las estructuras propias
+// que necesita (las copias de la red del multiespín, del SIMD y de la tabla
+// de vecinos, los buffers de los clusters, las clases del n-fold way)
+typedef struct {
+    int algoritmo;
+    double beta;
+    RedMultiespin red_bits;
+    RedSimd red_simd;
+    MotorCluster cluster;
+    Geometria geometria;
+    int8_t *espines_geometria;
+    MotorNfold nfold;
+} MotorIsing;
+
+// Prepara el motor a partir del estado actual de la red. Devuelve 0 si todo
+// va bien (falla si falta memoria o si el algoritmo necesita n par y no lo es).
+int crearMotorIsing(MotorIsing *m, int algoritmo, const RedIsing *red, double beta);
+void liberarMotorIsing(MotorIsing *m);
+
+// Un paso Monte Carlo con el algoritmo del motor. Al terminar, energia y
+// magnetizacion están al día sea cual sea el algoritmo; la red solo con los
+// que trabajan sobre ella. El multiespín, el SIMD y la tabla de vecinos
+// trabajan sobre su copia, que es la que vale: desempaquetarla en cada paso
+// costaría otra pasada por toda la red.
+void pasoMonteCarlo(MotorIsing *m, RedIsing *red, GeneradorHilo generadores[],
+                    double *energia, long *magnetizacion);
+
+// Energía y magnetización del estado del motor, leídas de su copia si la
+// tiene (en el SIMD con la misma ruta vectorial que el barrido, en el
+// multiespín por popcount) y si no de la red. Para el valor inicial o para
+// comprobar los que se han ido siguiendo con cada inversión.
+void medirMotor(const MotorIsing *m, const RedIsing *red, double *energia, long *magnetizacion);
+
+// Pone la red al día con la copia del motor. Hay que llamarla antes de leer
+// la red (un fotograma, un punto de control, al terminar); con los motores
+// que trabajan sobre la red no hace nada.
+void sincronizarRed(const MotorIsing *m, RedIsing *red);
+
+// 1 si el algoritmo usa el tablero de ajedrez (necesita n par)
+int algoritmoNecesitaNPar(int algoritmo);
+
+// Nombre corto de un algoritmo ("tablero", "wolff"...) y lo contrario
+// (devuelve -1 si el nombre no es de ningún algoritmo)
+const char *nombreAlgoritmo(int algoritmo);
+int algoritmoPorNombre(const char *nombre);
+
+#endif
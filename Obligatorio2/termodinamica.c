@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ising_wang_landau.h"
+
+// Magnitudes térmicas a partir de la densidad de estados g(E) que escribe
+// ./ising con la opción de Wang-Landau (densidad_estados.txt): energía libre,
+// energía, calor específico y entropía por espín a cualquier temperatura, sin
+// volver a simular. Una sola ejecución por tamaño de red sustituye así a un
+// barrido completo en temperatura.
+//
+// Compilación: gcc -O3 -fopenmp termodinamica.c ising_wang_landau.c red_ising.c -o termodinamica -lm
+// Uso: ./termodinamica densidad_estados.txt [tmin:tmax:puntos]
+//   Escribe por pantalla las columnas T f e C s (por espín, k_B = 1).
+
+#define T_MINIMA_DEFECTO 0.5
+#define T_MAXIMA_DEFECTO 5.0
+#define PUNTOS_DEFECTO 91
+
+int main(int argc, char *argv[]) {
+    double t_min = T_MINIMA_DEFECTO, t_max = T_MAXIMA_DEFECTO;
+    int puntos = PUNTOS_DEFECTO, k;
+    DensidadEstados densidad;
+
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Uso: %s densidad_estados.txt [tmin:tmax:puntos]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 3 && (sscanf(argv[2], "%lf:%lf:%d", &t_min, &t_max, &puntos) != 3 || t_min <= 0 ||
+                      t_max < t_min || puntos < 1)) {
+        fprintf(stderr, "Rango de temperaturas no válido: %s (tmin:tmax:puntos).\n", argv[2]);
+        return 1;
+    }
+    if (leerDensidadEstados(argv[1], &densidad) != 0) {
+        fprintf(stderr, "No se puede leer la densidad de estados %s.\n", argv[1]);
+        return 1;
+    }
+
+    printf("# T f e C s  (L = %d, por espín)\n", densidad.lado);
+    for (k = 0; k < puntos; k++) {
+        double t = (puntos > 1) ? t_min + (t_max - t_min) * k / (puntos - 1) : t_min;
+        Termodinamica res;
+        calcularTermodinamica(&densidad, t, &res);
+        printf("%.6f %.8f %.8f %.6f %.8f\n", t, res.energia_libre, res.energia, res.calor_especifico,
+               res.entropia);
+    }
+
+    liberarDensidadEstados(&densidad);
+    return 0;
+}
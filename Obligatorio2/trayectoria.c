@@ -0,0 +1,184 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trayectoria.h"
+
+// La cabecera debe ocupar exactamente los 64 bytes del formato
+typedef char comprobar_cabecera[(sizeof(CabeceraTrayectoria) == TRAYECTORIA_BYTES_CABECERA) ? 1 : -1];
+
+uint64_t bytesFotograma(int n) {
+    uint64_t bits = (uint64_t)n * n;
+    return ((bits + 63) / 64) * 8;
+}
+
+int abrirTrayectoriaEscritura(EscritorTrayectoria *e, const char *ruta, int n, double temperatura, uint64_t semilla) {
+    memset(&e->cabecera, 0, sizeof(e->cabecera));
+    memcpy(e->cabecera.magia, TRAYECTORIA_MAGIA, 8);
+    e->cabecera.version = TRAYECTORIA_VERSION;
+    e->cabecera.n = (uint32_t)n;
+    e->cabecera.bytes_fotograma = bytesFotograma(n);
+    e->cabecera.temperatura = temperatura;
+    e->cabecera.semilla = semilla;
+
+    e->buffer = calloc(e->cabecera.bytes_fotograma, 1);
+    e->archivo = fopen(ruta, "wb");
+    if (e->buffer == NULL || e->archivo == NULL) {
+        free(e->buffer);
+        if (e->archivo != NULL) {
+            fclose(e->archivo);
+        }
+        return 1;
+    }
+    // Buffer grande: muchos fotogramas pequeños por cada escritura al disco
+    setvbuf(e->archivo, NULL, _IOFBF, 1 << 20);
+    return fwrite(&e->cabecera, sizeof(e->cabecera), 1, e->archivo) != 1;
+}
+
+int continuarTrayectoriaEscritura(EscritorTrayectoria *e, const char *ruta, uint64_t fotogramas) {
+    e->buffer = NULL;
+    e->archivo = fopen(ruta, "r+b");
+    if (e->archivo == NULL) {
+        return 1;
+    }
+    setvbuf(e->archivo, NULL, _IOFBF, 1 << 20);
+    if (fread(&e->cabecera, sizeof(e->cabecera), 1, e->archivo) != 1 ||
+        memcmp(e->cabecera.magia, TRAYECTORIA_MAGIA, 8) != 0 ||
+        e->cabecera.version != TRAYECTORIA_VERSION ||
+        e->cabecera.bytes_fotograma != bytesFotograma((int)e->cabecera.n)) {
+        fclose(e->archivo);
+        return 1;
+    }
+
+    // Los fotogramas escritos después del punto de control se descartan
+    off_t bytes = TRAYECTORIA_BYTES_CABECERA + (off_t)(fotogramas * e->cabecera.bytes_fotograma);
+    e->cabecera.fotogramas = fotogramas;
+    e->buffer = calloc(e->cabecera.bytes_fotograma, 1);
+    if (e->buffer == NULL || ftruncate(fileno(e->archivo), bytes) != 0 ||
+        fseeko(e->archivo, bytes, SEEK_SET) != 0) {
+        free(e->buffer);
+        fclose(e->archivo);
+        return 1;
+    }
+    return 0;
+}
+
+void empaquetarFotograma(const int *red, int n, uint8_t *destino) {
+    size_t k, total = (size_t)n * n;
+    memset(destino, 0, bytesFotograma(n));
+    for (k = 0; k < total; k++) {
+        destino[k / 8] |= (uint8_t)((red[k] > 0) << (k % 8));
+    }
+}
+
+int escribirFotograma(EscritorTrayectoria *e, const int *red) {
+    empaquetarFotograma(red, (int)e->cabecera.n, e->buffer);
+    if (fwrite(e->buffer, e->cabecera.bytes_fotograma, 1, e->archivo) != 1) {
+        return 1;
+    }
+    e->cabecera.fotogramas++;
+    return 0;
+}
+
+void empaquetarFotogramaFilas(const int8_t *espines, ptrdiff_t paso, int n, uint8_t *destino) {
+    size_t k = 0;
+    int i, j;
+    memset(destino, 0, bytesFotograma(n));
+    for (i = 0; i < n; i++) {
+        const int8_t *fila = espines + i * paso;
+        for (j = 0; j < n; j++, k++) {
+            destino[k / 8] |= (uint8_t)((fila[j] > 0) << (k % 8));
+        }
+    }
+}
+
+int escribirFotogramaFilas(EscritorTrayectoria *e, const int8_t *espines, ptrdiff_t paso) {
+    empaquetarFotogramaFilas(espines, paso, (int)e->cabecera.n, e->buffer);
+    if (fwrite(e->buffer, e->cabecera.bytes_fotograma, 1, e->archivo) != 1) {
+        return 1;
+    }
+    e->cabecera.fotogramas++;
+    return 0;
+}
+
+int cerrarTrayectoriaEscritura(EscritorTrayectoria *e) {
+    int error = 0;
+    // Reescribir la cabecera con el número final de fotogramas
+    if (fseek(e->archivo, 0, SEEK_SET) != 0 ||
+        fwrite(&e->cabecera, sizeof(e->cabecera), 1, e->archivo) != 1) {
+        error = 1;
+    }
+    if (fclose(e->archivo) != 0) {
+        error = 1;
+    }
+    free(e->buffer);
+    e->archivo = NULL;
+    e->buffer = NULL;
+    return error;
+}
+
+int abrirTrayectoriaLectura(LectorTrayectoria *l, const char *ruta) {
+    struct stat info;
+    int fd = open(ruta, O_RDONLY);
+    void *datos;
+
+    l->datos = NULL;
+    if (fd < 0) {
+        return 1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < TRAYECTORIA_BYTES_CABECERA) {
+        close(fd);
+        return 1;
+    }
+    datos = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // La proyección sigue siendo válida sin el descriptor
+    if (datos == MAP_FAILED) {
+        return 1;
+    }
+
+    l->datos = datos;
+    l->bytes = (size_t)info.st_size;
+    memcpy(&l->cabecera, l->datos, sizeof(l->cabecera));
+    if (memcmp(l->cabecera.magia, TRAYECTORIA_MAGIA, 8) != 0 ||
+        l->cabecera.version != TRAYECTORIA_VERSION ||
+        l->cabecera.bytes_fotograma != bytesFotograma((int)l->cabecera.n)) {
+        cerrarTrayectoriaLectura(l);
+        return 1;
+    }
+
+    // Un fichero que no se cerró (por ejemplo, si el programa se interrumpió)
+    // tiene 0 fotogramas en la cabecera: se cuentan los que caben completos
+    uint64_t completos = (l->bytes - TRAYECTORIA_BYTES_CABECERA) / l->cabecera.bytes_fotograma;
+    if (l->cabecera.fotogramas == 0 || l->cabecera.fotogramas > completos) {
+        l->cabecera.fotogramas = completos;
+    }
+    return 0;
+}
+
+const uint8_t *fotogramaTrayectoria(const LectorTrayectoria *l, uint64_t f) {
+    if (f >= l->cabecera.fotogramas) {
+        return NULL;
+    }
+    return l->datos + TRAYECTORIA_BYTES_CABECERA + f * l->cabecera.bytes_fotograma;
+}
+
+void leerFotograma(const LectorTrayectoria *l, uint64_t f, int *red) {
+    const uint8_t *bits = fotogramaTrayectoria(l, f);
+    size_t k, total = (size_t)l->cabecera.n * l->cabecera.n;
+    if (bits == NULL) {
+        return;
+    }
+    for (k = 0; k < total; k++) {
+        red[k] = ((bits[k / 8] >> (k % 8)) & 1) ? 1 : -1;
+    }
+}
+
+void cerrarTrayectoriaLectura(LectorTrayectoria *l) {
+    if (l->datos != NULL) {
+        munmap((void *)l->datos, l->bytes);
+    }
+    l->datos = NULL;
+}
@@ -0,0 +1,79 @@
+#ifndef TRAYECTORIA_H
+#define TRAYECTORIA_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Formato binario de trayectorias de la red de Ising (little-endian):
+//   - Cabecera fija de 64 bytes (CabeceraTrayectoria).
+//   - Fotogramas de bytes_fotograma bytes cada uno, con un bit por espín
+//     (bit a 1 -> +1, bit a 0 -> -1). El espín (i, j) es el bit k % 8 del
+//     byte k / 8, con k = i * n + j. Cada fotograma se rellena hasta un
+//     múltiplo de 8 bytes, así que el fotograma f empieza en el byte
+//     64 + f * bytes_fotograma y el fichero se puede proyectar con mmap.
+#define TRAYECTORIA_MAGIA "ISINGBIN"
+#define TRAYECTORIA_VERSION 1
+#define TRAYECTORIA_BYTES_CABECERA 64
+
+typedef struct {
+    char magia[8];            // "ISINGBIN"
+    uint32_t version;
+    uint32_t n;               // Tamaño de la red (n x n)
+    uint64_t fotogramas;      // Número de fotogramas (se completa al cerrar)
+    uint64_t bytes_fotograma; // Bytes por fotograma
+    double temperatura;
+    uint64_t semilla;
+    uint8_t reservado[16];
+} CabeceraTrayectoria;
+
+typedef struct {
+    FILE *archivo;
+    CabeceraTrayectoria cabecera;
+    uint8_t *buffer;          // Fotograma empaquetado antes de escribirlo
+} EscritorTrayectoria;
+
+typedef struct {
+    CabeceraTrayectoria cabecera;
+    const uint8_t *datos;     // Fichero completo proyectado en memoria
+    size_t bytes;
+} LectorTrayectoria;
+
+// Bytes que ocupa un fotograma de una red n x n
+uint64_t bytesFotograma(int n);
+
+// Escritura: se abre, se añaden fotogramas y al cerrar se escribe el número de fotogramas.
+// Todas devuelven 0 si todo va bien.
+int abrirTrayectoriaEscritura(EscritorTrayectoria *e, const char *ruta, int n, double temperatura, uint64_t semilla);
+int escribirFotograma(EscritorTrayectoria *e, const int *red);
+int cerrarTrayectoriaEscritura(EscritorTrayectoria *e);
+
+// Reabre una trayectoria para seguir escribiendo tras el fotograma
+// 'fotogramas' (los posteriores se descartan), por ejemplo al continuar
+// desde un punto de control
+int continuarTrayectoriaEscritura(EscritorTrayectoria *e, const char *ruta, uint64_t fotogramas);
+
+// Empaqueta una red n x n (+1/-1, fila a fila) en bytes_fotograma bytes
+void empaquetarFotograma(const int *red, int n, uint8_t *destino);
+
+// Lo mismo para una red de un byte por espín cuyas filas empiezan cada
+// 'paso' bytes (por ejemplo RedIsing, de red_ising.h)
+void empaquetarFotogramaFilas(const int8_t *espines, ptrdiff_t paso, int n, uint8_t *destino);
+int escribirFotogramaFilas(EscritorTrayectoria *e, const int8_t *espines, ptrdiff_t paso);
+
+// Lectura con mmap: los fotogramas se leen por desplazamiento sin cargar el fichero.
+// Si el fichero no se cerró bien, el número de fotogramas se deduce de su tamaño.
+int abrirTrayectoriaLectura(LectorTrayectoria *l, const char *ruta);
+const uint8_t *fotogramaTrayectoria(const LectorTrayectoria *l, uint64_t f);
+void leerFotograma(const LectorTrayectoria *l, uint64_t f, int *red);
+void cerrarTrayectoriaLectura(LectorTrayectoria *l);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif